@@ -0,0 +1,90 @@
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include "core/scheduler.h"
+
+// checks that scheduling events doesn't allocate once the scheduler has warmed up.
+// every operator new is counted, and the count is taken around steady state Add/RunEvents.
+// the timers carry a few extra fields, like a real component would have
+
+using Clock = std::chrono::steady_clock;
+
+static u64 allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* pointer = malloc(size);
+
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+static u32 rng = 12345;
+
+static u32 Random() {
+    rng = rng * 1664525 + 1013904223;
+    return rng >> 8;
+}
+
+struct Timer {
+    void Fire(u64 payload) {
+        fired++;
+        scheduler->Add(1 + Random() % (n * 64), kind, payload);
+    }
+
+    Scheduler* scheduler;
+    EventKind kind;
+    int n;
+    u64 fired = 0;
+    u64 counter[3] = {};
+};
+
+int main() {
+    bool failed = false;
+
+    for (int n : {8, 64, 512}) {
+        Scheduler scheduler;
+        Timer timer{&scheduler, 0, n};
+        timer.kind = scheduler.RegisterEvent<&Timer::Fire>(&timer, "Timer");
+        scheduler.Reset();
+
+        for (int i = 0; i < n; i++) {
+            scheduler.Add(1 + Random() % (n * 64), timer.kind, i);
+        }
+
+        for (int i = 0; i < 10000; i++) {
+            scheduler.Tick(32);
+            scheduler.RunEvents();
+        }
+
+        u64 allocations_before = allocations;
+        u64 fired_before = timer.fired;
+        auto start = Clock::now();
+
+        for (int i = 0; i < 2000000; i++) {
+            scheduler.Tick(32);
+            scheduler.RunEvents();
+        }
+
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        u64 fired = timer.fired - fired_before;
+        u64 allocated = allocations - allocations_before;
+
+        printf("n=%-4d %.1fns/event, %llu allocations over %llu events\n", n, elapsed / fired, (unsigned long long)allocated, (unsigned long long)fired);
+        failed |= allocated != 0;
+    }
+
+    return failed ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <stdio.h>
+#include "core/scheduler.h"
+
+// n timers which reschedule themselves with a random delay each time they fire,
+// ticked 32 cycles at a time. cancel+add moves one event around while n others are
+// pending, like the cop0 compare event does
+
+using Clock = std::chrono::steady_clock;
+
+static u32 rng = 12345;
+
+static u32 Random() {
+    rng = rng * 1664525 + 1013904223;
+    return rng >> 8;
+}
+
+static double NanosecondsSince(Clock::time_point start, u64 count) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+}
+
+struct Timer {
+    void Fire(u64 payload) {
+        fired++;
+        scheduler->Add(1 + Random() % (n * 64), kind, payload);
+    }
+
+    void Moved() {}
+
+    Scheduler* scheduler;
+    EventKind kind;
+    int n;
+    u64 fired = 0;
+};
+
+int main() {
+    printf("events   fire+reschedule   cancel+add   (ns per event)\n");
+
+    for (int n : {8, 64, 512, 4096}) {
+        Scheduler scheduler;
+        Timer timer{&scheduler, 0, n};
+        timer.kind = scheduler.RegisterEvent<&Timer::Fire>(&timer, "Timer");
+        EventKind moved_kind = scheduler.RegisterEvent<&Timer::Moved>(&timer, "Moved");
+        scheduler.Reset();
+
+        for (int i = 0; i < n; i++) {
+            scheduler.Add(1 + Random() % (n * 64), timer.kind, i);
+        }
+
+        // warm up so that the scheduler has already grown to its steady state size
+        for (int i = 0; i < 10000; i++) {
+            scheduler.Tick(32);
+            scheduler.RunEvents();
+        }
+
+        u64 fired_before = timer.fired;
+        auto start = Clock::now();
+
+        for (int i = 0; i < 2000000; i++) {
+            scheduler.Tick(32);
+            scheduler.RunEvents();
+        }
+
+        double fire_time = NanosecondsSince(start, timer.fired - fired_before);
+
+        const int moves = 200000;
+        EventHandle handle = Scheduler::INVALID_EVENT;
+        start = Clock::now();
+
+        for (int i = 0; i < moves; i++) {
+            scheduler.Cancel(handle);
+            handle = scheduler.Add(1000 + Random() % (n * 64), moved_kind);
+        }
+
+        double move_time = NanosecondsSince(start, moves);
+        printf("%-8d %-17.1f %.1f\n", n, fire_time, move_time);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -34,7 +34,18 @@ enum class InstructionTable {
     COP2,
     TLB,
     MMI,
+    MMI0,
     MMI1,
     MMI2,
     MMI3,
+    FPUW,
+};
+
+// the execution backends that can be selected for a cpu core.
+// not every core supports every backend
+enum class CoreType {
+    Interpreter,
+    CachedInterpreter,
+    JIT,
+    ThreadedInterpreter,
 };
\ No newline at end of file
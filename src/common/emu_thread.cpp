@@ -1,4 +1,51 @@
+#include <algorithm>
 #include <common/emu_thread.h>
+#include <common/tracer.h>
+
+void FrameTimeHistogram::Add(std::chrono::steady_clock::duration time) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    int bucket = std::min<int>(us / bucket_us, num_buckets);
+
+    buckets[bucket]++;
+    count++;
+    max = std::max(max, time);
+}
+
+void FrameTimeHistogram::Clear() {
+    buckets.fill(0);
+    count = 0;
+    max = std::chrono::steady_clock::duration{0};
+}
+
+FrameTimes FrameTimeHistogram::GetTimes() {
+    FrameTimes times;
+    times.p50 = Percentile(0.5f);
+    times.p99 = Percentile(0.99f);
+    times.max = std::chrono::duration<float, std::milli>(max).count();
+    return times;
+}
+
+float FrameTimeHistogram::Percentile(float percent) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    // the smallest bucket which has at least percent of the frames at or below it
+    u32 target = std::max<u32>(1, percent * count);
+    u32 total = 0;
+
+    for (int i = 0; i <= num_buckets; i++) {
+        total += buckets[i];
+
+        if (total >= target) {
+            // report the top of the bucket, but don't go past the slowest frame we've seen
+            float upper = ((i + 1) * bucket_us) / 1000.0f;
+            return std::min(upper, std::chrono::duration<float, std::milli>(max).count());
+        }
+    }
+
+    return std::chrono::duration<float, std::milli>(max).count();
+}
 
 EmuThread::EmuThread(RunFunction run_frame, UpdateFunction update_fps) : run_frame(run_frame), update_fps(update_fps) {
 
@@ -9,6 +56,10 @@ EmuThread::~EmuThread() {
 }
 
 void EmuThread::Start() {
+    if (running) {
+        return;
+    }
+
     running = true;
 
     thread = std::thread{[this]() {
@@ -18,30 +69,56 @@ void EmuThread::Start() {
 
 void EmuThread::Reset() {
     frames = 0;
+    frame_times.Clear();
+    emulation_times.Clear();
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats = FrameStats{};
 }
 
 void EmuThread::Run() {
-    auto frame_end = std::chrono::system_clock::now() + frame{1};
-    auto fps_update = std::chrono::system_clock::now();
+    Tracer::SetThreadName("Emulator");
+
+    auto now = std::chrono::steady_clock::now();
+    auto frame_start = now;
+    auto frame_end = now;
+    auto fps_update = now;
+
     while (running) {
+        auto emulation_start = std::chrono::steady_clock::now();
         run_frame();
+        now = std::chrono::steady_clock::now();
+
+        emulation_times.Add(now - emulation_start);
         frames++;
 
-        if (std::chrono::system_clock::now() - fps_update >= std::chrono::milliseconds(update_interval)) {
-            update_fps(frames * (1000.0f / update_interval));
-            frames = 0;
-            fps_update = std::chrono::system_clock::now();
-        }
+        if (framelimiter && !fast_forward) {
+            auto duration = GetFrameDuration();
+            frame_end += duration;
 
-        if (framelimiter) {
-            // block the execution of the emulator thread until 1 / 60 of a second has passed
-            std::this_thread::sleep_until(frame_end);
+            if (now - frame_end > duration) {
+                // we've fallen more than a frame behind, so rather than running
+                // flat out to catch up, start pacing again from here
+                frame_end = now;
+            } else {
+                WaitUntil(frame_end);
+                now = std::chrono::steady_clock::now();
+            }
+        } else {
+            // keep the deadline current so turning the limiter back on doesn't cause a burst
+            frame_end = now;
         }
 
-        frame_end += frame{1};
+        frame_times.Add(now - frame_start);
+        frame_start = now;
+
+        if (now - fps_update >= std::chrono::milliseconds(update_interval)) {
+            UpdateStats(now - fps_update);
+            fps_update = now;
+        }
     }
 }
- 
+
 void EmuThread::Stop() {
     if (!running) {
         return;
@@ -58,9 +135,86 @@ auto EmuThread::IsActive() -> bool {
 }
 
 auto EmuThread::GetFPS() -> int {
-    return frames;
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats.fps;
 }
 
 void EmuThread::ToggleFramelimiter() {
     framelimiter = !framelimiter;
+}
+
+void EmuThread::SetFramelimiter(bool enabled) {
+    framelimiter = enabled;
+}
+
+bool EmuThread::GetFramelimiter() {
+    return framelimiter;
+}
+
+void EmuThread::SetTargetRate(float rate) {
+    if (rate > 0.0f) {
+        target_rate = rate;
+    }
+}
+
+float EmuThread::GetTargetRate() {
+    return target_rate;
+}
+
+void EmuThread::SetFastForward(bool enabled) {
+    fast_forward = enabled;
+}
+
+bool EmuThread::GetFastForward() {
+    return fast_forward;
+}
+
+void EmuThread::SetTurbo(float multiplier) {
+    if (multiplier > 0.0f) {
+        turbo = multiplier;
+    }
+}
+
+float EmuThread::GetTurbo() {
+    return turbo;
+}
+
+FrameStats EmuThread::GetFrameStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+
+std::chrono::steady_clock::duration EmuThread::GetFrameDuration() {
+    std::chrono::duration<double> seconds{1.0 / (target_rate * turbo)};
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(seconds);
+}
+
+void EmuThread::WaitUntil(std::chrono::steady_clock::time_point deadline) {
+    if (deadline - std::chrono::steady_clock::now() > spin_threshold) {
+        std::this_thread::sleep_until(deadline - spin_threshold);
+    }
+
+    // yield rather than busy wait so the iop and gs threads still get
+    // a look in on machines with few cores
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void EmuThread::UpdateStats(std::chrono::steady_clock::duration elapsed) {
+    FrameStats new_stats;
+    new_stats.fps = frames / std::chrono::duration<float>(elapsed).count();
+    new_stats.frames = frames;
+    new_stats.frame = frame_times.GetTimes();
+    new_stats.emulation = emulation_times.GetTimes();
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats = new_stats;
+    }
+
+    frames = 0;
+    frame_times.Clear();
+    emulation_times.Clear();
+    update_fps(new_stats.fps);
 }
\ No newline at end of file
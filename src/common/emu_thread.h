@@ -2,13 +2,52 @@
 
 #include <thread>
 #include <chrono>
-#include <ratio>
+#include <atomic>
+#include <mutex>
+#include <array>
 #include <stdio.h>
 #include <functional>
+#include "common/types.h"
 
 using RunFunction = std::function<void()>;
 using UpdateFunction = std::function<void(float fps)>;
 
+// times are in milliseconds
+struct FrameTimes {
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+struct FrameStats {
+    float fps = 0.0f;
+    int frames = 0;
+
+    // time between the start of consecutive frames, including any pacing
+    FrameTimes frame;
+
+    // time spent running the frame itself
+    FrameTimes emulation;
+};
+
+class FrameTimeHistogram {
+public:
+    void Add(std::chrono::steady_clock::duration time);
+    void Clear();
+    FrameTimes GetTimes();
+
+private:
+    float Percentile(float percent);
+
+    // 50us buckets up to 100ms, with anything slower going in the last bucket
+    static constexpr int bucket_us = 50;
+    static constexpr int num_buckets = 2000;
+
+    std::array<u32, num_buckets + 1> buckets = {};
+    u32 count = 0;
+    std::chrono::steady_clock::duration max{0};
+};
+
 class EmuThread {
 public:
     EmuThread(RunFunction run_frame, UpdateFunction update_fps);
@@ -21,17 +60,51 @@ public:
     auto GetFPS() -> int;
     void ToggleFramelimiter();
 
-    std::thread thread;
+    void SetFramelimiter(bool enabled);
+    bool GetFramelimiter();
+
+    // frames per second the limiter paces to
+    void SetTargetRate(float rate);
+    float GetTargetRate();
+
+    // runs as fast as possible regardless of the limiter while enabled
+    void SetFastForward(bool enabled);
+    bool GetFastForward();
+
+    // multiplies the target rate while the limiter is on
+    void SetTurbo(float multiplier);
+    float GetTurbo();
+
+    // stats from the last completed update interval
+    FrameStats GetFrameStats();
 
-    using frame = std::chrono::duration<int, std::ratio<1, 60>>;
+    std::thread thread;
 
     RunFunction run_frame;
     UpdateFunction update_fps;
 
 private:
+    std::chrono::steady_clock::duration GetFrameDuration();
+    void WaitUntil(std::chrono::steady_clock::time_point deadline);
+    void UpdateStats(std::chrono::steady_clock::duration elapsed);
+
     int frames = 0;
-    bool running = false;
-    bool framelimiter = false;
+    std::atomic<bool> running = false;
+    std::atomic<bool> framelimiter = false;
+    std::atomic<bool> fast_forward = false;
+    std::atomic<float> target_rate = 59.94f;
+    std::atomic<float> turbo = 1.0f;
+
+    // only touched by the emulator thread
+    FrameTimeHistogram frame_times;
+    FrameTimeHistogram emulation_times;
+
+    std::mutex stats_mutex;
+    FrameStats stats;
 
     static constexpr int update_interval = 1000;
+
+    // sleeping is only accurate to around a millisecond, so the
+    // last part of each frame is spent yielding until the deadline
+    static constexpr std::chrono::microseconds spin_threshold{1500};
 };
\ No newline at end of file
@@ -1,3 +1,223 @@
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
 #include "common/log_file.h"
+#include "common/ring_buffer.h"
 
-LogFile LogFile::instance;
\ No newline at end of file
+// records go into a ring belonging to the thread that logged them, so
+// logging never has to wait on another thread unless its ring is full
+struct LogQueue {
+    RingBuffer<LogRecord, 4096> ring;
+
+    // lets a flush know when everything logged before it has been written.
+    // pushed is only changed by the logging thread, and written only by the writer
+    std::atomic<u64> pushed = 0;
+    std::atomic<u64> written = 0;
+
+    // tells apart a queue from an older one that happened to be at the same address
+    u64 id = 0;
+};
+
+// formats every thread's records on a thread of its own, which
+// only gets started the first time something is actually logged
+class LogWriter {
+public:
+    ~LogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+
+        condition.notify_one();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void Register(LogQueue* queue) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue->id = next_id++;
+        queues.push_back(queue);
+
+        if (!thread.joinable()) {
+            thread = std::thread{[this]() {
+                ThreadLoop();
+            }};
+        }
+    }
+
+    // the queue's thread has stopped logging, so once it's drained it can go
+    void Unregister(LogQueue* queue) {
+        std::unique_lock<std::mutex> lock(mutex);
+        u64 pushed = queue->pushed;
+
+        WaitUntil(lock, [&]() {
+            return queue->written >= pushed;
+        });
+
+        queues.erase(std::find(queues.begin(), queues.end(), queue));
+    }
+
+    void Flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<std::tuple<LogQueue*, u64, u64>> targets;
+
+        for (LogQueue* queue : queues) {
+            targets.emplace_back(queue, queue->id, queue->pushed.load());
+        }
+
+        // a queue that's gone away was drained before it went
+        WaitUntil(lock, [&]() {
+            for (auto& [queue, id, pushed] : targets) {
+                bool registered = std::find(queues.begin(), queues.end(), queue) != queues.end();
+
+                if (registered && queue->id == id && queue->written < pushed) {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    void Wake() {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake_requested = true;
+        condition.notify_one();
+    }
+
+private:
+    template <typename Predicate>
+    void WaitUntil(std::unique_lock<std::mutex>& lock, Predicate predicate) {
+        wake_requested = true;
+        condition.notify_one();
+
+        written_condition.wait(lock, [&]() {
+            return predicate() || !thread.joinable();
+        });
+    }
+
+    void ThreadLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            bool drained = false;
+
+            for (LogQueue* queue : queues) {
+                drained |= Drain(queue);
+            }
+
+            written_condition.notify_all();
+
+            if (quit) {
+                break;
+            }
+
+            // nothing wakes us for new records, so we check for them every so often
+            if (!drained) {
+                condition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+                    return quit || wake_requested;
+                });
+
+                wake_requested = false;
+            }
+        }
+
+        for (LogQueue* queue : queues) {
+            Drain(queue);
+        }
+
+        written_condition.notify_all();
+    }
+
+    // records are only consumed once they've been written, so an empty ring means we're up to date
+    bool Drain(LogQueue* queue) {
+        const LogRecord* records;
+        int count;
+        bool drained = false;
+
+        while ((count = queue->ring.Peek(records)) != 0) {
+            for (int i = 0; i < count; i++) {
+                const LogRecord& record = records[i];
+
+                if (record.log_file->fp) {
+                    record.write(record.log_file->fp, record.format, record.payload);
+                }
+            }
+
+            queue->ring.Consume(count);
+            queue->written.fetch_add(count);
+            drained = true;
+        }
+
+        return drained;
+    }
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::condition_variable written_condition;
+    std::vector<LogQueue*> queues;
+    u64 next_id = 0;
+    bool quit = false;
+    bool wake_requested = false;
+};
+
+// the writer has to be constructed before the shared log, so it's still there when the log flushes on exit
+static LogWriter writer;
+
+LogFile LogFile::instance;
+thread_local LogFile* LogFile::current = &LogFile::instance;
+
+// each thread's queue is made the first time it logs, and handed back when the thread exits
+struct LogQueueOwner {
+    ~LogQueueOwner() {
+        if (queue) {
+            writer.Unregister(queue.get());
+        }
+    }
+
+    LogQueue& Get() {
+        if (!queue) {
+            queue = std::make_unique<LogQueue>();
+            writer.Register(queue.get());
+        }
+
+        return *queue;
+    }
+
+    std::unique_ptr<LogQueue> queue;
+};
+
+static thread_local LogQueueOwner queue_owner;
+
+LogFile::~LogFile() {
+    if (fp) {
+        Flush();
+        fclose(fp);
+    }
+}
+
+void LogFile::Flush() {
+    writer.Flush();
+}
+
+void LogFile::Push(const LogRecord& record) {
+    LogQueue& queue = queue_owner.Get();
+
+    // the writer is behind, so wait for it rather than losing the record
+    if (!queue.ring.Push(record)) {
+        writer.Wake();
+
+        while (!queue.ring.Push(record)) {
+            std::this_thread::yield();
+        }
+    }
+
+    queue.pushed.store(queue.pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -1,37 +1,236 @@
 #pragma once
 
-#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include "common/types.h"
 
 #define USE_LOGGING
 
+// every log site belongs to a channel, which can be turned on and off at runtime
+enum class LogChannel : u8 {
+    EE,
+    IOP,
+    DMAC,
+    IOPDMAC,
+    INTC,
+    GIF,
+    VIF,
+    IPU,
+    Timers,
+    IOPTimers,
+    Memory,
+    Console,
+    Count,
+};
+
+enum class LogLevel : u8 {
+    // something that happens for every word, instruction or poll
+    Trace,
+
+    // register accesses, exceptions, interrupts and transfers
+    Debug,
+
+    // output from the guest
+    Info,
+};
+
+// log sites below this level are compiled out
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL Trace
+#endif
+
+// a channel can have a higher minimum than the rest by changing its entry here
+constexpr LogLevel log_min_levels[static_cast<int>(LogChannel::Count)] = {
+    LogLevel::LOG_MIN_LEVEL, // EE
+    LogLevel::LOG_MIN_LEVEL, // IOP
+    LogLevel::LOG_MIN_LEVEL, // DMAC
+    LogLevel::LOG_MIN_LEVEL, // IOPDMAC
+    LogLevel::LOG_MIN_LEVEL, // INTC
+    LogLevel::LOG_MIN_LEVEL, // GIF
+    LogLevel::LOG_MIN_LEVEL, // VIF
+    LogLevel::LOG_MIN_LEVEL, // IPU
+    LogLevel::LOG_MIN_LEVEL, // Timers
+    LogLevel::LOG_MIN_LEVEL, // IOPTimers
+    LogLevel::LOG_MIN_LEVEL, // Memory
+    LogLevel::LOG_MIN_LEVEL, // Console
+};
+
+class LogFile;
+
+// logging only copies the format string and arguments into a record, which a background
+// thread formats later. strings are copied into the record, since they're often temporaries
+struct LogRecord {
+    static constexpr int PAYLOAD_SIZE = 104;
+
+    void (*write)(FILE* fp, const char* format, const char* payload);
+    const char* format;
+    LogFile* log_file;
+    char payload[PAYLOAD_SIZE];
+};
+
+// checks the format string against its arguments at compile time, without ever being called
+#if defined(__GNUC__)
+__attribute__((format(printf, 1, 2)))
+#endif
+inline void log_check_format(const char* format, ...) {}
+
+// a disabled channel costs a single branch, and a level below the channel's minimum costs nothing
+#ifdef USE_LOGGING
+#define log_channel(channel, level, message, ...) \
+    do { \
+        if constexpr (LogFile::IsCompiledIn(channel, level)) { \
+            LogFile& log_file_ = LogFile::Get(); \
+            if (log_file_.IsEnabled(channel)) { \
+                log_file_.Log(message, ##__VA_ARGS__); \
+            } \
+        } \
+        if (false) { \
+            log_check_format(message, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define log_channel(channel, level, message, ...) \
+    do { \
+        if (false) { \
+            log_check_format(message, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#endif
+
 class LogFile {
 public:
+    static constexpr u32 ALL_CHANNELS = (1u << static_cast<int>(LogChannel::Count)) - 1;
+
+    LogFile(const char* path) : fp(fopen(path, "w")) {}
+
     LogFile(const LogFile& log_file) = delete;
 
-    ~LogFile() {
-        fclose(fp);
-    }
+    ~LogFile();
 
+    // gives the log for the current thread, which is the shared log unless another has been bound
     static LogFile& Get() {
-        return instance;
+        return *current;
+    }
+
+    // makes every log on this thread go to log_file, or back to the shared log when nullptr.
+    // this is how several systems running on different threads get their own logs
+    static void Bind(LogFile* log_file) {
+        current = log_file ? log_file : &instance;
+    }
+
+    static constexpr bool IsCompiledIn(LogChannel channel, LogLevel level) {
+        return level >= log_min_levels[static_cast<int>(channel)];
+    }
+
+    bool IsEnabled(LogChannel channel) {
+        return channel_mask.load(std::memory_order_relaxed) & (1u << static_cast<int>(channel));
+    }
+
+    // channels can only be enabled when the file could be opened
+    void SetChannelMask(u32 mask) {
+        channel_mask = fp ? (mask & ALL_CHANNELS) : 0;
+    }
+
+    void SetChannelEnabled(LogChannel channel, bool enabled) {
+        u32 bit = 1u << static_cast<int>(channel);
+        SetChannelMask(enabled ? (channel_mask | bit) : (channel_mask & ~bit));
     }
 
-    void Log(const char *format, ...) {
-        #ifdef USE_LOGGING
+    u32 GetChannelMask() {
+        return channel_mask;
+    }
+
+    template <typename... Args>
+    void Log(const char* format, Args... args) {
+        static_assert(((std::is_arithmetic_v<Args> || IsString<Args>()) && ...), "log arguments must be numbers or strings");
+        static_assert((FixedSize<Args>() + ... + 0) <= LogRecord::PAYLOAD_SIZE, "too many log arguments");
 
-        va_list args;
+        LogRecord record;
+        record.write = &WriteRecord<Stored<Args>...>;
+        record.format = format;
+        record.log_file = this;
 
-        va_start(args, format);
-        vfprintf(fp, format, args);
-        va_end(args);
+        // whatever's left after the fixed size arguments is shared between any strings
+        [[maybe_unused]] char* out = record.payload;
+        [[maybe_unused]] int spare = LogRecord::PAYLOAD_SIZE - (FixedSize<Args>() + ... + 0);
+        (Encode(out, spare, args), ...);
 
-        #endif
+        Push(record);
     }
 
+    // blocks until everything that's been logged so far, by any thread, has been written
+    static void Flush();
+
 private:
     LogFile() {};
 
+    template <typename T>
+    static constexpr bool IsString() {
+        return std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+    }
+
+    template <typename T>
+    using Stored = std::conditional_t<IsString<T>(), const char*, T>;
+
+    // strings take at least their terminator
+    template <typename T>
+    static constexpr int FixedSize() {
+        return IsString<T>() ? 1 : sizeof(T);
+    }
+
+    template <typename T>
+    static void Encode(char*& out, int& spare, T value) {
+        if constexpr (IsString<T>()) {
+            int length = std::min<int>(strlen(value), spare);
+            memcpy(out, value, length);
+            out[length] = '\0';
+            out += length + 1;
+            spare -= length;
+        } else {
+            memcpy(out, &value, sizeof(T));
+            out += sizeof(T);
+        }
+    }
+
+    template <typename T>
+    static T Decode(const char*& in) {
+        if constexpr (IsString<T>()) {
+            const char* value = in;
+            in += strlen(value) + 1;
+            return value;
+        } else {
+            T value;
+            memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+    }
+
+    template <typename... Args>
+    static void WriteRecord(FILE* fp, const char* format, const char* payload) {
+        if constexpr (sizeof...(Args) == 0) {
+            fputs(format, fp);
+        } else {
+            // a braced list is evaluated in order, so the arguments come out in the order they went in
+            std::tuple<Args...> args{Decode<Args>(payload)...};
+
+            std::apply([fp, format](Args... values) {
+                fprintf(fp, format, values...);
+            }, args);
+        }
+    }
+
+    void Push(const LogRecord& record);
+
     FILE* fp = fopen("../../log-stuff/otterstation.log", "w");
+    std::atomic<u32> channel_mask = fp ? ALL_CHANNELS : 0;
+
     static LogFile instance;
+    static thread_local LogFile* current;
+
+    friend class LogWriter;
 };
\ No newline at end of file
@@ -2,170 +2,150 @@
 #include "common/memory_map.h"
 #include "common/log_file.h"
 
+void MemoryMap::Reset() {
+    read_pages.fill(nullptr);
+    write_pages.fill(nullptr);
+    read_handler_pages.fill(0);
+    write_handler_pages.fill(0);
+    read_handlers.clear();
+    write_handlers.clear();
+    io_page_indices.fill(0);
+    io_pages.clear();
+    io_read_handlers.clear();
+    io_write_handlers.clear();
+}
+
 void MemoryMap::RegisterReadMemory(u32 start, u32 end, u8* pointer) {
-    MemoryReadElement read_element;
-    read_element.start = start;
-    read_element.end = end;
-    read_element.pointer = pointer;
-    read_element.type = MemoryType::Fast;
+    assert(((start | end) & 0xFFF) == 0);
 
-    read_map.push_back(read_element);
+    for (u32 addr = start; addr < end; addr += 0x1000) {
+        read_pages[addr >> 12] = pointer + (addr - start);
+    }
 }
 
 void MemoryMap::RegisterWriteMemory(u32 start, u32 end, u8* pointer) {
-    MemoryWriteElement write_element;
-    write_element.start = start;
-    write_element.end = end;
-    write_element.pointer = pointer;
-    write_element.type = MemoryType::Fast;
+    assert(((start | end) & 0xFFF) == 0);
 
-    write_map.push_back(write_element);
+    for (u32 addr = start; addr < end; addr += 0x1000) {
+        write_pages[addr >> 12] = pointer + (addr - start);
+    }
 }
 
 void MemoryMap::RegisterReadHandler(u32 start, u32 end, MemoryReadHandler handler) {
-    MemoryReadElement read_element;
-    read_element.start = start;
-    read_element.end = end;
-    read_element.handler = handler;
-    read_element.type = MemoryType::Slow;
+    assert(((start | end) & 0xFFF) == 0);
+    assert(read_handlers.size() < 255);
+
+    read_handlers.push_back(handler);
 
-    read_map.push_back(read_element);
+    for (u32 addr = start; addr < end; addr += 0x1000) {
+        read_handler_pages[addr >> 12] = read_handlers.size();
+    }
 }
 
 void MemoryMap::RegisterWriteHandler(u32 start, u32 end, MemoryWriteHandler handler) {
-    MemoryWriteElement write_element;
-    write_element.start = start;
-    write_element.end = end;
-    write_element.handler = handler;
-    write_element.type = MemoryType::Slow;
+    assert(((start | end) & 0xFFF) == 0);
+    assert(write_handlers.size() < 255);
 
-    write_map.push_back(write_element);
-}
+    write_handlers.push_back(handler);
 
-MemoryMap::MemoryReadElement* MemoryMap::GetReadMap(u32 addr) {
-    for (int i = 0; i < read_map.size(); i++) {
-        if (addr >= read_map[i].start && addr < read_map[i].end) {
-            return &read_map[i];
-        }
+    for (u32 addr = start; addr < end; addr += 0x1000) {
+        write_handler_pages[addr >> 12] = write_handlers.size();
     }
-
-    return nullptr;
 }
 
-MemoryMap::MemoryWriteElement* MemoryMap::GetWriteMap(u32 addr) {
-    for (int i = 0; i < write_map.size(); i++) {
-        if (addr >= write_map[i].start && addr < write_map[i].end) {
-            return &write_map[i];
-        }
-    }
+void MemoryMap::RegisterIORead(u32 start, u32 end, int widths, IOReadHandler handler) {
+    assert(io_read_handlers.size() < 0xFFFF);
 
-    return nullptr;
-}
+    io_read_handlers.push_back(handler);
 
-u8 MemoryMap::ReadByte(u32 addr) {
-    MemoryReadElement* read_element = GetReadMap(addr);
+    for (u32 addr = start & ~0x3; addr < end; addr += 4) {
+        IOPage& page = GetIOPage(addr);
 
-    if (!read_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
-        return 0;
+        for (int i = 0; i < 3; i++) {
+            if (widths & (1 << i)) {
+                page.read[i][(addr & 0xFFF) >> 2] = io_read_handlers.size();
+            }
+        }
     }
+}
 
-    switch (read_element->type) {
-    case MemoryType::Fast:
-        return read_element->pointer[addr - read_element->start];
-    case MemoryType::Slow:
-        return read_element->handler(addr);
-    }
+void MemoryMap::RegisterIOWrite(u32 start, u32 end, int widths, IOWriteHandler handler) {
+    assert(io_write_handlers.size() < 0xFFFF);
 
-    return 0;
-}
+    io_write_handlers.push_back(handler);
 
-u16 MemoryMap::ReadHalf(u32 addr) {
-    MemoryReadElement* read_element = GetReadMap(addr);
+    for (u32 addr = start & ~0x3; addr < end; addr += 4) {
+        IOPage& page = GetIOPage(addr);
 
-    if (!read_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
-        return 0;
+        for (int i = 0; i < 3; i++) {
+            if (widths & (1 << i)) {
+                page.write[i][(addr & 0xFFF) >> 2] = io_write_handlers.size();
+            }
+        }
     }
+}
 
-    switch (read_element->type) {
-    case MemoryType::Fast:
-        return *reinterpret_cast<u16*>(&read_element->pointer[addr - read_element->start]);
-    case MemoryType::Slow:
-        return read_element->handler(addr);
-    }
+void MemoryMap::RegisterIORead(u32 addr, int widths, IOReadHandler handler) {
+    RegisterIORead(addr, addr + 4, widths, handler);
+}
 
-    return 0;
+void MemoryMap::RegisterIOWrite(u32 addr, int widths, IOWriteHandler handler) {
+    RegisterIOWrite(addr, addr + 4, widths, handler);
 }
 
-u32 MemoryMap::ReadWord(u32 addr) {
-    MemoryReadElement* read_element = GetReadMap(addr);
+MemoryMap::IOPage& MemoryMap::GetIOPage(u32 addr) {
+    u8& index = io_page_indices[addr >> 12];
 
-    if (!read_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
-        return 0;
-    }
+    if (!index) {
+        assert(io_pages.size() < 255);
 
-    switch (read_element->type) {
-    case MemoryType::Fast:
-        return *reinterpret_cast<u32*>(&read_element->pointer[addr - read_element->start]);
-    case MemoryType::Slow:
-        return read_element->handler(addr);
+        io_pages.push_back(std::make_unique<IOPage>());
+        index = io_pages.size();
     }
 
-    return 0;
+    return *io_pages[index - 1];
 }
 
-void MemoryMap::WriteByte(u32 addr, u8 data) {
-    MemoryWriteElement* write_element = GetWriteMap(addr);
+// io accesses are either 1, 2 or 4 bytes, so the width index is just size >> 1
+u32 MemoryMap::SlowRead(u32 addr, int size) {
+    int io_index = io_page_indices[addr >> 12];
 
-    if (!write_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
-        return;
+    if (io_index) {
+        int handler = io_pages[io_index - 1]->read[size >> 1][(addr & 0xFFF) >> 2];
+
+        if (handler) {
+            return io_read_handlers[handler - 1](addr);
+        }
     }
 
-    switch (write_element->type) {
-    case MemoryType::Fast:
-        write_element->pointer[addr - write_element->start] = data;
-        break;
-    case MemoryType::Slow:
-        write_element->handler(addr, data);
-        break;
+    int index = read_handler_pages[addr >> 12];
+
+    if (!index) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[MemoryMap] %08x is not mapped\n", addr);
+        return 0;
     }
+
+    return read_handlers[index - 1](addr, size);
 }
 
-void MemoryMap::WriteHalf(u32 addr, u16 data) {
-    MemoryWriteElement* write_element = GetWriteMap(addr);
+void MemoryMap::SlowWrite(u32 addr, u32 data, int size) {
+    int io_index = io_page_indices[addr >> 12];
 
-    if (!write_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
-        return;
-    }
+    if (io_index) {
+        int handler = io_pages[io_index - 1]->write[size >> 1][(addr & 0xFFF) >> 2];
 
-    switch (write_element->type) {
-    case MemoryType::Fast:
-        *reinterpret_cast<u16*>(&write_element->pointer[addr - write_element->start]) = data;
-        break;
-    case MemoryType::Slow:
-        write_element->handler(addr, data);
-        break;
+        if (handler) {
+            io_write_handlers[handler - 1](addr, data);
+            return;
+        }
     }
-}
 
-void MemoryMap::WriteWord(u32 addr, u32 data) {
-    MemoryWriteElement* write_element = GetWriteMap(addr);
+    int index = write_handler_pages[addr >> 12];
 
-    if (!write_element) {
-        LogFile::Get().Log("[MemoryMap] %08x is not mapped\n", addr);
+    if (!index) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[MemoryMap] %08x is not mapped\n", addr);
         return;
     }
 
-    switch (write_element->type) {
-    case MemoryType::Fast:
-        *reinterpret_cast<u32*>(&write_element->pointer[addr - write_element->start]) = data;
-        break;
-    case MemoryType::Slow:
-        write_element->handler(addr, data);
-        break;
-    }
+    write_handlers[index - 1](addr, data, size);
 }
\ No newline at end of file
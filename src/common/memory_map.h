@@ -1,57 +1,151 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <memory>
 #include <vector>
+#include <string.h>
 #include "common/types.h"
 
-// this gets used by the ee and iop for their memory maps
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// this gets used by the ee and iop for their memory maps.
+// the address space is split into 4KB pages, where each page either points
+// straight at host memory or has the index of a handler for io. this means
+// ram accesses only need a single table lookup.
+// io registers are registered individually with a handler for each width,
+// and are looked up per word, so an access to a register is a single indexed call.
+// anything else on an io page goes to the handler for the whole page
 class MemoryMap {
 public:
-    using MemoryReadHandler = std::function<u32(u32)>;
-    using MemoryWriteHandler = std::function<void(u32, u32)>;
+    // handlers are given the size of the access in bytes
+    using MemoryReadHandler = std::function<u32(u32, int)>;
+    using MemoryWriteHandler = std::function<void(u32, u32, int)>;
 
-    enum class MemoryType {
-        Fast,
-        Slow,
-    };
+    using IOReadHandler = std::function<u32(u32)>;
+    using IOWriteHandler = std::function<void(u32, u32)>;
 
-    struct MemoryReadElement {
-        u32 start;
-        u32 end;
-        u8* pointer;
-        MemoryReadHandler handler;
-        MemoryType type;
+    enum IOWidth {
+        IO_BYTE = 1 << 0,
+        IO_HALF = 1 << 1,
+        IO_WORD = 1 << 2,
+        IO_ALL = IO_BYTE | IO_HALF | IO_WORD,
     };
 
-    struct MemoryWriteElement {
-        u32 start;
-        u32 end;
-        u8* pointer;
-        MemoryWriteHandler handler;
-        MemoryType type;
-    };
+    void Reset();
+
+    template <typename T>
+    T Read(u32 addr) {
+        u8* page = read_pages[addr >> 12];
+
+        if (page) {
+            T data;
+            memcpy(&data, page + (addr & 0xFFF), sizeof(T));
+            return data;
+        }
+
+        // io is at most 32 bits wide, so anything bigger gets split into words
+        if constexpr (sizeof(T) <= 4) {
+            return SlowRead(addr, sizeof(T));
+        } else {
+            T data;
+
+            for (u32 i = 0; i < sizeof(T); i += 4) {
+                u32 word = SlowRead(addr + i, 4);
+                memcpy(reinterpret_cast<u8*>(&data) + i, &word, 4);
+            }
+
+            return data;
+        }
+    }
+
+    template <typename T>
+    void Write(u32 addr, T data) {
+        u8* page = write_pages[addr >> 12];
+
+        if (page) {
+#if defined(__SSE2__)
+            if constexpr (sizeof(T) == 16) {
+                // u128 gets passed in two registers, and copying it with memcpy
+                // spills them to the stack and stalls on loading them back as one
+                __m128i value = _mm_unpacklo_epi64(_mm_cvtsi64_si128(data.ud[0]), _mm_cvtsi64_si128(data.ud[1]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(page + (addr & 0xFFF)), value);
+                return;
+            }
+#endif
+
+            memcpy(page + (addr & 0xFFF), &data, sizeof(T));
+
+            return;
+        }
 
-    using MemoryReadMap = std::vector<MemoryReadElement>;
-    using MemoryWriteMap = std::vector<MemoryWriteElement>;
+        if constexpr (sizeof(T) <= 4) {
+            SlowWrite(addr, data, sizeof(T));
+        } else {
+            for (u32 i = 0; i < sizeof(T); i += 4) {
+                u32 word;
+                memcpy(&word, reinterpret_cast<u8*>(&data) + i, 4);
+                SlowWrite(addr + i, word, 4);
+            }
+        }
+    }
 
-    u8 ReadByte(u32 addr);
-    u16 ReadHalf(u32 addr);
-    u32 ReadWord(u32 addr);
+    // returns the host pointer for the page that addr is in, or nullptr if it isn't backed by memory
+    u8* GetReadPage(u32 addr) {
+        return read_pages[addr >> 12];
+    }
 
-    void WriteByte(u32 addr, u8 data);
-    void WriteHalf(u32 addr, u16 data);
-    void WriteWord(u32 addr, u32 data);
+    u8* GetWritePage(u32 addr) {
+        return write_pages[addr >> 12];
+    }
 
-    // TODO: get rid of the repitition by just using a MemoryElement struct
+    // regions must be page aligned. memory takes priority over
+    // handlers when both are registered for the same page
     void RegisterReadMemory(u32 start, u32 end, u8* pointer);
     void RegisterWriteMemory(u32 start, u32 end, u8* pointer);
     void RegisterReadHandler(u32 start, u32 end, MemoryReadHandler handler);
     void RegisterWriteHandler(u32 start, u32 end, MemoryWriteHandler handler);
 
+    // registers a handler for accesses of the given widths to the registers from start up to end.
+    // later registrations replace earlier ones, so a range can be registered and then
+    // have some of its registers overridden
+    void RegisterIORead(u32 start, u32 end, int widths, IOReadHandler handler);
+    void RegisterIOWrite(u32 start, u32 end, int widths, IOWriteHandler handler);
+
+    // the same for a single register
+    void RegisterIORead(u32 addr, int widths, IOReadHandler handler);
+    void RegisterIOWrite(u32 addr, int widths, IOWriteHandler handler);
+
 private:
-    MemoryReadElement* GetReadMap(u32 addr);
-    MemoryWriteElement* GetWriteMap(u32 addr);
-    
-    MemoryReadMap read_map;
-    MemoryWriteMap write_map;
+    struct IOPage {
+        // the index of the handler plus 1 for each word of the page, for each width
+        std::array<std::array<u16, 1024>, 3> read;
+        std::array<std::array<u16, 1024>, 3> write;
+    };
+
+    IOPage& GetIOPage(u32 addr);
+
+    u32 SlowRead(u32 addr, int size);
+    void SlowWrite(u32 addr, u32 data, int size);
+
+    static constexpr int NUM_PAGES = 0x100000;
+
+    std::array<u8*, NUM_PAGES> read_pages;
+    std::array<u8*, NUM_PAGES> write_pages;
+
+    // 0 means the page isn't mapped, otherwise it's the index of the handler plus 1
+    std::array<u8, NUM_PAGES> read_handler_pages;
+    std::array<u8, NUM_PAGES> write_handler_pages;
+
+    std::vector<MemoryReadHandler> read_handlers;
+    std::vector<MemoryWriteHandler> write_handlers;
+
+    // 0 means the page has no registers, otherwise it's the index into io_pages plus 1
+    std::array<u8, NUM_PAGES> io_page_indices;
+    std::vector<std::unique_ptr<IOPage>> io_pages;
+
+    std::vector<IOReadHandler> io_read_handlers;
+    std::vector<IOWriteHandler> io_write_handlers;
 };
\ No newline at end of file
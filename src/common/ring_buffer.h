@@ -1,38 +1,142 @@
 #pragma once
 
 #include <array>
-#include "common/log.h"
+#include <atomic>
+#include <algorithm>
+#include "common/types.h"
 
+// a fifo which can be shared between one producer thread and one consumer thread
+// without any locking. the indices only ever increase, and get masked when indexing
+// the buffer, so size has to be a power of 2. each side only ever writes its own index,
+// and the release on it makes sure the other side sees the data before it sees the index move.
+// each side also keeps a copy of the other side's index, so it only has to touch
+// the other side's cache line when the ring looks full or empty
 template <typename T, int size>
 class RingBuffer {
 public:
+    static_assert(size > 0 && (size & (size - 1)) == 0, "ring buffer size must be a power of 2");
+
+    // only safe while neither side is using the ring
     void Reset() {
-        read_index = 0;
-        write_index = 0;
+        write_index.store(0, std::memory_order_relaxed);
+        read_index.store(0, std::memory_order_relaxed);
+        cached_read_index = 0;
+        cached_write_index = 0;
+    }
+
+    static constexpr int Capacity() {
+        return size;
     }
 
-    void Push(T data) {
-        buffer[write_index % size] = data;
-        write_index = (write_index + 1) % size;
-        capacity++;
+    // producer side. returns false and leaves the ring alone if it's full
+    bool Push(const T& data) {
+        u32 index = write_index.load(std::memory_order_relaxed);
+
+        if ((index - cached_read_index) == size) {
+            cached_read_index = read_index.load(std::memory_order_acquire);
+
+            if ((index - cached_read_index) == size) {
+                return false;
+            }
+        }
+
+        buffer[index & mask] = data;
+        write_index.store(index + 1, std::memory_order_release);
+        return true;
     }
 
+    // producer side. pushes as many of the count items as there's room for, and returns how many that was
+    int PushBulk(const T* data, int count) {
+        u32 index = write_index.load(std::memory_order_relaxed);
+
+        if (size - static_cast<int>(index - cached_read_index) < count) {
+            cached_read_index = read_index.load(std::memory_order_acquire);
+        }
+
+        count = std::min(count, size - static_cast<int>(index - cached_read_index));
+
+        // copy up to the end of the buffer, and then whatever's left to the start
+        int first = std::min(count, size - static_cast<int>(index & mask));
+        std::copy(data, data + first, &buffer[index & mask]);
+        std::copy(data + first, data + count, &buffer[0]);
+
+        write_index.store(index + count, std::memory_order_release);
+        return count;
+    }
+
+    // consumer side. the ring must not be empty
     T Pop() {
-        T data = buffer[read_index % size];
-        read_index = (read_index + 1) % size;
-        capacity--;
+        u32 index = read_index.load(std::memory_order_relaxed);
+        T data = buffer[index & mask];
 
+        read_index.store(index + 1, std::memory_order_release);
         return data;
     }
 
+    // consumer side. pops up to count items into data, and returns how many that was
+    int PopBulk(T* data, int count) {
+        int popped = 0;
+
+        // what's readable can wrap round the end of the buffer, so this takes at most 2 peeks
+        for (int i = 0; i < 2 && popped < count; i++) {
+            const T* items;
+            int available = std::min(count - popped, Peek(items));
+
+            if (available == 0) {
+                break;
+            }
+
+            std::copy(items, items + available, data + popped);
+            Consume(available);
+            popped += available;
+        }
+
+        return popped;
+    }
+
+    // consumer side. points items at the oldest items in the ring, and returns how many can be
+    // read from there without wrapping. they stay in the ring until they're consumed,
+    // so the producer can't overwrite them while they're being worked on
+    int Peek(const T*& items) {
+        u32 index = read_index.load(std::memory_order_relaxed);
+
+        // pop doesn't keep the copy of the write index up to date, so it can be behind us
+        if (static_cast<int>(cached_write_index - index) <= 0) {
+            cached_write_index = write_index.load(std::memory_order_acquire);
+        }
+
+        items = &buffer[index & mask];
+        return std::min(static_cast<int>(cached_write_index - index), size - static_cast<int>(index & mask));
+    }
+
+    // consumer side. removes count items that have been peeked
+    void Consume(int count) {
+        read_index.store(read_index.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // the producer sees a size that's too big and the consumer one that's too small,
+    // so each side can trust it for the operation they're about to do
     int Size() {
-        return capacity;
+        return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+    }
+
+    int Space() {
+        return size - Size();
+    }
+
+    bool Empty() {
+        return Size() == 0;
     }
 
 private:
-    int read_index = 0;
-    int write_index = 0;
-    int capacity = 0;
+    static constexpr u32 mask = size - 1;
+
+    // each side's index lives on its own cache line along with its copy of the other side's index
+    alignas(64) std::atomic<u32> write_index = 0;
+    u32 cached_read_index = 0;
+
+    alignas(64) std::atomic<u32> read_index = 0;
+    u32 cached_write_index = 0;
 
-    std::array<T, size> buffer;
+    alignas(64) std::array<T, size> buffer;
 };
\ No newline at end of file
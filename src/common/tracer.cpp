@@ -0,0 +1,485 @@
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <tuple>
+#include <vector>
+#include "common/log.h"
+#include "common/tracer.h"
+
+namespace {
+
+struct TraceBuffer {
+    std::unique_ptr<TraceEvent[]> events;
+    u32 capacity = 0;
+
+    // only the owning thread adds events, and the release on size means a dump
+    // can read everything below it while the thread carries on recording
+    std::atomic<u32> size = 0;
+    std::atomic<u32> dropped = 0;
+
+    // which run of the tracer the events are from, so a buffer
+    // is only cleared by its own thread the next time it records
+    u32 generation = 0;
+
+    int tid = 0;
+    std::string name;
+
+    // buffers outlive their threads, so they can still be dumped
+    // and then get reused by a thread which starts later
+    bool in_use = false;
+};
+
+std::mutex mutex;
+std::vector<std::unique_ptr<TraceBuffer>> buffers;
+std::atomic<u32> generation = 0;
+std::atomic<u32> max_events = Tracer::DEFAULT_MAX_EVENTS;
+std::atomic<u64> start_time = 0;
+int next_tid = 1;
+
+struct BufferOwner {
+    ~BufferOwner() {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffer->in_use = false;
+        }
+    }
+
+    TraceBuffer* buffer = nullptr;
+    const char* name = nullptr;
+};
+
+thread_local BufferOwner owner;
+
+u64 SteadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// gives the thread a buffer which is ready for the current run of the tracer
+TraceBuffer* PrepareBuffer(u32 current) {
+    std::lock_guard<std::mutex> lock(mutex);
+    TraceBuffer* buffer = owner.buffer;
+
+    if (!buffer) {
+        for (auto& candidate : buffers) {
+            if (!candidate->in_use && candidate->generation != current) {
+                buffer = candidate.get();
+                break;
+            }
+        }
+
+        if (!buffer) {
+            buffers.push_back(std::make_unique<TraceBuffer>());
+            buffer = buffers.back().get();
+            buffer->tid = next_tid++;
+        }
+
+        buffer->in_use = true;
+        buffer->name = owner.name ? owner.name : "Thread " + std::to_string(buffer->tid);
+        owner.buffer = buffer;
+    }
+
+    if (buffer->capacity != max_events) {
+        buffer->capacity = max_events;
+        buffer->events = std::make_unique<TraceEvent[]>(buffer->capacity);
+    }
+
+    buffer->size = 0;
+    buffer->dropped = 0;
+    buffer->generation = current;
+    return buffer;
+}
+
+void Record(const TraceEvent& event) {
+    TraceBuffer* buffer = owner.buffer;
+    u32 current = generation.load(std::memory_order_acquire);
+
+    if (!buffer || buffer->generation != current) {
+        buffer = PrepareBuffer(current);
+    }
+
+    u32 index = buffer->size.load(std::memory_order_relaxed);
+
+    if (index == buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[index] = event;
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void RecordEvent(TraceEventType type, const char* category, const char* name, u64 time, u64 duration, u64 arg) {
+    TraceEvent event;
+    event.time = time;
+    event.duration = duration;
+    event.name = name;
+    event.category = category;
+    event.arg = arg;
+    event.type = type;
+    Record(event);
+}
+
+void WriteJSONString(FILE* fp, const char* string) {
+    fputc('"', fp);
+
+    for (const char* c = string; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', fp);
+        }
+
+        fputc(*c, fp);
+    }
+
+    fputc('"', fp);
+}
+
+void DumpJSON(FILE* fp, const std::vector<std::pair<TraceBuffer*, u32>>& snapshot) {
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"otterstation\"}}");
+
+    for (auto& [buffer, size] : snapshot) {
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buffer->tid);
+        WriteJSONString(fp, buffer->name.c_str());
+        fprintf(fp, "}}");
+
+        for (u32 i = 0; i < size; i++) {
+            const TraceEvent& event = buffer->events[i];
+
+            fprintf(fp, ",\n{\"name\":");
+            WriteJSONString(fp, event.name);
+            fprintf(fp, ",\"pid\":1,\"tid\":%d,\"ts\":%.3f", buffer->tid, event.time / 1000.0);
+
+            if (event.type != TraceEventType::Counter) {
+                fprintf(fp, ",\"cat\":");
+                WriteJSONString(fp, event.category);
+            }
+
+            switch (event.type) {
+            case TraceEventType::Span:
+                fprintf(fp, ",\"ph\":\"X\",\"dur\":%.3f,\"args\":{\"arg\":%lu}}", event.duration / 1000.0, event.arg);
+                break;
+            case TraceEventType::Instant:
+                fprintf(fp, ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"arg\":%lu}}", event.arg);
+                break;
+            case TraceEventType::AsyncBegin:
+                fprintf(fp, ",\"ph\":\"b\",\"id\":%lu}", event.duration);
+                break;
+            case TraceEventType::AsyncEnd:
+                fprintf(fp, ",\"ph\":\"e\",\"id\":%lu}", event.duration);
+                break;
+            case TraceEventType::Counter:
+                fprintf(fp, ",\"ph\":\"C\",\"args\":{\"value\":%f}}", event.value);
+                break;
+            }
+        }
+    }
+
+    fprintf(fp, "\n]}\n");
+}
+
+// just enough of the protobuf wire format to write perfetto's trace packets
+class ProtoWriter {
+public:
+    void Varint(u64 value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        data.push_back(static_cast<char>(value));
+    }
+
+    void UInt(int field, u64 value) {
+        Varint((field << 3) | 0);
+        Varint(value);
+    }
+
+    void Double(int field, double value) {
+        Varint((field << 3) | 1);
+        char bytes[8];
+        memcpy(bytes, &value, 8);
+        data.append(bytes, 8);
+    }
+
+    void Bytes(int field, const std::string& value) {
+        Varint((field << 3) | 2);
+        Varint(value.size());
+        data.append(value);
+    }
+
+    void Message(int field, const ProtoWriter& message) {
+        Bytes(field, message.data);
+    }
+
+    std::string data;
+};
+
+// field numbers from perfetto's trace_packet.proto, track_event.proto and track_descriptor.proto
+enum PerfettoField {
+    TRACE_PACKET = 1,
+    PACKET_TIMESTAMP = 8,
+    PACKET_SEQUENCE_ID = 10,
+    PACKET_TRACK_EVENT = 11,
+    PACKET_TRACK_DESCRIPTOR = 60,
+    EVENT_DEBUG_ANNOTATIONS = 4,
+    EVENT_TYPE = 9,
+    EVENT_TRACK_UUID = 11,
+    EVENT_CATEGORIES = 22,
+    EVENT_NAME = 23,
+    EVENT_DOUBLE_COUNTER_VALUE = 44,
+    ANNOTATION_UINT_VALUE = 3,
+    ANNOTATION_NAME = 10,
+    TRACK_UUID = 1,
+    TRACK_NAME = 2,
+    TRACK_PROCESS = 3,
+    TRACK_THREAD = 4,
+    TRACK_PARENT_UUID = 5,
+    TRACK_COUNTER = 8,
+    PROCESS_PID = 1,
+    PROCESS_NAME = 6,
+    THREAD_PID = 1,
+    THREAD_TID = 2,
+    THREAD_NAME = 5,
+};
+
+enum PerfettoEventType {
+    SLICE_BEGIN = 1,
+    SLICE_END = 2,
+    INSTANT = 3,
+    COUNTER = 4,
+};
+
+constexpr u64 PROCESS_UUID = 1;
+constexpr int SEQUENCE_ID = 1;
+
+void WritePacket(FILE* fp, ProtoWriter& packet) {
+    packet.UInt(PACKET_SEQUENCE_ID, SEQUENCE_ID);
+
+    ProtoWriter trace;
+    trace.Message(TRACE_PACKET, packet);
+    fwrite(trace.data.data(), 1, trace.data.size(), fp);
+}
+
+void WriteTrack(FILE* fp, const ProtoWriter& track) {
+    ProtoWriter packet;
+    packet.Message(PACKET_TRACK_DESCRIPTOR, track);
+    WritePacket(fp, packet);
+}
+
+void DumpPerfetto(FILE* fp, const std::vector<std::pair<TraceBuffer*, u32>>& snapshot) {
+    ProtoWriter process;
+    process.UInt(PROCESS_PID, 1);
+    process.Bytes(PROCESS_NAME, "otterstation");
+
+    ProtoWriter process_track;
+    process_track.UInt(TRACK_UUID, PROCESS_UUID);
+    process_track.Message(TRACK_PROCESS, process);
+    WriteTrack(fp, process_track);
+
+    // spans become a begin and an end, so everything gets sorted by time. at the same time,
+    // ends go before begins, outer spans begin first and inner spans end first
+    struct Entry {
+        u64 time;
+        int phase;
+        s64 order;
+        u64 track;
+        PerfettoEventType type;
+        const TraceEvent* event;
+    };
+
+    std::vector<Entry> entries;
+    std::map<std::pair<std::string, u64>, u64> async_tracks;
+    std::map<std::string, u64> counter_tracks;
+    u64 next_uuid = 0x10000;
+
+    for (auto& [buffer, size] : snapshot) {
+        u64 thread_uuid = 0x100 + buffer->tid;
+
+        ProtoWriter thread;
+        thread.UInt(THREAD_PID, 1);
+        thread.UInt(THREAD_TID, buffer->tid);
+        thread.Bytes(THREAD_NAME, buffer->name);
+
+        ProtoWriter thread_track;
+        thread_track.UInt(TRACK_UUID, thread_uuid);
+        thread_track.UInt(TRACK_PARENT_UUID, PROCESS_UUID);
+        thread_track.Message(TRACK_THREAD, thread);
+        WriteTrack(fp, thread_track);
+
+        for (u32 i = 0; i < size; i++) {
+            const TraceEvent& event = buffer->events[i];
+
+            switch (event.type) {
+            case TraceEventType::Span:
+                entries.push_back({event.time, 2, -static_cast<s64>(event.duration), thread_uuid, SLICE_BEGIN, &event});
+                entries.push_back({event.time + event.duration, 0, -static_cast<s64>(event.time), thread_uuid, SLICE_END, &event});
+                break;
+            case TraceEventType::Instant:
+                entries.push_back({event.time, 1, 0, thread_uuid, INSTANT, &event});
+                break;
+            case TraceEventType::AsyncBegin:
+            case TraceEventType::AsyncEnd: {
+                auto [it, added] = async_tracks.try_emplace({event.name, event.duration}, next_uuid);
+
+                if (added) {
+                    ProtoWriter track;
+                    track.UInt(TRACK_UUID, next_uuid++);
+                    track.UInt(TRACK_PARENT_UUID, PROCESS_UUID);
+                    track.Bytes(TRACK_NAME, event.name);
+                    WriteTrack(fp, track);
+                }
+
+                bool begin = event.type == TraceEventType::AsyncBegin;
+                entries.push_back({event.time, begin ? 2 : 0, 0, it->second, begin ? SLICE_BEGIN : SLICE_END, &event});
+                break;
+            }
+            case TraceEventType::Counter: {
+                auto [it, added] = counter_tracks.try_emplace(event.name, next_uuid);
+
+                if (added) {
+                    ProtoWriter track;
+                    track.UInt(TRACK_UUID, next_uuid++);
+                    track.UInt(TRACK_PARENT_UUID, PROCESS_UUID);
+                    track.Bytes(TRACK_NAME, event.name);
+                    track.Message(TRACK_COUNTER, ProtoWriter{});
+                    WriteTrack(fp, track);
+                }
+
+                entries.push_back({event.time, 1, 0, it->second, COUNTER, &event});
+                break;
+            }
+            }
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return std::tie(a.time, a.phase, a.order) < std::tie(b.time, b.phase, b.order);
+    });
+
+    for (Entry& entry : entries) {
+        const TraceEvent& event = *entry.event;
+
+        ProtoWriter track_event;
+        track_event.UInt(EVENT_TYPE, entry.type);
+        track_event.UInt(EVENT_TRACK_UUID, entry.track);
+
+        if (entry.type == COUNTER) {
+            track_event.Double(EVENT_DOUBLE_COUNTER_VALUE, event.value);
+        } else if (entry.type != SLICE_END) {
+            track_event.Bytes(EVENT_CATEGORIES, event.category);
+            track_event.Bytes(EVENT_NAME, event.name);
+
+            if (event.type != TraceEventType::AsyncBegin) {
+                ProtoWriter annotation;
+                annotation.Bytes(ANNOTATION_NAME, "arg");
+                annotation.UInt(ANNOTATION_UINT_VALUE, event.arg);
+                track_event.Message(EVENT_DEBUG_ANNOTATIONS, annotation);
+            }
+        }
+
+        ProtoWriter packet;
+        packet.UInt(PACKET_TIMESTAMP, entry.time);
+        packet.Message(PACKET_TRACK_EVENT, track_event);
+        WritePacket(fp, packet);
+    }
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled = false;
+
+void Tracer::Start(u32 max_events_per_thread) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_events = std::max<u32>(max_events_per_thread, 1);
+    start_time = SteadyNanoseconds();
+    generation++;
+    enabled = true;
+}
+
+void Tracer::Stop() {
+    enabled = false;
+}
+
+bool Tracer::Dump(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    u32 current = generation;
+
+    // threads can still be recording, so only what's there now gets written
+    std::vector<std::pair<TraceBuffer*, u32>> snapshot;
+    u32 dropped = 0;
+
+    for (auto& buffer : buffers) {
+        if (buffer->generation == current) {
+            snapshot.emplace_back(buffer.get(), buffer->size.load(std::memory_order_acquire));
+            dropped += buffer->dropped;
+        }
+    }
+
+    bool perfetto = (path.size() >= 8 && path.compare(path.size() - 8, 8, ".pftrace") == 0) ||
+        (path.size() >= 15 && path.compare(path.size() - 15, 15, ".perfetto-trace") == 0);
+
+    FILE* fp = fopen(path.c_str(), perfetto ? "wb" : "w");
+
+    if (!fp) {
+        return false;
+    }
+
+    if (perfetto) {
+        DumpPerfetto(fp, snapshot);
+    } else {
+        DumpJSON(fp, snapshot);
+    }
+
+    fclose(fp);
+
+    if (dropped) {
+        log_warn("[Tracer] %u events were dropped after the buffers filled up", dropped);
+    }
+
+    return true;
+}
+
+void Tracer::SetThreadName(const char* name) {
+    owner.name = name;
+
+    if (owner.buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        owner.buffer->name = name;
+    }
+}
+
+u64 Tracer::Now() {
+    return SteadyNanoseconds() - start_time.load(std::memory_order_relaxed);
+}
+
+void Tracer::Span(const char* category, const char* name, u64 start, u64 arg) {
+    u64 now = Now();
+    RecordEvent(TraceEventType::Span, category, name, start, now > start ? now - start : 0, arg);
+}
+
+void Tracer::Instant(const char* category, const char* name, u64 arg) {
+    RecordEvent(TraceEventType::Instant, category, name, Now(), 0, arg);
+}
+
+void Tracer::AsyncBegin(const char* category, const char* name, u64 id) {
+    RecordEvent(TraceEventType::AsyncBegin, category, name, Now(), id, 0);
+}
+
+void Tracer::AsyncEnd(const char* category, const char* name, u64 id) {
+    RecordEvent(TraceEventType::AsyncEnd, category, name, Now(), id, 0);
+}
+
+void Tracer::Counter(const char* name, double value) {
+    TraceEvent event;
+    event.time = Now();
+    event.duration = 0;
+    event.name = name;
+    event.category = "counter";
+    event.value = value;
+    event.type = TraceEventType::Counter;
+    Record(event);
+}
\ No newline at end of file
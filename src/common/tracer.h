@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "common/types.h"
+
+#define USE_TRACING
+
+enum class TraceEventType : u8 {
+    // something which took time on the thread that recorded it
+    Span,
+    Instant,
+
+    // something which carries on across other work, like a dma transfer. begin and end
+    // are matched by name and id, and get a track of their own
+    AsyncBegin,
+    AsyncEnd,
+
+    Counter,
+};
+
+struct TraceEvent {
+    // in nanoseconds since the tracer was started
+    u64 time;
+
+    // the length of a span, or the id of an async event
+    u64 duration;
+
+    // names and categories aren't copied, so they have to be string literals
+    const char* name;
+    const char* category;
+
+    union {
+        u64 arg;
+        double value;
+    };
+
+    TraceEventType type;
+};
+
+// records a timeline of what the emulator is doing, which can be dumped as chrome trace json
+// or as a perfetto trace. each thread records into a fixed size buffer of its own, so recording
+// doesn't lock, and when the tracer isn't running every trace site is a single branch
+class Tracer {
+public:
+    static constexpr u32 DEFAULT_MAX_EVENTS = 1 << 18;
+
+    static bool IsEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // throws away anything recorded before. each thread keeps up to
+    // max_events, after which any more it records are dropped
+    static void Start(u32 max_events = DEFAULT_MAX_EVENTS);
+    static void Stop();
+
+    // writes everything recorded since the last start. paths ending in .pftrace or
+    // .perfetto-trace get a perfetto protobuf trace, and anything else gets chrome trace json
+    static bool Dump(const std::string& path);
+
+    // names the current thread's track
+    static void SetThreadName(const char* name);
+
+    static u64 Now();
+
+    // a span which started at start and ends now
+    static void Span(const char* category, const char* name, u64 start, u64 arg = 0);
+    static void Instant(const char* category, const char* name, u64 arg = 0);
+    static void AsyncBegin(const char* category, const char* name, u64 id);
+    static void AsyncEnd(const char* category, const char* name, u64 id);
+    static void Counter(const char* name, double value);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// records a span covering its own lifetime
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, u64 arg = 0) : category(category), name(name), arg(arg) {
+        if (Tracer::IsEnabled()) {
+            start = Tracer::Now();
+            active = true;
+        }
+    }
+
+    ~TraceScope() {
+        if (active) {
+            Tracer::Span(category, name, start, arg);
+        }
+    }
+
+private:
+    const char* category;
+    const char* name;
+    u64 arg;
+    u64 start = 0;
+    bool active = false;
+};
+
+#ifdef USE_TRACING
+#define trace_scope(category, name, ...) TraceScope trace_scope_(category, name, ##__VA_ARGS__)
+#define trace_instant(category, name, ...) \
+    do { \
+        if (Tracer::IsEnabled()) { \
+            Tracer::Instant(category, name, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#define trace_async_begin(category, name, id) \
+    do { \
+        if (Tracer::IsEnabled()) { \
+            Tracer::AsyncBegin(category, name, id); \
+        } \
+    } while (0)
+#define trace_async_end(category, name, id) \
+    do { \
+        if (Tracer::IsEnabled()) { \
+            Tracer::AsyncEnd(category, name, id); \
+        } \
+    } while (0)
+#else
+#define trace_scope(category, name, ...) do {} while (0)
+#define trace_instant(category, name, ...) do {} while (0)
+#define trace_async_begin(category, name, id) do {} while (0)
+#define trace_async_end(category, name, id) do {} while (0)
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "common/log_file.h"
+#include "core/batch_runner.h"
+#include "core/system.h"
+
+BatchRunner::BatchRunner(std::string bios_path, std::string log_directory, int num_threads) :
+    bios_path(bios_path), log_directory(log_directory), num_threads(num_threads) {
+    if (this->num_threads <= 0) {
+        this->num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void BatchRunner::Add(Job job) {
+    jobs.push_back(job);
+}
+
+std::vector<BatchRunner::Result> BatchRunner::Run() {
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> next_job = 0;
+    std::vector<std::thread> workers;
+
+    // each worker keeps taking the next job until there are none left,
+    // so a few slow jobs don't hold up the rest
+    auto worker = [&]() {
+        size_t index;
+
+        while ((index = next_job.fetch_add(1)) < jobs.size()) {
+            results[index] = RunJob(jobs[index]);
+        }
+    };
+
+    int num_workers = std::min<size_t>(num_threads, jobs.size());
+
+    for (int i = 0; i < num_workers; i++) {
+        workers.emplace_back(worker);
+    }
+
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    jobs.clear();
+    return results;
+}
+
+BatchRunner::Result BatchRunner::RunJob(const Job& job) {
+    LogFile log_file((log_directory + "/" + job.name + ".log").c_str());
+    LogFile::Bind(&log_file);
+
+    // systems are too big to go on the stack of a worker
+    auto system = std::make_unique<System>();
+    system->InitialiseEECore(job.ee_core_type);
+    system->InitialiseIOPCore(job.iop_core_type);
+    system->SetBIOSPath(bios_path);
+    system->memory.SetFastmem(job.fastmem);
+    system->SetIOPThread(job.iop_thread);
+    system->SetGSThread(job.gs_thread);
+    system->Reset();
+
+    if (!job.game_path.empty()) {
+        system->SetGamePath(job.game_path);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < job.frames; i++) {
+        system->RunFrame();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    Result result;
+    result.name = job.name;
+    result.frames = job.frames;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.cycles = system->scheduler.GetCurrentTime();
+    result.ee_pc = system->ee_core.pc;
+    result.iop_pc = system->iop_core->regs.pc;
+
+    LogFile::Bind(nullptr);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common/types.h"
+#include "common/cpu_types.h"
+
+// runs many independent systems in one process, for regression and performance testing.
+// each job gets its own system and log file, and jobs are spread over a pool of worker threads.
+// every system maps the bios from the same file, so they all share a single copy of its pages
+class BatchRunner {
+public:
+    struct Job {
+        // used to name the job's log file
+        std::string name;
+
+        // the elf to boot, or empty to only run the bios
+        std::string game_path;
+
+        int frames = 60;
+        CoreType ee_core_type = CoreType::Interpreter;
+        CoreType iop_core_type = CoreType::Interpreter;
+        bool fastmem = false;
+
+        // runs the job's iop and gs on threads of their own, on top of the worker's
+        bool iop_thread = false;
+        bool gs_thread = false;
+    };
+
+    struct Result {
+        std::string name;
+        int frames = 0;
+        double seconds = 0.0;
+        u64 cycles = 0;
+        u32 ee_pc = 0;
+        u32 iop_pc = 0;
+    };
+
+    // a num_threads of 0 uses a thread for every core
+    BatchRunner(std::string bios_path, std::string log_directory, int num_threads = 0);
+
+    void Add(Job job);
+
+    // runs every job added so far and blocks until they've all finished.
+    // results are given in the same order that the jobs were added
+    std::vector<Result> Run();
+
+private:
+    Result RunJob(const Job& job);
+
+    std::string bios_path;
+    std::string log_directory;
+    int num_threads;
+    std::vector<Job> jobs;
+};
\ No newline at end of file
@@ -34,4 +34,40 @@ void Core::RunFrame() {
 
 void Core::SetGamePath(std::string path) {
     system.SetGamePath(path);
+}
+
+void Core::SetFramelimiter(bool enabled) {
+    emu_thread.SetFramelimiter(enabled);
+}
+
+bool Core::GetFramelimiter() {
+    return emu_thread.GetFramelimiter();
+}
+
+void Core::SetTargetRate(float rate) {
+    emu_thread.SetTargetRate(rate);
+}
+
+float Core::GetTargetRate() {
+    return emu_thread.GetTargetRate();
+}
+
+void Core::SetFastForward(bool enabled) {
+    emu_thread.SetFastForward(enabled);
+}
+
+bool Core::GetFastForward() {
+    return emu_thread.GetFastForward();
+}
+
+void Core::SetTurbo(float multiplier) {
+    emu_thread.SetTurbo(multiplier);
+}
+
+float Core::GetTurbo() {
+    return emu_thread.GetTurbo();
+}
+
+FrameStats Core::GetFrameStats() {
+    return emu_thread.GetFrameStats();
 }
\ No newline at end of file
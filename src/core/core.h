@@ -20,6 +20,16 @@ public:
     void RunFrame();
     void SetGamePath(std::string path);
 
+    void SetFramelimiter(bool enabled);
+    bool GetFramelimiter();
+    void SetTargetRate(float rate);
+    float GetTargetRate();
+    void SetFastForward(bool enabled);
+    bool GetFastForward();
+    void SetTurbo(float multiplier);
+    float GetTurbo();
+    FrameStats GetFrameStats();
+
     System system;
     
 private:
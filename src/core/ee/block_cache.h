@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "common/types.h"
+#include "core/memory/memory_constants.h"
+
+// keeps track of blocks of ee code for the block based backends.
+// blocks are keyed by the physical address of their first instruction
+// and grouped into 4KB pages, so that every block on a page can be thrown
+// away at once when that page gets written to. only code in rdram and
+// the bios can be cached
+template <typename T>
+class BlockCache {
+public:
+    void Reset() {
+        for (auto& page : pages) {
+            page.reset();
+        }
+
+        FreeInvalidated();
+    }
+
+    T* GetBlock(u32 paddr) {
+        int index = GetPageIndex(paddr);
+
+        if (index < 0 || !pages[index]) {
+            return nullptr;
+        }
+
+        return pages[index]->blocks[PageOffset(paddr)].get();
+    }
+
+    // end is the physical address of the last instruction in the block
+    T* InsertBlock(u32 paddr, u32 end, std::unique_ptr<T> block) {
+        int index = GetPageIndex(paddr);
+        int end_index = GetPageIndex(end);
+        T* pointer = block.get();
+
+        GetPage(index).blocks[PageOffset(paddr)] = std::move(block);
+
+        // a block can spill into the next page with its delay slot, so we need to
+        // remember to remove it if that page is invalidated as well
+        if (end_index != index && end_index >= 0) {
+            GetPage(end_index).overlapping_blocks.push_back(paddr);
+        }
+
+        return pointer;
+    }
+
+    void InvalidatePage(int index) {
+        if (index < 0 || !pages[index]) {
+            return;
+        }
+
+        for (u32 paddr : pages[index]->overlapping_blocks) {
+            int start_index = GetPageIndex(paddr);
+
+            if (pages[start_index] && pages[start_index]->blocks[PageOffset(paddr)]) {
+                invalidated_blocks.push_back(std::move(pages[start_index]->blocks[PageOffset(paddr)]));
+            }
+        }
+
+        invalidated_pages.push_back(std::move(pages[index]));
+    }
+
+    // a store can invalidate the block that it's running from, so
+    // blocks are only freed once the backend is in between blocks
+    void FreeInvalidated() {
+        invalidated_pages.clear();
+        invalidated_blocks.clear();
+    }
+
+    static bool IsCacheable(u32 paddr) {
+        return GetPageIndex(paddr) >= 0;
+    }
+
+    static int GetPageIndex(u32 paddr) {
+        if (paddr < RDRAM_SIZE) {
+            return paddr >> 12;
+        } else if (paddr >= BIOS_BASE && paddr < (BIOS_BASE + BIOS_SIZE)) {
+            return (RDRAM_SIZE >> 12) + ((paddr - BIOS_BASE) >> 12);
+        }
+
+        return -1;
+    }
+
+private:
+    struct Page {
+        std::array<std::unique_ptr<T>, 0x400> blocks;
+        std::vector<u32> overlapping_blocks;
+    };
+
+    Page& GetPage(int index) {
+        if (!pages[index]) {
+            pages[index] = std::make_unique<Page>();
+        }
+
+        return *pages[index];
+    }
+
+    static int PageOffset(u32 paddr) {
+        return (paddr & 0xFFF) >> 2;
+    }
+
+    static constexpr int NUM_PAGES = (RDRAM_SIZE + BIOS_SIZE) >> 12;
+
+    std::array<std::unique_ptr<Page>, NUM_PAGES> pages;
+    std::vector<std::unique_ptr<Page>> invalidated_pages;
+    std::vector<std::unique_ptr<T>> invalidated_blocks;
+};
\ No newline at end of file
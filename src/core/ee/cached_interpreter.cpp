@@ -0,0 +1,145 @@
+#include "core/ee/cached_interpreter.h"
+#include "core/ee/ee_core.h"
+#include "core/ee/instruction_info.h"
+#include "core/system.h"
+
+EECachedInterpreter::EECachedInterpreter(EECore& cpu) : cpu(cpu) {
+    Reset();
+}
+
+void EECachedInterpreter::Reset() {
+    block_cache.Reset();
+}
+
+void EECachedInterpreter::Run() {
+    while (cpu.cycles_left > 0) {
+        // the rest of the cycles would just be spent going around the same loop
+        if (cpu.idle) {
+            cpu.SkipIdleCycles(cpu.cycles_left);
+            cpu.cycles_left = 0;
+            break;
+        }
+
+        // blocks always finish their delay slots, so this can
+        // only happen when coming from the plain interpreter
+        if (cpu.branch_delay) {
+            cpu.InterpretInstruction();
+            cpu.cycles_left--;
+            continue;
+        }
+
+        u32 paddr = cpu.system.memory.TranslateVirtualAddress(cpu.pc);
+        CachedBlock* block = block_cache.GetBlock(paddr);
+
+        if (!block) {
+            block = CompileBlock(cpu.pc, paddr);
+        }
+
+        if (!block) {
+            cpu.InterpretInstruction();
+            cpu.cycles_left--;
+            continue;
+        }
+
+        u32 block_pc = cpu.pc;
+
+        cpu.cycles_left -= ExecuteBlock(*block);
+
+        if (cpu.interrupt_pending) {
+            cpu.CheckInterrupts();
+        }
+
+        // the block might have been invalidated while it ran, but it isn't freed until after this
+        if (!block->idle_loop.empty() && cpu.pc == block_pc) {
+            cpu.CheckIdleLoop(block_pc, block->idle_loop);
+        }
+
+        block_cache.FreeInvalidated();
+    }
+}
+
+CachedBlock* EECachedInterpreter::CompileBlock(u32 pc, u32 paddr) {
+    if (!BlockCache<CachedBlock>::IsCacheable(paddr)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CachedBlock> block = std::make_unique<CachedBlock>();
+    u32 current_pc = pc;
+
+    while (true) {
+        CPUInstruction inst = cpu.ReadWord(current_pc);
+
+        block->instructions.push_back({cpu.interpreter_table.GetInterpreterInstruction(cpu, inst), inst});
+
+        if (EEIsBranch(inst)) {
+            // the delay slot always belongs to the same block as its branch
+            current_pc += 4;
+            inst = cpu.ReadWord(current_pc);
+            block->instructions.push_back({cpu.interpreter_table.GetInterpreterInstruction(cpu, inst), inst});
+            break;
+        }
+
+        if (EEIsBlockTerminator(inst)) {
+            break;
+        }
+
+        current_pc += 4;
+
+        if (block->instructions.size() == MAX_BLOCK_SIZE || (current_pc & 0xFFF) == 0) {
+            current_pc -= 4;
+            break;
+        }
+    }
+
+    std::vector<CPUInstruction> code;
+
+    for (CachedInstruction& entry : block->instructions) {
+        code.push_back(entry.inst);
+    }
+
+    if (EEIsIdleLoop(pc, code)) {
+        block->idle_loop = code;
+    }
+
+    u32 end = cpu.system.memory.TranslateVirtualAddress(current_pc);
+
+    cpu.system.memory.MarkEECode(paddr);
+    cpu.system.memory.MarkEECode(end);
+
+    return block_cache.InsertBlock(paddr, end, std::move(block));
+}
+
+void EECachedInterpreter::InvalidateCode(u32 paddr) {
+    block_cache.InvalidatePage(BlockCache<CachedBlock>::GetPageIndex(paddr));
+}
+
+int EECachedInterpreter::ExecuteBlock(CachedBlock& block) {
+    int executed = 0;
+
+    for (CachedInstruction& entry : block.instructions) {
+        u32 next_pc = cpu.pc + 4;
+
+        cpu.inst = entry.inst;
+        entry.handler(cpu, entry.inst);
+        cpu.pc += 4;
+        executed++;
+
+        if (cpu.branch_delay) {
+            if (cpu.branch) {
+                cpu.pc = cpu.next_pc;
+                cpu.branch_delay = false;
+                cpu.branch = false;
+            } else {
+                cpu.branch = true;
+            }
+        }
+
+        // a likely branch which wasn't taken or an exception leaves
+        // the rest of the block, so we stop here
+        if (cpu.pc != next_pc) {
+            break;
+        }
+    }
+
+    return executed;
+}
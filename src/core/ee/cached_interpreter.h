@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "common/types.h"
+#include "common/cpu_types.h"
+#include "core/ee/block_cache.h"
+#include "core/ee/interpreter_table.h"
+
+class EECore;
+
+struct CachedInstruction {
+    InterpreterInstruction handler;
+    CPUInstruction inst;
+};
+
+struct CachedBlock {
+    std::vector<CachedInstruction> instructions;
+    
+    // the block's code if it's an idle loop, which has
+    // to be checked each time that it loops back
+    std::vector<CPUInstruction> idle_loop;
+};
+
+// runs the normal interpreter handlers, but decodes each basic block only once.
+// this saves fetching each instruction through memory and walking the interpreter
+// table every time it's executed, while interrupts are checked per block
+class EECachedInterpreter {
+public:
+    EECachedInterpreter(EECore& cpu);
+
+    void Reset();
+    void Run();
+    void InvalidateCode(u32 paddr);
+
+private:
+    CachedBlock* CompileBlock(u32 pc, u32 paddr);
+    int ExecuteBlock(CachedBlock& block);
+
+    static constexpr int MAX_BLOCK_SIZE = 64;
+
+    BlockCache<CachedBlock> block_cache;
+
+    EECore& cpu;
+};
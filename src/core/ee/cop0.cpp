@@ -1,4 +1,6 @@
 #include <core/ee/cop0.h>
+#include <core/ee/ee_core.h>
+#include <core/system.h>
 
 enum COP0Regs {
     Index = 0,
@@ -25,6 +27,10 @@ enum COP0Regs {
     ErrorEPC = 30,
 };
 
+EECOP0::EECOP0(EECore& cpu) : cpu(cpu) {
+    compare_kind = cpu.system.scheduler.RegisterEvent<&EECOP0::CompareEvent>(this, "COP0 Compare");
+}
+
 void EECOP0::Reset() {
     for (int i = 0; i < 32; i++) {
         gpr[i] = 0;
@@ -32,14 +38,23 @@ void EECOP0::Reset() {
 
     cause.data = 0;
     gpr[PRId] = 0x2E20;
+
+    // the scheduler has been reset, so the old handle doesn't refer to anything
+    compare_event = Scheduler::INVALID_EVENT;
+    SetCount(0);
 }
 
 u32 EECOP0::GetReg(int reg) {
     switch (reg) {
     case 13:
         return cause.data;
-    case 9: case 12: case 14: case 15: case 30:
+    case 9:
+        return GetCount();
+    case 0: case 2: case 3: case 5: case 6: case 8:
+    case 10: case 12: case 14: case 15: case 16: case 30:
         return gpr[reg];
+    case 1:
+        return GetRandom();
     default:
         log_fatal("handle cop0 read %d", reg);
     }
@@ -48,8 +63,15 @@ u32 EECOP0::GetReg(int reg) {
 void EECOP0::SetReg(int reg, u32 data) {
     switch (reg) {
     case 0: case 2: case 3: case 5: case 6: 
-    case 9: case 10: case 12: case 16:
+    case 10: case 16:
+        gpr[reg] = data;
+        break;
+    case 9:
+        SetCount(data);
+        break;
+    case 12:
         gpr[reg] = data;
+        cpu.UpdateInterrupts();
         break;
     case 13:
         // cause can't be written to.
@@ -62,6 +84,7 @@ void EECOP0::SetReg(int reg, u32 data) {
         // in cause
         cause.timer_pending = false;
         gpr[reg] = data;
+        ScheduleCompareEvent();
         break;
     case 14:
         // log_warn("[COP0] write EPC %08x", data);
@@ -72,10 +95,42 @@ void EECOP0::SetReg(int reg, u32 data) {
     }
 }
 
-void EECOP0::CountUp() {
-    gpr[Count]++;
+// random counts down from 47 to wired, so rather than ticking it
+// we just work out where it would be from the current time
+u32 EECOP0::GetRandom() {
+    u32 wired = gpr[Wired] % EETLB::NUM_ENTRIES;
+    return (EETLB::NUM_ENTRIES - 1) - (cpu.GetCurrentTime() % (EETLB::NUM_ENTRIES - wired));
+}
+
+u32 EECOP0::GetCount() {
+    return gpr[Count] + static_cast<u32>(cpu.GetCurrentTime() - count_timestamp);
+}
+
+void EECOP0::SetCount(u32 data) {
+    gpr[Count] = data;
+    count_timestamp = cpu.GetCurrentTime();
+    ScheduleCompareEvent();
+}
+
+void EECOP0::ScheduleCompareEvent() {
+    Scheduler& scheduler = cpu.system.scheduler;
+    u64 delay = static_cast<u32>(gpr[Compare] - GetCount());
 
-    if (gpr[Count] == gpr[Compare]) {
-        cause.timer_pending = true;
+    // count only reaches compare again after wrapping around
+    if (delay == 0) {
+        delay = 0x100000000;
     }
+
+    // the cpu can be partway through a slice that the
+    // scheduler hasn't been ticked for yet
+    delay += cpu.GetCurrentTime() - scheduler.GetCurrentTime();
+
+    scheduler.Cancel(compare_event);
+    compare_event = scheduler.Add(delay, compare_kind);
+}
+
+void EECOP0::CompareEvent() {
+    cause.timer_pending = true;
+    cpu.UpdateInterrupts();
+    ScheduleCompareEvent();
 }
\ No newline at end of file
@@ -3,15 +3,28 @@
 #include <array>
 #include "common/types.h"
 #include "common/log.h"
+#include "core/scheduler.h"
+
+class EECore;
 
 class EECOP0 {
 public:
+    EECOP0(EECore& cpu);
+
     void Reset();
 
     u32 GetReg(int reg);
     void SetReg(int reg, u32 data);
 
-    void CountUp();
+    u32 GetRandom();
+
+    // count isn't incremented every cycle. instead it's calculated from
+    // the time it was last written, and an event is scheduled for when it
+    // will reach compare
+    u32 GetCount();
+    void SetCount(u32 data);
+    void ScheduleCompareEvent();
+    void CompareEvent();
 
     union Cause {
         struct {
@@ -33,4 +46,10 @@ public:
     } cause;
 
     std::array<u32, 32> gpr;
+
+private:
+    EECore& cpu;
+    u64 count_timestamp = 0;
+    EventKind compare_kind;
+    EventHandle compare_event = Scheduler::INVALID_EVENT;
 };
\ No newline at end of file
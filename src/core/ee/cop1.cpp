@@ -1,11 +1,46 @@
+#include <string.h>
+#include <math.h>
+#include <float.h>
 #include <core/ee/cop1.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// fcr31 bits
+#define FLAG_SU (1 << 3)
+#define FLAG_SO (1 << 4)
+#define FLAG_SD (1 << 5)
+#define FLAG_SI (1 << 6)
+#define FLAG_U (1 << 14)
+#define FLAG_O (1 << 15)
+#define FLAG_D (1 << 16)
+#define FLAG_I (1 << 17)
+#define FLAG_C (1 << 23)
+
+#define SIGN_BIT 0x80000000
+#define PS2_FLOAT_MAX 0x7FFFFFFF
+
+// clamps to the largest finite float. a nan turns into the negative maximum,
+// which is the same way maxss and minss treat it
+static inline f32 ClampFloat(f32 value) {
+#if defined(__SSE2__)
+    __m128 result = _mm_max_ss(_mm_set_ss(value), _mm_set_ss(-FLT_MAX));
+    return _mm_cvtss_f32(_mm_min_ss(result, _mm_set_ss(FLT_MAX)));
+#else
+    value = value > -FLT_MAX ? value : -FLT_MAX;
+    return value < FLT_MAX ? value : FLT_MAX;
+#endif
+}
+
 void EECOP1::Reset() {
     for (int i = 0; i < 32; i++) {
         fpr[i].u = 0;
         control[i] = 0;
     }
 
+    // implementation and revision number
+    control[0] = 0x2E00;
     accumulator.u = 0;
 }
 
@@ -22,24 +57,255 @@ u32 EECOP1::GetControlReg(int reg) {
 }
 
 void EECOP1::SetControlReg(int reg, u32 data) {
+    // fcr0 is read only
+    if (reg == 0) {
+        return;
+    }
+
     control[reg] = data;
 }
 
-// converts a u32 representation of a ps2 float
-// to one that conforms to IEEE 754 floats
-f32 EECOP1::AsFloat(u32 value) {
-    // we must handle the cases when exponent == 255 or 0
-    switch (value & 0x7F800000) {
-    case 0:
-        // denormals automatically get set to 0
-        value = 0;
-        return static_cast<float>(value);
-    case 0x7F800000:
-        // ps2 floats with the exponent as 255 can have numbers larger than what is possible
-        // with IEEE 754, so we just set to the highest possible float
-        value = (value & 0x80000000) | 0x7F7FFFFF;
-        return static_cast<float>(value);
-    default:
-        return static_cast<float>(value);
+void EECOP1::SetAccuracy(FPUAccuracy accuracy) {
+    this->accuracy = accuracy;
+}
+
+FPUAccuracy EECOP1::GetAccuracy() {
+    return accuracy;
+}
+
+bool EECOP1::GetCondition() {
+    return control[31] & FLAG_C;
+}
+
+void EECOP1::SetCondition(bool value) {
+    if (value) {
+        control[31] |= FLAG_C;
+    } else {
+        control[31] &= ~FLAG_C;
+    }
+}
+
+u32 EECOP1::Add(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_O | FLAG_U);
+        return AddFull(fs, ft);
+    }
+
+    return HostResult(ToFloat(fs) + ToFloat(ft));
+}
+
+u32 EECOP1::Sub(u32 fs, u32 ft) {
+    return Add(fs, ft ^ SIGN_BIT);
+}
+
+u32 EECOP1::Mul(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_O | FLAG_U);
+
+        // the product of two 24 bit mantissas is exact as a double
+        return RoundResult(ToDouble(fs) * ToDouble(ft));
+    }
+
+    return HostResult(ToFloat(fs) * ToFloat(ft));
+}
+
+u32 EECOP1::Div(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_D | FLAG_I);
+
+        if ((ft & 0x7F800000) == 0) {
+            // 0 / 0 is an invalid operation, anything else is a division by zero
+            SetFlags((fs & 0x7F800000) == 0 ? (FLAG_I | FLAG_SI) : (FLAG_D | FLAG_SD));
+            return ((fs ^ ft) & SIGN_BIT) | PS2_FLOAT_MAX;
+        }
+
+        return RoundResult(ToDouble(fs) / ToDouble(ft));
+    }
+
+    return HostResult(ToFloat(fs) / ToFloat(ft));
+}
+
+u32 EECOP1::Sqrt(u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_D | FLAG_I);
+
+        if ((ft & 0x7F800000) == 0) {
+            return ft & SIGN_BIT;
+        }
+
+        // negative numbers are treated as positive
+        if (ft & SIGN_BIT) {
+            SetFlags(FLAG_I | FLAG_SI);
+        }
+
+        return RoundResult(sqrt(ToDouble(ft & ~SIGN_BIT)));
+    }
+
+    return HostResult(sqrtf(ToFloat(ft)));
+}
+
+u32 EECOP1::RSqrt(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_D | FLAG_I);
+
+        if ((ft & 0x7F800000) == 0) {
+            SetFlags(FLAG_D | FLAG_SD);
+            return ((fs ^ ft) & SIGN_BIT) | PS2_FLOAT_MAX;
+        }
+
+        if (ft & SIGN_BIT) {
+            SetFlags(FLAG_I | FLAG_SI);
+        }
+
+        return RoundResult(ToDouble(fs) / sqrt(ToDouble(ft & ~SIGN_BIT)));
+    }
+
+    return HostResult(ToFloat(fs) / sqrtf(ToFloat(ft)));
+}
+
+u32 EECOP1::MultiplyAdd(u32 acc, u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        // the product is rounded before it's added
+        ClearFlags(FLAG_O | FLAG_U);
+        return AddFull(acc, RoundResult(ToDouble(fs) * ToDouble(ft)));
+    }
+
+    return HostResult(ToFloat(acc) + ToFloat(fs) * ToFloat(ft));
+}
+
+u32 EECOP1::MultiplySubtract(u32 acc, u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_O | FLAG_U);
+        return AddFull(acc, RoundResult(ToDouble(fs) * ToDouble(ft)) ^ SIGN_BIT);
+    }
+
+    return HostResult(ToFloat(acc) - ToFloat(fs) * ToFloat(ft));
+}
+
+u32 EECOP1::Max(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_O | FLAG_U);
+    }
+
+    return ToDouble(fs) >= ToDouble(ft) ? fs : ft;
+}
+
+u32 EECOP1::Min(u32 fs, u32 ft) {
+    if (accuracy == FPUAccuracy::Full) {
+        ClearFlags(FLAG_O | FLAG_U);
+    }
+
+    return ToDouble(fs) <= ToDouble(ft) ? fs : ft;
+}
+
+u32 EECOP1::ConvertToWord(u32 fs) {
+    // anything with a magnitude of 2^31 or more saturates
+    if ((fs & 0x7F800000) <= 0x4E800000) {
+        return static_cast<s32>(ToFloat(fs));
+    }
+
+    return (fs & SIGN_BIT) ? 0x80000000 : 0x7FFFFFFF;
+}
+
+u32 EECOP1::ConvertToSingle(u32 fs) {
+    if (accuracy == FPUAccuracy::Full) {
+        return RoundResult(static_cast<s32>(fs));
+    }
+
+    return HostResult(static_cast<f32>(static_cast<s32>(fs)));
+}
+
+// comparisons always use ps2 semantics, since they are cheap
+bool EECOP1::Equal(u32 fs, u32 ft) {
+    return ToDouble(fs) == ToDouble(ft);
+}
+
+bool EECOP1::LessThan(u32 fs, u32 ft) {
+    return ToDouble(fs) < ToDouble(ft);
+}
+
+bool EECOP1::LessThanOrEqual(u32 fs, u32 ft) {
+    return ToDouble(fs) <= ToDouble(ft);
+}
+
+u32 EECOP1::HostResult(f32 value) {
+    if (accuracy == FPUAccuracy::Clamp) {
+        value = ClampFloat(value);
+    }
+
+    u32 result;
+    memcpy(&result, &value, 4);
+    return result;
+}
+
+// converts an exact result back to a ps2 float by truncating the mantissa,
+// saturating on overflow and flushing to zero on underflow
+u32 EECOP1::RoundResult(double value) {
+    u64 bits;
+    memcpy(&bits, &value, 8);
+
+    u32 sign = (bits >> 32) & SIGN_BIT;
+    int exponent = static_cast<int>((bits >> 52) & 0x7FF) - 1023 + 127;
+
+    if ((bits & 0x7FFFFFFFFFFFFFFF) == 0) {
+        return sign;
+    }
+
+    if (exponent > 255) {
+        SetFlags(FLAG_O | FLAG_SO);
+        return sign | PS2_FLOAT_MAX;
+    }
+
+    if (exponent <= 0) {
+        SetFlags(FLAG_U | FLAG_SU);
+        return sign;
+    }
+
+    return sign | (exponent << 23) | ((bits >> 29) & 0x7FFFFF);
+}
+
+u32 EECOP1::AddFull(u32 fs, u32 ft) {
+    int fs_exponent = (fs >> 23) & 0xFF;
+    int ft_exponent = (ft >> 23) & 0xFF;
+
+    // the smaller operand gets shifted out completely when the exponents are
+    // more than 24 apart, otherwise the sum is exact as a double
+    if (fs_exponent - ft_exponent > 24) {
+        ft &= SIGN_BIT;
+    } else if (ft_exponent - fs_exponent > 24) {
+        fs &= SIGN_BIT;
     }
+
+    return RoundResult(ToDouble(fs) + ToDouble(ft));
+}
+
+void EECOP1::ClearFlags(u32 flags) {
+    control[31] &= ~flags;
+}
+
+void EECOP1::SetFlags(u32 flags) {
+    control[31] |= flags;
+}
+
+f32 EECOP1::ToFloat(u32 value) {
+    f32 result;
+    memcpy(&result, &value, 4);
+    return result;
+}
+
+// every ps2 float can be represented exactly as a double, including
+// ones with an exponent of 255. denormals are treated as 0
+double EECOP1::ToDouble(u32 value) {
+    if ((value & 0x7F800000) == 0) {
+        return (value & SIGN_BIT) ? -0.0 : 0.0;
+    }
+
+    u64 sign = static_cast<u64>(value & SIGN_BIT) << 32;
+    u64 exponent = static_cast<u64>(((value >> 23) & 0xFF) - 127 + 1023) << 52;
+    u64 mantissa = static_cast<u64>(value & 0x7FFFFF) << 29;
+    u64 bits = sign | exponent | mantissa;
+
+    double result;
+    memcpy(&result, &bits, 8);
+    return result;
 }
\ No newline at end of file
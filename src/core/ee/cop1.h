@@ -9,6 +9,20 @@ union FPURegister {
     s32 s;
 };
 
+// ps2 floats don't follow IEEE 754. there are no infinities, nans or denormals,
+// an exponent of 255 is just a very large number, and results are rounded towards zero.
+// emulating all of that is slow, so titles can pick how closely we follow it
+enum class FPUAccuracy {
+    // plain host floats
+    None,
+
+    // host floats, with results clamped to the largest finite float
+    Clamp,
+
+    // ps2 semantics, including the overflow, underflow and division flags
+    Full,
+};
+
 class EECOP1 {
 public:
     void Reset();
@@ -17,10 +31,44 @@ public:
     void SetReg(int reg, u32 data);
     u32 GetControlReg(int reg);
     void SetControlReg(int reg, u32 data);
-    
-    f32 AsFloat(u32 value);
+
+    void SetAccuracy(FPUAccuracy accuracy);
+    FPUAccuracy GetAccuracy();
+
+    bool GetCondition();
+    void SetCondition(bool value);
+
+    // these take and return the raw bits of ps2 floats
+    u32 Add(u32 fs, u32 ft);
+    u32 Sub(u32 fs, u32 ft);
+    u32 Mul(u32 fs, u32 ft);
+    u32 Div(u32 fs, u32 ft);
+    u32 Sqrt(u32 ft);
+    u32 RSqrt(u32 fs, u32 ft);
+    u32 MultiplyAdd(u32 acc, u32 fs, u32 ft);
+    u32 MultiplySubtract(u32 acc, u32 fs, u32 ft);
+    u32 Max(u32 fs, u32 ft);
+    u32 Min(u32 fs, u32 ft);
+    u32 ConvertToWord(u32 fs);
+    u32 ConvertToSingle(u32 fs);
+
+    bool Equal(u32 fs, u32 ft);
+    bool LessThan(u32 fs, u32 ft);
+    bool LessThanOrEqual(u32 fs, u32 ft);
 
     FPURegister fpr[32];
     FPURegister accumulator;
     u32 control[32];
+
+private:
+    u32 HostResult(f32 value);
+    u32 RoundResult(double value);
+    u32 AddFull(u32 fs, u32 ft);
+    void ClearFlags(u32 flags);
+    void SetFlags(u32 flags);
+
+    static f32 ToFloat(u32 value);
+    static double ToDouble(u32 value);
+
+    FPUAccuracy accuracy = FPUAccuracy::Clamp;
 };
\ No newline at end of file
@@ -157,6 +157,8 @@ static std::map<int, DisassemblyInfo> regimm_table = {
     {0, DisassemblyInfo{"bltz $rs, $offset", InstructionType::Immediate}},
     {1, DisassemblyInfo{"bgez $rs, $offset", InstructionType::Immediate}},
     {2, DisassemblyInfo{"bltzl $rs, $offset", InstructionType::Immediate}},
+    {24, DisassemblyInfo{"mtsab $rs, $imm", InstructionType::Immediate}},
+    {25, DisassemblyInfo{"mtsah $rs, $imm", InstructionType::Immediate}},
 };
 
 static std::map<int, DisassemblyInfo> cop0_table = {
@@ -165,25 +167,183 @@ static std::map<int, DisassemblyInfo> cop0_table = {
     {16, DisassemblyInfo{"tlb", InstructionType::None}},
 };
 
+static std::map<int, DisassemblyInfo> cop1_table = {
+    {0, DisassemblyInfo{"mfc1 $rt, $fs", InstructionType::Register}},
+    {2, DisassemblyInfo{"cfc1 $rt, $fs", InstructionType::Register}},
+    {4, DisassemblyInfo{"mtc1 $rt, $fs", InstructionType::Register}},
+    {6, DisassemblyInfo{"ctc1 $rt, $fs", InstructionType::Register}},
+    {8, DisassemblyInfo{"bc1", InstructionType::None}},
+    {16, DisassemblyInfo{"fpu.s", InstructionType::None}},
+    {20, DisassemblyInfo{"fpu.w", InstructionType::None}},
+};
+
+static std::map<int, DisassemblyInfo> bc1_table = {
+    {0, DisassemblyInfo{"bc1f $offset", InstructionType::Immediate}},
+    {1, DisassemblyInfo{"bc1t $offset", InstructionType::Immediate}},
+    {2, DisassemblyInfo{"bc1fl $offset", InstructionType::Immediate}},
+    {3, DisassemblyInfo{"bc1tl $offset", InstructionType::Immediate}},
+};
+
+static std::map<int, DisassemblyInfo> fpus_table = {
+    {0, DisassemblyInfo{"add.s $fd, $fs, $ft", InstructionType::Register}},
+    {1, DisassemblyInfo{"sub.s $fd, $fs, $ft", InstructionType::Register}},
+    {2, DisassemblyInfo{"mul.s $fd, $fs, $ft", InstructionType::Register}},
+    {3, DisassemblyInfo{"div.s $fd, $fs, $ft", InstructionType::Register}},
+    {4, DisassemblyInfo{"sqrt.s $fd, $ft", InstructionType::Register}},
+    {5, DisassemblyInfo{"abs.s $fd, $fs", InstructionType::Register}},
+    {6, DisassemblyInfo{"mov.s $fd, $fs", InstructionType::Register}},
+    {7, DisassemblyInfo{"neg.s $fd, $fs", InstructionType::Register}},
+    {22, DisassemblyInfo{"rsqrt.s $fd, $fs, $ft", InstructionType::Register}},
+    {24, DisassemblyInfo{"adda.s $fs, $ft", InstructionType::Register}},
+    {25, DisassemblyInfo{"suba.s $fs, $ft", InstructionType::Register}},
+    {26, DisassemblyInfo{"mula.s $fs, $ft", InstructionType::Register}},
+    {28, DisassemblyInfo{"madd.s $fd, $fs, $ft", InstructionType::Register}},
+    {29, DisassemblyInfo{"msub.s $fd, $fs, $ft", InstructionType::Register}},
+    {30, DisassemblyInfo{"madda.s $fs, $ft", InstructionType::Register}},
+    {31, DisassemblyInfo{"msuba.s $fs, $ft", InstructionType::Register}},
+    {36, DisassemblyInfo{"cvt.w.s $fd, $fs", InstructionType::Register}},
+    {40, DisassemblyInfo{"max.s $fd, $fs, $ft", InstructionType::Register}},
+    {41, DisassemblyInfo{"min.s $fd, $fs, $ft", InstructionType::Register}},
+    {48, DisassemblyInfo{"c.f.s $fs, $ft", InstructionType::Register}},
+    {50, DisassemblyInfo{"c.eq.s $fs, $ft", InstructionType::Register}},
+    {52, DisassemblyInfo{"c.lt.s $fs, $ft", InstructionType::Register}},
+    {54, DisassemblyInfo{"c.le.s $fs, $ft", InstructionType::Register}},
+};
+
+static std::map<int, DisassemblyInfo> fpuw_table = {
+    {32, DisassemblyInfo{"cvt.s.w $fd, $fs", InstructionType::Register}},
+};
+
 static std::map<int, DisassemblyInfo> cop2_table = {
     {2, DisassemblyInfo{"cfc2 $rt, $rd", InstructionType::Register}},
 };
 
 static std::map<int, DisassemblyInfo> tlb_table = {
+    {1, DisassemblyInfo{"tlbr", InstructionType::None}},
     {2, DisassemblyInfo{"tlbwi", InstructionType::None}},
+    {6, DisassemblyInfo{"tlbwr", InstructionType::None}},
+    {8, DisassemblyInfo{"tlbp", InstructionType::None}},
     {24, DisassemblyInfo{"eret", InstructionType::None}},
     {56, DisassemblyInfo{"ei", InstructionType::None}},
     {57, DisassemblyInfo{"di", InstructionType::None}},
 };
 
 static std::map<int, DisassemblyInfo> mmi_table = {
+    {0, DisassemblyInfo{"madd $rd, $rs, $rt", InstructionType::Register}},
+    {1, DisassemblyInfo{"maddu $rd, $rs, $rt", InstructionType::Register}},
     {4, DisassemblyInfo{"plzcw $rd, $rs", InstructionType::Register}},
+    {8, DisassemblyInfo{"mmi0", InstructionType::None}},
+    {9, DisassemblyInfo{"mmi2", InstructionType::None}},
     {16, DisassemblyInfo{"mfhi1 $rd", InstructionType::Register}},
     {17, DisassemblyInfo{"mthi1 $rs", InstructionType::Register}},
     {18, DisassemblyInfo{"mflo1 $rd", InstructionType::Register}},
     {19, DisassemblyInfo{"mtlo1 $rs", InstructionType::Register}},
     {24, DisassemblyInfo{"mult1 $rd, $rs, $rt", InstructionType::Register}},
+    {25, DisassemblyInfo{"multu1 $rd, $rs, $rt", InstructionType::Register}},
+    {26, DisassemblyInfo{"div1 $rs, $rt", InstructionType::Register}},
     {27, DisassemblyInfo{"divu1 $rs, $rt", InstructionType::Register}},
+    {32, DisassemblyInfo{"madd1 $rd, $rs, $rt", InstructionType::Register}},
+    {33, DisassemblyInfo{"maddu1 $rd, $rs, $rt", InstructionType::Register}},
+    {40, DisassemblyInfo{"mmi1", InstructionType::None}},
+    {41, DisassemblyInfo{"mmi3", InstructionType::None}},
+    {48, DisassemblyInfo{"pmfhl $rd, $sa", InstructionType::Register}},
+    {49, DisassemblyInfo{"pmthl $rs, $sa", InstructionType::Register}},
+    {52, DisassemblyInfo{"psllh $rd, $rt, $sa", InstructionType::Register}},
+    {54, DisassemblyInfo{"psrlh $rd, $rt, $sa", InstructionType::Register}},
+    {55, DisassemblyInfo{"psrah $rd, $rt, $sa", InstructionType::Register}},
+    {60, DisassemblyInfo{"psllw $rd, $rt, $sa", InstructionType::Register}},
+    {62, DisassemblyInfo{"psrlw $rd, $rt, $sa", InstructionType::Register}},
+    {63, DisassemblyInfo{"psraw $rd, $rt, $sa", InstructionType::Register}},
+};
+
+static std::map<int, DisassemblyInfo> mmi0_table = {
+    {0, DisassemblyInfo{"paddw $rd, $rs, $rt", InstructionType::Register}},
+    {1, DisassemblyInfo{"psubw $rd, $rs, $rt", InstructionType::Register}},
+    {2, DisassemblyInfo{"pcgtw $rd, $rs, $rt", InstructionType::Register}},
+    {3, DisassemblyInfo{"pmaxw $rd, $rs, $rt", InstructionType::Register}},
+    {4, DisassemblyInfo{"paddh $rd, $rs, $rt", InstructionType::Register}},
+    {5, DisassemblyInfo{"psubh $rd, $rs, $rt", InstructionType::Register}},
+    {6, DisassemblyInfo{"pcgth $rd, $rs, $rt", InstructionType::Register}},
+    {7, DisassemblyInfo{"pmaxh $rd, $rs, $rt", InstructionType::Register}},
+    {8, DisassemblyInfo{"paddb $rd, $rs, $rt", InstructionType::Register}},
+    {9, DisassemblyInfo{"psubb $rd, $rs, $rt", InstructionType::Register}},
+    {10, DisassemblyInfo{"pcgtb $rd, $rs, $rt", InstructionType::Register}},
+    {16, DisassemblyInfo{"paddsw $rd, $rs, $rt", InstructionType::Register}},
+    {17, DisassemblyInfo{"psubsw $rd, $rs, $rt", InstructionType::Register}},
+    {18, DisassemblyInfo{"pextlw $rd, $rs, $rt", InstructionType::Register}},
+    {19, DisassemblyInfo{"ppacw $rd, $rs, $rt", InstructionType::Register}},
+    {20, DisassemblyInfo{"paddsh $rd, $rs, $rt", InstructionType::Register}},
+    {21, DisassemblyInfo{"psubsh $rd, $rs, $rt", InstructionType::Register}},
+    {22, DisassemblyInfo{"pextlh $rd, $rs, $rt", InstructionType::Register}},
+    {23, DisassemblyInfo{"ppach $rd, $rs, $rt", InstructionType::Register}},
+    {24, DisassemblyInfo{"paddsb $rd, $rs, $rt", InstructionType::Register}},
+    {25, DisassemblyInfo{"psubsb $rd, $rs, $rt", InstructionType::Register}},
+    {26, DisassemblyInfo{"pextlb $rd, $rs, $rt", InstructionType::Register}},
+    {27, DisassemblyInfo{"ppacb $rd, $rs, $rt", InstructionType::Register}},
+    {30, DisassemblyInfo{"pext5 $rd, $rt", InstructionType::Register}},
+    {31, DisassemblyInfo{"ppac5 $rd, $rt", InstructionType::Register}},
+};
+
+static std::map<int, DisassemblyInfo> mmi1_table = {
+    {1, DisassemblyInfo{"pabsw $rd, $rt", InstructionType::Register}},
+    {2, DisassemblyInfo{"pceqw $rd, $rs, $rt", InstructionType::Register}},
+    {3, DisassemblyInfo{"pminw $rd, $rs, $rt", InstructionType::Register}},
+    {4, DisassemblyInfo{"padsbh $rd, $rs, $rt", InstructionType::Register}},
+    {5, DisassemblyInfo{"pabsh $rd, $rt", InstructionType::Register}},
+    {6, DisassemblyInfo{"pceqh $rd, $rs, $rt", InstructionType::Register}},
+    {7, DisassemblyInfo{"pminh $rd, $rs, $rt", InstructionType::Register}},
+    {10, DisassemblyInfo{"pceqb $rd, $rs, $rt", InstructionType::Register}},
+    {16, DisassemblyInfo{"padduw $rd, $rs, $rt", InstructionType::Register}},
+    {17, DisassemblyInfo{"psubuw $rd, $rs, $rt", InstructionType::Register}},
+    {18, DisassemblyInfo{"pextuw $rd, $rs, $rt", InstructionType::Register}},
+    {20, DisassemblyInfo{"padduh $rd, $rs, $rt", InstructionType::Register}},
+    {21, DisassemblyInfo{"psubuh $rd, $rs, $rt", InstructionType::Register}},
+    {22, DisassemblyInfo{"pextuh $rd, $rs, $rt", InstructionType::Register}},
+    {24, DisassemblyInfo{"paddub $rd, $rs, $rt", InstructionType::Register}},
+    {25, DisassemblyInfo{"psubub $rd, $rs, $rt", InstructionType::Register}},
+    {26, DisassemblyInfo{"pextub $rd, $rs, $rt", InstructionType::Register}},
+    {27, DisassemblyInfo{"qfsrv $rd, $rs, $rt", InstructionType::Register}},
+};
+
+static std::map<int, DisassemblyInfo> mmi2_table = {
+    {0, DisassemblyInfo{"pmaddw $rd, $rs, $rt", InstructionType::Register}},
+    {2, DisassemblyInfo{"psllvw $rd, $rs, $rt", InstructionType::Register}},
+    {3, DisassemblyInfo{"psrlvw $rd, $rs, $rt", InstructionType::Register}},
+    {4, DisassemblyInfo{"pmsubw $rd, $rs, $rt", InstructionType::Register}},
+    {8, DisassemblyInfo{"pmfhi $rd", InstructionType::Register}},
+    {9, DisassemblyInfo{"pmflo $rd", InstructionType::Register}},
+    {10, DisassemblyInfo{"pinth $rd, $rs, $rt", InstructionType::Register}},
+    {12, DisassemblyInfo{"pmultw $rd, $rs, $rt", InstructionType::Register}},
+    {13, DisassemblyInfo{"pdivw $rs, $rt", InstructionType::Register}},
+    {14, DisassemblyInfo{"pcpyld $rd, $rs, $rt", InstructionType::Register}},
+    {16, DisassemblyInfo{"pmaddh $rd, $rs, $rt", InstructionType::Register}},
+    {17, DisassemblyInfo{"phmadh $rd, $rs, $rt", InstructionType::Register}},
+    {18, DisassemblyInfo{"pand $rd, $rs, $rt", InstructionType::Register}},
+    {19, DisassemblyInfo{"pxor $rd, $rs, $rt", InstructionType::Register}},
+    {20, DisassemblyInfo{"pmsubh $rd, $rs, $rt", InstructionType::Register}},
+    {21, DisassemblyInfo{"phmsbh $rd, $rs, $rt", InstructionType::Register}},
+    {26, DisassemblyInfo{"pexeh $rd, $rt", InstructionType::Register}},
+    {27, DisassemblyInfo{"prevh $rd, $rt", InstructionType::Register}},
+    {28, DisassemblyInfo{"pmulth $rd, $rs, $rt", InstructionType::Register}},
+    {29, DisassemblyInfo{"pdivbw $rs, $rt", InstructionType::Register}},
+    {30, DisassemblyInfo{"pexew $rd, $rt", InstructionType::Register}},
+    {31, DisassemblyInfo{"prot3w $rd, $rt", InstructionType::Register}},
+};
+
+static std::map<int, DisassemblyInfo> mmi3_table = {
+    {0, DisassemblyInfo{"pmadduw $rd, $rs, $rt", InstructionType::Register}},
+    {3, DisassemblyInfo{"psravw $rd, $rs, $rt", InstructionType::Register}},
+    {8, DisassemblyInfo{"pmthi $rs", InstructionType::Register}},
+    {9, DisassemblyInfo{"pmtlo $rs", InstructionType::Register}},
+    {10, DisassemblyInfo{"pinteh $rd, $rs, $rt", InstructionType::Register}},
+    {12, DisassemblyInfo{"pmultuw $rd, $rs, $rt", InstructionType::Register}},
+    {13, DisassemblyInfo{"pdivuw $rs, $rt", InstructionType::Register}},
+    {14, DisassemblyInfo{"pcpyud $rd, $rs, $rt", InstructionType::Register}},
+    {18, DisassemblyInfo{"por $rd, $rs, $rt", InstructionType::Register}},
+    {19, DisassemblyInfo{"pnor $rd, $rs, $rt", InstructionType::Register}},
+    {26, DisassemblyInfo{"pexch $rd, $rt", InstructionType::Register}},
+    {27, DisassemblyInfo{"pcpyh $rd, $rt", InstructionType::Register}},
+    {30, DisassemblyInfo{"pexcw $rd, $rt", InstructionType::Register}},
 };
 
 static std::map<int, std::string> cop0_names = {
@@ -286,6 +446,15 @@ static std::string DisassembleRegister(CPUInstruction inst, u32 pc, std::string
         } else if (format.compare(i, 3, "$sa") == 0) {
             disassembled += ConvertHex<u16>(inst.imm5);
             i += 3;
+        } else if (format.compare(i, 3, "$fs") == 0) {
+            disassembled += "$f" + std::to_string(inst.rd);
+            i += 3;
+        } else if (format.compare(i, 3, "$ft") == 0) {
+            disassembled += "$f" + std::to_string(inst.rt);
+            i += 3;
+        } else if (format.compare(i, 3, "$fd") == 0) {
+            disassembled += "$f" + std::to_string(inst.imm5);
+            i += 3;
         } else {
             disassembled += format[i];
             i++;
@@ -312,6 +481,26 @@ std::string EEDisassembleInstruction(CPUInstruction inst, u32 pc) {
         }
     } else if (info.format.compare("mmi") == 0) {
         info = mmi_table[inst.func];
+
+        if (info.format.compare("mmi0") == 0) {
+            info = mmi0_table[inst.imm5];
+        } else if (info.format.compare("mmi1") == 0) {
+            info = mmi1_table[inst.imm5];
+        } else if (info.format.compare("mmi2") == 0) {
+            info = mmi2_table[inst.imm5];
+        } else if (info.format.compare("mmi3") == 0) {
+            info = mmi3_table[inst.imm5];
+        }
+    } else if (info.format.compare("cop1") == 0) {
+        info = cop1_table[inst.rs];
+
+        if (info.format.compare("bc1") == 0) {
+            info = bc1_table[inst.rt];
+        } else if (info.format.compare("fpu.s") == 0) {
+            info = fpus_table[inst.func];
+        } else if (info.format.compare("fpu.w") == 0) {
+            info = fpuw_table[inst.func];
+        }
     } else if (info.format.compare("cop2") == 0) {
         info = cop2_table[inst.rs];
     }
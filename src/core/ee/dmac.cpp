@@ -1,4 +1,5 @@
 #include "common/log_file.h"
+#include "common/tracer.h"
 #include "core/ee/dmac.h"
 #include "core/system.h"
 
@@ -53,11 +54,11 @@ u32 DMAC::ReadChannel(u32 addr) {
 void DMAC::WriteRegister(u32 addr, u32 data) {
     switch (addr) {
     case 0x1000E000:
-        log_debug("[DMAC] D_CTRL write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_CTRL write %08x\n", data);
         control = data;
         break;
     case 0x1000E010:
-        LogFile::Get().Log("[DMAC] D_STAT write %08x\n", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_STAT write %08x\n", data);
 
         // for bits (0..15) they get cleared if 1 is written
         interrupt_status &= ~(data & 0xFFFF);
@@ -68,23 +69,23 @@ void DMAC::WriteRegister(u32 addr, u32 data) {
         CheckInterruptSignal();
         break;
     case 0x1000E020:
-        log_debug("[DMAC] D_PCR write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_PCR write %08x\n", data);
         priority_control = data;
         break;
     case 0x1000E030:
-        log_debug("[DMAC] D_SQWC write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_SQWC write %08x\n", data);
         skip_quadword = data;
         break;
     case 0x1000E040:
-        log_debug("[DMAC] D_RBSR write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_RBSR write %08x\n", data);
         ringbuffer_size = data;
         break;
     case 0x1000E050:
-        log_debug("[DMAC] D_RBOR write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_RBOR write %08x\n", data);
         ringbuffer_offset = data;
         break;
     case 0x1000F590:
-        log_debug("[DMAC] D_ENABLE write %08x", data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] D_ENABLE write %08x\n", data);
         disabled_status = data;
         break;
     default:
@@ -104,34 +105,34 @@ void DMAC::WriteChannel(u32 addr, u32 data) {
 
     switch (addr & 0xFF) {
     case 0x00:
-        log_debug("[DMAC] %s Dn_CHCR write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_CHCR write %08x\n", channel_name, data);
         channels[index].control = data;
 
         StartTransfer(index);
         break;
     case 0x10:
-        log_debug("[DMAC] %s Dn_MADR write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_MADR write %08x\n", channel_name, data);
         channels[index].address = data & ~0xF;
         break;
     case 0x20:
         // In normal and interleaved mode, the transfer ends when QWC reaches zero. Chain mode behaves differently
-        log_debug("[DMAC] %s Dn_QWC write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_QWC write %08x\n", channel_name, data);
         channels[index].quadword_count = data & 0xFFFF;
         break;
     case 0x30:
-        log_debug("[DMAC] %s Dn_TADR write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_TADR write %08x\n", channel_name, data);
         channels[index].tag_address = data & ~0xF;
         break;
     case 0x40:
-        log_debug("[DMAC] %s Dn_ASR0 write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_ASR0 write %08x\n", channel_name, data);
         channels[index].saved_tag_address0 = data & ~0xF;
         break;
     case 0x50:
-        log_debug("[DMAC] %s Dn_ASR1 write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_ASR1 write %08x\n", channel_name, data);
         channels[index].saved_tag_address1 = data & ~0xF;
         break;
     case 0x80:
-        log_debug("[DMAC] %s Dn_SADR write %08x", channel_name, data);
+        log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s Dn_SADR write %08x\n", channel_name, data);
         channels[index].scratchpad_address = data & ~0xF;
         break;
     default:
@@ -183,22 +184,22 @@ int DMAC::GetChannelIndex(u32 addr) {
 }
 
 u32 DMAC::ReadInterruptStatus() {
-    LogFile::Get().Log("[DMAC] D_STAT read %08x\n", interrupt_status);
+    log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] D_STAT read %08x\n", interrupt_status);
     return interrupt_status;
 }
 
 u32 DMAC::ReadControl() {
-    log_debug("[DMAC] read control %08x", control);
+    log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] read control %08x\n", control);
     return control;
 }
 
 u32 DMAC::ReadPriorityControl() {
-    log_warn("[DMAC] read priority control %08x", priority_control);
+    log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] read priority control %08x\n", priority_control);
     return priority_control;
 }
 
 u32 DMAC::ReadSkipQuadword() {
-    log_warn("[DMAC] read skip quadword %08x", skip_quadword);
+    log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] read skip quadword %08x\n", skip_quadword);
     return skip_quadword;
 }
 
@@ -207,7 +208,7 @@ void DMAC::CheckInterruptSignal() {
 
     for (int i = 0; i < 10; i++) {
         if ((interrupt_status & (1 << i)) && (interrupt_status & (1 << (16 + i)))) {
-            LogFile::Get().Log("[DMAC] %s interrupt sent\n", channel_names[i]);
+            log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s interrupt sent\n", channel_names[i]);
             irq = true;
             break;
         }
@@ -225,14 +226,23 @@ void DMAC::Run(int cycles) {
     }
 
     while (cycles--) {
+        bool active = false;
+
         // run each channel
         for (int i = 0; i < 10; i++) {
             DMAChannel& channel = channels[i];
 
             if (channel.control & (1 << 8)) {
                 Transfer(i);
+                active = true;
             }
         }
+
+        // nothing can start a transfer from in here, so there's no need to
+        // keep going through the rest of the slice once every channel is idle
+        if (!active) {
+            return;
+        }
     }
 }
 
@@ -275,12 +285,14 @@ void DMAC::DoSIF0Transfer() {
             for (int i = 0; i < 4; i++) {
                 u32 data = system->sif.ReadSIF0FIFO();
 
-                LogFile::Get().Log("[DMAC] SIF0 reading data from fifo %08x\n", data);
+                log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] SIF0 reading data from fifo %08x\n", data);
 
                 system->ee_core.WriteWord(channel.address, data);
                 channel.address += 4;
             }
 
+            // the ee could be polling ram for this data, so it can't be left idle
+            system->ee_core.idle = false;
             channel.quadword_count--;
         }
     } else if (channel.end_transfer) {
@@ -293,7 +305,7 @@ void DMAC::DoSIF0Transfer() {
             dma_tag |= system->sif.ReadSIF0FIFO();
             dma_tag |= (u64)system->sif.ReadSIF0FIFO() << 32;
 
-            LogFile::Get().Log("[DMAC] SIF0 read DMATag %016lx\n", dma_tag);
+            log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] SIF0 read DMATag %016lx\n", dma_tag);
 
             channel.quadword_count = dma_tag & 0xFFFF;
             channel.address = (dma_tag >> 32) & 0xFFFFFFF0;
@@ -314,10 +326,15 @@ void DMAC::DoSIF1Transfer() {
     DMAChannel& channel = channels[6];
 
     if (channel.quadword_count) {
+        // the iop might not have caught up with the fifo yet, in which case we wait for it
+        if (system->sif.GetSIF1FIFOSpace() < 4) {
+            return;
+        }
+
         // push data to the sif1 fifo
         u128 data = system->ee_core.ReadQuad(channel.address);
 
-        LogFile::Get().Log("[DMAC] SIF1 Fifo write %016lx%016lx dstat %08x\n", data.i.hi, data.i.lo, interrupt_status);
+        log_channel(LogChannel::DMAC, LogLevel::Trace, "[DMAC] SIF1 Fifo write %016lx%016lx dstat %08x\n", data.i.hi, data.i.lo, interrupt_status);
 
         system->sif.WriteSIF1FIFO(data);
 
@@ -332,7 +349,11 @@ void DMAC::DoSIF1Transfer() {
 }
 
 void DMAC::StartTransfer(int index) {
-    LogFile::Get().Log("[DMAC] %s start transfer\n", channel_names[index]);
+    log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s start transfer\n", channel_names[index]);
+
+    if (channels[index].control & (1 << 8)) {
+        trace_async_begin("dma", channel_names[index], index);
+    }
 
     // in normal mode we shouldn't worry about dmatag reading
     u8 mode = (channels[index].control >> 2) & 0x3;
@@ -340,7 +361,8 @@ void DMAC::StartTransfer(int index) {
 }
 
 void DMAC::EndTransfer(int index) {
-    LogFile::Get().Log("[DMAC] %s end transfer\n", channel_names[index]);
+    log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s end transfer\n", channel_names[index]);
+    trace_async_end("dma", channel_names[index], index);
 
     channels[index].end_transfer = false;
     channels[index].control &= ~(1 << 8);
@@ -356,7 +378,7 @@ void DMAC::DoSourceChain(int index) {
     u128 data = system->ee_core.ReadQuad(channel.tag_address);
     u64 dma_tag = data.i.lo;
 
-    LogFile::Get().Log("[DMAC] %s read DMATag %016lx d stat %08x\n", channel_names[index], dma_tag, interrupt_status);
+    log_channel(LogChannel::DMAC, LogLevel::Debug, "[DMAC] %s read DMATag %016lx d stat %08x\n", channel_names[index], dma_tag, interrupt_status);
 
     channel.quadword_count = dma_tag & 0xFFFF;
     channel.control = (channel.control & 0xFFFF) | (dma_tag & 0xFFFF0000);
@@ -1,9 +1,13 @@
 #include <assert.h>
 #include <array>
 #include "common/log_file.h"
+#include "common/tracer.h"
 #include "core/ee/ee_core.h"
 #include "core/system.h"
 #include "core/ee/disassembler.h"
+#include "core/ee/cached_interpreter.h"
+#include "core/ee/jit/jit.h"
+#include "core/ee/threaded_interpreter.h"
 
 static std::array<std::string, 256> syscall_info = {
     "RFU000_FullReset", "ResetEE", "SetGsCrt", "RFU003",
@@ -46,7 +50,9 @@ static std::array<std::string, 256> syscall_info = {
     "Deci2Call", "PSMode", "MachineType", "GetMemorySize",
 };
 
-EECore::EECore(System& system) : system(system) {}
+EECore::EECore(System& system) : system(system), cop0(*this) {}
+
+EECore::~EECore() {}
 
 void EECore::Reset() {
     for (int i = 0; i < 512; i++) {
@@ -63,83 +69,215 @@ void EECore::Reset() {
     inst.data = 0;
     branch_delay = false;
     branch = false;
+    idle = false;
+    cycles_left = 0;
+    slice_cycles = 0;
+    interrupt_pending = false;
 
     cop0.Reset();
     cop1.Reset();
+    tlb.Reset();
     interpreter_table.Generate();
+    idle_loop_detector.Reset();
+
+    if (cached_interpreter) {
+        cached_interpreter->Reset();
+    }
+
+    if (jit) {
+        jit->Reset();
+    }
 }
 
 void EECore::Run(int cycles) {
-    while (cycles--) {
-        inst = CPUInstruction{ReadWord(pc)};
+    idle = false;
+    slice_cycles = cycles;
+    cycles_left += cycles;
+
+    switch (core_type) {
+    case CoreType::Interpreter:
+        while (cycles_left > 0) {
+            InterpretInstruction();
+            cycles_left--;
+
+            if (idle) {
+                SkipIdleCycles(cycles_left);
+                cycles_left = 0;
+                break;
+            }
+        }
 
-        interpreter_table.Execute(*this, inst);
+        break;
+    case CoreType::CachedInterpreter:
+        cached_interpreter->Run();
+        break;
+    case CoreType::JIT:
+        jit->Run();
+        break;
+    case CoreType::ThreadedInterpreter:
+        threaded_interpreter->Run();
+        break;
+    }
 
-        pc += 4;
+    // the scheduler gets ticked for the whole slice after this, so
+    // only the overrun is left to be accounted for
+    slice_cycles = 0;
+}
 
-        if (branch_delay) {
-            if (branch) {
-                pc = next_pc;
-                branch_delay = false;
-                branch = false;
-            } else {
-                branch = true;
-            }
-        }
+void EECore::SetCoreType(CoreType type) {
+    cached_interpreter.reset();
+    jit.reset();
+    threaded_interpreter.reset();
+
+    switch (type) {
+    case CoreType::Interpreter:
+        break;
+    case CoreType::CachedInterpreter:
+        cached_interpreter = std::make_unique<EECachedInterpreter>(*this);
+        break;
+    case CoreType::JIT:
+        jit = std::make_unique<EEJIT>(*this);
+        break;
+    case CoreType::ThreadedInterpreter:
+        threaded_interpreter = std::make_unique<EEThreadedInterpreter>(*this);
+        break;
+    default:
+        log_fatal("[EE] core type %d is not supported", static_cast<int>(type));
+    }
+
+    core_type = type;
+}
+
+void EECore::InvalidateCode(u32 paddr) {
+    idle_loop_detector.InvalidateCode();
+
+    switch (core_type) {
+    case CoreType::Interpreter:
+    case CoreType::ThreadedInterpreter:
+        break;
+    case CoreType::CachedInterpreter:
+        cached_interpreter->InvalidateCode(paddr);
+        break;
+    case CoreType::JIT:
+        jit->InvalidateCode(paddr);
+        break;
+    }
+}
+
+void EECore::InvalidateTranslations() {
+    system.memory.UpdateFastmem();
+
+    // cached and jit blocks are looked up by physical address,
+    // so only the threaded interpreter's fetch page can go stale
+    if (core_type == CoreType::ThreadedInterpreter) {
+        threaded_interpreter->InvalidateFetchPage();
+    }
+}
+
+void EECore::SkipIdleCycles(int cycles) {
+    if (cycles > 0) {
+        idle_loop_detector.RecordSkip(cycles);
+    }
+}
+
+void EECore::CheckIdleLoop(u32 start, const std::vector<CPUInstruction>& code) {
+    idle = IdleLoopDetector::CheckLoads(code, [this](int reg) {
+        return GetReg<u32>(reg);
+    }, [this](u32 addr) {
+        return system.memory.EEIsIdleAddress(addr);
+    });
+
+    if (idle) {
+        idle_loop_detector.SetCurrentLoop(start);
+    }
+}
+
+u64 EECore::GetCurrentTime() {
+    return system.scheduler.GetCurrentTime() + slice_cycles - cycles_left;
+}
+
+void EECore::InterpretInstruction() {
+    inst = CPUInstruction{ReadWord(pc)};
+
+    interpreter_table.Execute(*this, inst);
+
+    pc += 4;
+
+    if (branch_delay) {
+        UpdateBranchDelay();
+    }
 
-        cop0.CountUp();
+    if (interrupt_pending) {
         CheckInterrupts();
     }
 }
 
+void EECore::UpdateBranchDelay() {
+    if (branch) {
+        u32 branch_pc = pc - 8;
+
+        pc = next_pc;
+        branch_delay = false;
+        branch = false;
+
+        // reading the loop marks its page as code, so that
+        // the analysis is thrown away if the loop is overwritten
+        idle = idle_loop_detector.CheckBranch(pc, branch_pc, [this](u32 addr) {
+            system.memory.MarkEECode(system.memory.TranslateVirtualAddress(addr));
+            return ReadWord(addr);
+        }, [this](int reg) {
+            return GetReg<u32>(reg);
+        }, [this](u32 addr) {
+            return system.memory.EEIsIdleAddress(addr);
+        });
+    } else {
+        branch = true;
+    }
+}
+
 u8 EECore::ReadByte(u32 addr) {
-    return system.memory.EEReadByte(addr);
+    return system.memory.EERead<u8>(addr);
 }
 
 u16 EECore::ReadHalf(u32 addr) {
-    return system.memory.EEReadHalf(addr);
+    return system.memory.EERead<u16>(addr);
 }
 
 u32 EECore::ReadWord(u32 addr) {
-    return system.memory.EEReadWord(addr);
+    return system.memory.EERead<u32>(addr);
 }
 
 u64 EECore::ReadDouble(u32 addr) {
-    return system.memory.EEReadDouble(addr);
+    return system.memory.EERead<u64>(addr);
 }
 
 u128 EECore::ReadQuad(u32 addr) {
-    u128 data;
-    // log_debug("low double at address %08x = %016lx", addr, system.memory.EERead<u64>(addr));
-    // log_debug("high double at address %08x = %016lx", addr + 8, system.memory.EERead<u64>(addr + 8));
-    data.i.lo = system.memory.EEReadDouble(addr);
-    data.i.hi = system.memory.EEReadDouble(addr + 8);
-
-    return data;
+    return system.memory.EERead<u128>(addr);
 }
 
 void EECore::WriteByte(u32 addr, u8 data) {
-    system.memory.EEWriteByte(addr, data);
+    system.memory.EEWrite<u8>(addr, data);
 }
 
 void EECore::WriteHalf(u32 addr, u16 data) {
-    system.memory.EEWriteHalf(addr, data);
+    system.memory.EEWrite<u16>(addr, data);
 }
 
 void EECore::WriteWord(u32 addr, u32 data) {
-    system.memory.EEWriteWord(addr, data);
+    system.memory.EEWrite<u32>(addr, data);
 }
 
 void EECore::WriteDouble(u32 addr, u64 data) {
-    system.memory.EEWriteDouble(addr, data);
+    system.memory.EEWrite<u64>(addr, data);
 }
 
 void EECore::WriteQuad(u32 addr, u128 data) {
-    system.memory.EEWriteQuad(addr, data);
+    system.memory.EEWrite<u128>(addr, data);
 }
 
 void EECore::DoException(u32 target, ExceptionType exception) {
-    LogFile::Get().Log("[EE] trigger exception with type %02x at pc = %08x\n", static_cast<int>(exception), pc);
+    log_channel(LogChannel::EE, LogLevel::Debug, "[EE] trigger exception with type %02x at pc = %08x\n", static_cast<int>(exception), pc);
+    trace_instant("exception", "EE Exception", static_cast<u64>(exception));
 
     bool level2_exception = static_cast<int>(exception) >= 14;
     int code = level2_exception ? static_cast<int>(exception) - 14 : static_cast<int>(exception);
@@ -155,17 +293,25 @@ void EECore::DoException(u32 target, ExceptionType exception) {
         pc = target - 4;
     }
 
+    UpdateInterrupts();
+
     branch_delay = false;
     branch = false;
+    idle = false;
+    idle_loop_detector.ResetLastBranch();
 }
 
 void EECore::SendInterruptSignal(int signal, bool value) {
+    idle = false;
+
     if (signal == 0) {
         cop0.cause.int0_pending = value;
     } else {
         // int1 signal
         cop0.cause.int1_pending = value;
     }
+
+    UpdateInterrupts();
 }
 
 void EECore::CheckInterrupts() {
@@ -176,7 +322,7 @@ void EECore::CheckInterrupts() {
         assert(timer_enable == false);
         
         if (int0_enable && cop0.cause.int0_pending) {
-            LogFile::Get().Log("[EE] do int0 interrupt\n");
+            log_channel(LogChannel::EE, LogLevel::Debug, "[EE] do int0 interrupt\n");
             DoException(0x80000200, ExceptionType::Interrupt);
             return;
         }
@@ -184,7 +330,7 @@ void EECore::CheckInterrupts() {
         bool int1_enable = (cop0.gpr[12] >> 11) & 0x1;
         
         if (int1_enable && cop0.cause.int1_pending) {
-            LogFile::Get().Log("[EE] do int1 interrupt\n");
+            log_channel(LogChannel::EE, LogLevel::Debug, "[EE] do int1 interrupt\n");
             DoException(0x80000200, ExceptionType::Interrupt);
             return;
         }
@@ -193,6 +339,13 @@ void EECore::CheckInterrupts() {
     }
 }
 
+void EECore::UpdateInterrupts() {
+    bool int0_enable = (cop0.gpr[12] >> 10) & 0x1;
+    bool int1_enable = (cop0.gpr[12] >> 11) & 0x1;
+
+    interrupt_pending = InterruptsEnabled() && ((int0_enable && cop0.cause.int0_pending) || (int1_enable && cop0.cause.int1_pending));
+}
+
 bool EECore::InterruptsEnabled() {
     bool ie = cop0.gpr[12] & 0x1;
     bool eie = (cop0.gpr[12] >> 16) & 0x1;
@@ -203,14 +356,14 @@ bool EECore::InterruptsEnabled() {
 }
 
 void EECore::PrintState() {
-    LogFile::Get().Log("[EE State]\n");
+    log_channel(LogChannel::EE, LogLevel::Info, "[EE State]\n");
     for (int i = 0; i < 32; i++) {
-        LogFile::Get().Log("%s: %016lx%016lx\n", EEGetRegisterName(i).c_str(), GetReg<u128>(i).i.hi, GetReg<u128>(i).i.lo);
+        log_channel(LogChannel::EE, LogLevel::Info, "%s: %016lx%016lx\n", EEGetRegisterName(i).c_str(), GetReg<u128>(i).i.hi, GetReg<u128>(i).i.lo);
     }
 
-    LogFile::Get().Log("pc: %08x npc: %08x\n", pc, next_pc);
-    LogFile::Get().Log("branch: %d branch delay: %d\n", branch, branch_delay);
-    LogFile::Get().Log("%s\n", EEDisassembleInstruction(inst, pc).c_str());
+    log_channel(LogChannel::EE, LogLevel::Info, "pc: %08x npc: %08x\n", pc, next_pc);
+    log_channel(LogChannel::EE, LogLevel::Info, "branch: %d branch delay: %d\n", branch, branch_delay);
+    log_channel(LogChannel::EE, LogLevel::Info, "%s\n", EEDisassembleInstruction(inst, pc).c_str());
 }
 
 std::string EECore::GetSyscallInfo(int index) {
@@ -224,5 +377,5 @@ std::string EECore::GetSyscallInfo(int index) {
 }
 
 void EECore::LogInstruction() {
-    LogFile::Get().Log("[EE] %08x %08x %s\n", pc, inst.data, EEDisassembleInstruction(inst, pc).c_str());
+    log_channel(LogChannel::EE, LogLevel::Trace, "[EE] %08x %08x %s\n", pc, inst.data, EEDisassembleInstruction(inst, pc).c_str());
 }
\ No newline at end of file
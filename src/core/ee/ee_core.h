@@ -1,14 +1,20 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include "common/types.h"
 #include "common/cpu_types.h"
 #include "common/int128.h"
 #include "core/ee/cop0.h"
 #include "core/ee/cop1.h"
+#include "core/ee/tlb.h"
 #include "core/ee/interpreter_table.h"
+#include "core/idle_loop_detector.h"
 
 class System;
+class EECachedInterpreter;
+class EEJIT;
+class EEThreadedInterpreter;
 
 enum class ExceptionType : int {
     Interrupt = 0,
@@ -34,9 +40,37 @@ enum class ExceptionType : int {
 class EECore {
 public:
     EECore(System& system);
+    ~EECore();
 
     void Reset();
     void Run(int cycles);
+    void SetCoreType(CoreType type);
+
+    // throws away any code that the backend has cached from the page of paddr
+    void InvalidateCode(u32 paddr);
+
+    // called after the tlb changes, so that backends
+    // drop any translations they have cached
+    void InvalidateTranslations();
+
+    // accounts for cycles that the core didn't run while in an idle loop
+    void SkipIdleCycles(int cycles);
+
+    // for block based backends, which find idle loops when they compile them. checks that
+    // the loop's loads only go to state that an interrupt has to change, given the registers
+    // after an iteration, and if so marks the core as idle
+    void CheckIdleLoop(u32 start, const std::vector<CPUInstruction>& code);
+
+    // the time in ee cycles that the core has run up to. this can be ahead
+    // of the scheduler while in the middle of a slice
+    u64 GetCurrentTime();
+
+    // executes a single instruction, along with handling
+    // the branch delay slot and interrupts
+    void InterpretInstruction();
+
+    // moves on from a branch once its delay slot has been executed
+    void UpdateBranchDelay();
 
     // credit goes to DobieStation for the elegant way of accessing 128 bit registers
     template <typename T>
@@ -78,6 +112,7 @@ public:
     void DoException(u32 target, ExceptionType exception);
     void SendInterruptSignal(int signal, bool value);
     void CheckInterrupts();
+    void UpdateInterrupts();
     bool InterruptsEnabled();
     void PrintState();
     std::string GetSyscallInfo(int index);
@@ -95,9 +130,30 @@ public:
     System& system;
     EECOP0 cop0;
     EECOP1 cop1;
+    EETLB tlb;
     bool branch_delay = false;
     bool branch = false;
     CPUInstruction inst;
     InterpreterTable interpreter_table;
     bool debug = false;
+
+    // cycles left to run in the current slice. this can go negative when a
+    // block overruns, in which case it's taken off the next slice
+    int cycles_left = 0;
+    int slice_cycles = 0;
+
+    // set when an interrupt is able to be taken, so that we only
+    // need to check for one after something changes
+    bool interrupt_pending = false;
+
+    CoreType core_type = CoreType::Interpreter;
+    std::unique_ptr<EECachedInterpreter> cached_interpreter;
+    std::unique_ptr<EEJIT> jit;
+    std::unique_ptr<EEThreadedInterpreter> threaded_interpreter;
+
+    IdleLoopDetector idle_loop_detector;
+
+    // set when the core stopped running because it's stuck in an idle loop.
+    // any change to the interrupt signals clears it, and so does sif0 dma writing to ram
+    bool idle = false;
 };
\ No newline at end of file
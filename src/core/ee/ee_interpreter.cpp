@@ -15,19 +15,16 @@ void EEInterpreter::mtc0(EECore& cpu, CPUInstruction inst) {
 }
 
 // COP1 instructions
-// TODO: do instruction execution in the cop1
 void EEInterpreter::swc1(EECore& cpu, CPUInstruction inst) {
     cpu.WriteWord(cpu.GetReg<u32>(inst.rs) + inst.simm, cpu.cop1.GetReg(inst.rt));
 }
 
-void EEInterpreter::mtc1(EECore& cpu, CPUInstruction inst) {
-    cpu.cop1.SetReg(inst.rd, cpu.GetReg<u32>(inst.rt));
+void EEInterpreter::mfc1(EECore& cpu, CPUInstruction inst) {
+    cpu.SetReg<s64>(inst.rt, static_cast<s32>(cpu.cop1.GetReg(inst.rd)));
 }
 
-void EEInterpreter::adda_s(EECore& cpu, CPUInstruction inst) {
-    cpu.cop1.accumulator.f = cpu.cop1.AsFloat(cpu.cop1.GetReg(inst.rd)) + cpu.cop1.AsFloat(cpu.cop1.GetReg(inst.rt));
-
-    // TODO: handle overflows and underflows
+void EEInterpreter::mtc1(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.rd, cpu.GetReg<u32>(inst.rt));
 }
 
 void EEInterpreter::ctc1(EECore& cpu, CPUInstruction inst) {
@@ -45,14 +42,18 @@ void EEInterpreter::cfc1(EECore& cpu, CPUInstruction inst) {
     }
 }
 
-void EEInterpreter::madd_s(EECore& cpu, CPUInstruction inst) {
-    float fs = cpu.cop1.AsFloat(cpu.cop1.GetReg(inst.rd));
-    float ft = cpu.cop1.AsFloat(cpu.cop1.GetReg(inst.rt));
-    float acc = cpu.cop1.AsFloat(cpu.cop1.accumulator.u);
-
-    cpu.cop1.SetReg(inst.imm5, acc + (fs * ft));
+void EEInterpreter::bc1(EECore& cpu, CPUInstruction inst) {
+    // rt selects between bc1f, bc1t, bc1fl and bc1tl
+    bool condition = cpu.cop1.GetCondition() == (inst.rt & 0x1);
+    bool likely = inst.rt & 0x2;
+    s32 offset = inst.simm << 2;
 
-    // TODO: handle overflows and underflows
+    if (condition) {
+        cpu.next_pc = cpu.pc + offset + 4;
+        cpu.branch_delay = true;
+    } else if (likely) {
+        cpu.pc += 4;
+    }
 }
 
 void EEInterpreter::lwc1(EECore& cpu, CPUInstruction inst) {
@@ -65,6 +66,107 @@ void EEInterpreter::lwc1(EECore& cpu, CPUInstruction inst) {
     cpu.cop1.SetReg(inst.rt, cpu.ReadWord(addr));
 }
 
+// FPU.S instructions
+// fs is in rd and fd is in imm5
+void EEInterpreter::add_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Add(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::sub_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Sub(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::mul_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Mul(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::div_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Div(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::sqrt_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Sqrt(cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::abs_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.GetReg(inst.rd) & 0x7FFFFFFF);
+}
+
+void EEInterpreter::mov_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.GetReg(inst.rd));
+}
+
+void EEInterpreter::neg_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.GetReg(inst.rd) ^ 0x80000000);
+}
+
+void EEInterpreter::rsqrt_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.RSqrt(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::adda_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.accumulator.u = cpu.cop1.Add(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+}
+
+void EEInterpreter::suba_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.accumulator.u = cpu.cop1.Sub(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+}
+
+void EEInterpreter::mula_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.accumulator.u = cpu.cop1.Mul(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+}
+
+void EEInterpreter::madd_s(EECore& cpu, CPUInstruction inst) {
+    u32 result = cpu.cop1.MultiplyAdd(cpu.cop1.accumulator.u, cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+    cpu.cop1.SetReg(inst.imm5, result);
+}
+
+void EEInterpreter::msub_s(EECore& cpu, CPUInstruction inst) {
+    u32 result = cpu.cop1.MultiplySubtract(cpu.cop1.accumulator.u, cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+    cpu.cop1.SetReg(inst.imm5, result);
+}
+
+void EEInterpreter::madda_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.accumulator.u = cpu.cop1.MultiplyAdd(cpu.cop1.accumulator.u, cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+}
+
+void EEInterpreter::msuba_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.accumulator.u = cpu.cop1.MultiplySubtract(cpu.cop1.accumulator.u, cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt));
+}
+
+void EEInterpreter::cvt_w_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.ConvertToWord(cpu.cop1.GetReg(inst.rd)));
+}
+
+void EEInterpreter::max_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Max(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::min_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.Min(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::c_f_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetCondition(false);
+}
+
+void EEInterpreter::c_eq_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetCondition(cpu.cop1.Equal(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::c_lt_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetCondition(cpu.cop1.LessThan(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+void EEInterpreter::c_le_s(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetCondition(cpu.cop1.LessThanOrEqual(cpu.cop1.GetReg(inst.rd), cpu.cop1.GetReg(inst.rt)));
+}
+
+// FPU.W instructions
+void EEInterpreter::cvt_s_w(EECore& cpu, CPUInstruction inst) {
+    cpu.cop1.SetReg(inst.imm5, cpu.cop1.ConvertToSingle(cpu.cop1.GetReg(inst.rd)));
+}
+
 // COP2 instructions
 void EEInterpreter::cfc2(EECore& cpu, CPUInstruction inst) {
     // handle vu stuff
@@ -90,37 +192,65 @@ void EEInterpreter::mflo1(EECore& cpu, CPUInstruction inst) {
 }
 
 void EEInterpreter::mult1(EECore& cpu, CPUInstruction inst) {
-    s64 result = cpu.GetReg<s32>(inst.rt) * cpu.GetReg<s32>(inst.rs);
+    s64 result = static_cast<s64>(cpu.GetReg<s32>(inst.rt)) * cpu.GetReg<s32>(inst.rs);
     cpu.lo1 = sign_extend<s64, 32>(result & 0xFFFFFFFF);
     cpu.hi1 = sign_extend<s64, 32>(result >> 32);
     cpu.SetReg<u64>(inst.rd, cpu.lo1);
 }
 
-void EEInterpreter::por(EECore& cpu, CPUInstruction inst) {
-    cpu.SetReg<u128>(inst.rd, cpu.GetReg<u128>(inst.rs) | cpu.GetReg<u128>(inst.rt));
+void EEInterpreter::multu1(EECore& cpu, CPUInstruction inst) {
+    u64 result = static_cast<u64>(cpu.GetReg<u32>(inst.rt)) * cpu.GetReg<u32>(inst.rs);
+    cpu.lo1 = sign_extend<s64, 32>(result & 0xFFFFFFFF);
+    cpu.hi1 = sign_extend<s64, 32>(result >> 32);
+    cpu.SetReg<u64>(inst.rd, cpu.lo1);
 }
 
-void EEInterpreter::padduw(EECore& cpu, CPUInstruction inst) {
-    for (int i = 0; i < 4; i++) {
-        u64 result = cpu.GetReg<u32>(inst.rs, i) + cpu.GetReg<u32>(inst.rt, i);
+void EEInterpreter::div1(EECore& cpu, CPUInstruction inst) {
+    s32 dividend = cpu.GetReg<s32>(inst.rs);
+    s32 divisor = cpu.GetReg<s32>(inst.rt);
 
-        if (result > 0xFFFFFFFF) {
-            cpu.SetReg<u32>(inst.rd, 0xFFFFFFFF, i);
-        } else {
-            cpu.SetReg<u32>(inst.rd, result);
-        }
+    if (divisor == 0) {
+        cpu.lo1 = dividend < 0 ? 1 : 0xFFFFFFFFFFFFFFFF;
+        cpu.hi1 = sign_extend<s64, 32>(dividend);
+    } else if (dividend == static_cast<s32>(0x80000000) && divisor == -1) {
+        cpu.lo1 = sign_extend<s64, 32>(0x80000000);
+        cpu.hi1 = 0;
+    } else {
+        cpu.lo1 = sign_extend<s64, 32>(dividend / divisor);
+        cpu.hi1 = sign_extend<s64, 32>(dividend % divisor);
     }
 }
 
-void EEInterpreter::mfhi1(EECore& cpu, CPUInstruction inst) {
-    cpu.SetReg<u64>(inst.rd, cpu.hi1);
+void EEInterpreter::madd(EECore& cpu, CPUInstruction inst) {
+    s64 result = static_cast<s64>((cpu.hi << 32) | (cpu.lo & 0xFFFFFFFF)) + static_cast<s64>(cpu.GetReg<s32>(inst.rs)) * cpu.GetReg<s32>(inst.rt);
+    cpu.lo = sign_extend<s64, 32>(result & 0xFFFFFFFF);
+    cpu.hi = sign_extend<s64, 32>(result >> 32);
+    cpu.SetReg<u64>(inst.rd, cpu.lo);
 }
 
-void EEInterpreter::plzcw(EECore& cpu, CPUInstruction inst) {
-    for (int i = 0; i < 2; i++) {
-        u32 data = cpu.GetReg<u32>(inst.rs, i);
-        cpu.SetReg<u32>(inst.rd, CountLeadingSignBits(data) - 1, i);
-    }
+void EEInterpreter::maddu(EECore& cpu, CPUInstruction inst) {
+    u64 result = ((cpu.hi << 32) | (cpu.lo & 0xFFFFFFFF)) + static_cast<u64>(cpu.GetReg<u32>(inst.rs)) * cpu.GetReg<u32>(inst.rt);
+    cpu.lo = sign_extend<s64, 32>(result & 0xFFFFFFFF);
+    cpu.hi = sign_extend<s64, 32>(result >> 32);
+    cpu.SetReg<u64>(inst.rd, cpu.lo);
+}
+
+void EEInterpreter::madd1(EECore& cpu, CPUInstruction inst) {
+    s64 result = static_cast<s64>((cpu.hi1 << 32) | (cpu.lo1 & 0xFFFFFFFF)) + static_cast<s64>(cpu.GetReg<s32>(inst.rs)) * cpu.GetReg<s32>(inst.rt);
+    cpu.lo1 = sign_extend<s64, 32>(result & 0xFFFFFFFF);
+    cpu.hi1 = sign_extend<s64, 32>(result >> 32);
+    cpu.SetReg<u64>(inst.rd, cpu.lo1);
+}
+
+void EEInterpreter::maddu1(EECore& cpu, CPUInstruction inst) {
+    u64 result = ((cpu.hi1 << 32) | (cpu.lo1 & 0xFFFFFFFF)) + static_cast<u64>(cpu.GetReg<u32>(inst.rs)) * cpu.GetReg<u32>(inst.rt);
+    cpu.lo1 = sign_extend<s64, 32>(result & 0xFFFFFFFF);
+    cpu.hi1 = sign_extend<s64, 32>(result >> 32);
+    cpu.SetReg<u64>(inst.rd, cpu.lo1);
+}
+
+void EEInterpreter::mfhi1(EECore& cpu, CPUInstruction inst) {
+    cpu.SetReg<u64>(inst.rd, cpu.hi1);
 }
 
 void EEInterpreter::mthi1(EECore& cpu, CPUInstruction inst) {
@@ -278,13 +408,9 @@ void EEInterpreter::sq(EECore& cpu, CPUInstruction inst) {
 }
 
 void EEInterpreter::lq(EECore& cpu, CPUInstruction inst) {
-    u128 data;
     u32 addr = (cpu.GetReg<u32>(inst.rs) + inst.simm) & ~0xF;
 
-    data.i.lo = cpu.ReadDouble(addr);
-    data.i.hi = cpu.ReadDouble(addr + 8);
-
-    cpu.SetReg<u128>(inst.rt, data);
+    cpu.SetReg<u128>(inst.rt, cpu.ReadQuad(addr));
 }
 
 void EEInterpreter::lh(EECore& cpu, CPUInstruction inst) {
@@ -402,6 +528,15 @@ void EEInterpreter::bgezl(EECore& cpu, CPUInstruction inst) {
     }
 }
 
+void EEInterpreter::mtsab(EECore& cpu, CPUInstruction inst) {
+    // sa holds a byte shift amount for qfsrv
+    cpu.sa = (cpu.GetReg<u32>(inst.rs) & 0xF) ^ (inst.imm & 0xF);
+}
+
+void EEInterpreter::mtsah(EECore& cpu, CPUInstruction inst) {
+    cpu.sa = ((cpu.GetReg<u32>(inst.rs) & 0x7) ^ (inst.imm & 0x7)) * 2;
+}
+
 // secondary instructions
 void EEInterpreter::sll(EECore& cpu, CPUInstruction inst) {
     u32 result = cpu.GetReg<u32>(inst.rt) << inst.imm5;
@@ -432,7 +567,7 @@ void EEInterpreter::orr(EECore& cpu, CPUInstruction inst) {
 }
 
 void EEInterpreter::mult(EECore& cpu, CPUInstruction inst) {
-    s64 result = cpu.GetReg<s32>(inst.rs) * cpu.GetReg<s32>(inst.rt);
+    s64 result = static_cast<s64>(cpu.GetReg<s32>(inst.rs)) * cpu.GetReg<s32>(inst.rt);
     cpu.lo = (s32)(result & 0xFFFFFFFF);
     cpu.hi = (s32)(result >> 32);
     cpu.SetReg<u64>(inst.rd, cpu.lo);
@@ -566,7 +701,7 @@ void EEInterpreter::dsrl32(EECore& cpu, CPUInstruction inst) {
 void EEInterpreter::syscall_exception(EECore& cpu, CPUInstruction inst) {
     u8 opcode = cpu.ReadByte(cpu.pc - 4);
 
-    LogFile::Get().Log("[EE] executing syscall %s\n", cpu.GetSyscallInfo(opcode).c_str());
+    log_channel(LogChannel::EE, LogLevel::Debug, "[EE] executing syscall %s\n", cpu.GetSyscallInfo(opcode).c_str());
     cpu.DoException(0x80000180, ExceptionType::Syscall);
 }
 
@@ -591,8 +726,40 @@ void EEInterpreter::mtsa(EECore& cpu, CPUInstruction inst) {
 }
 
 // tlb instructions
+void EEInterpreter::tlbr(EECore& cpu, CPUInstruction inst) {
+    EETLB::Entry entry = cpu.tlb.ReadEntry(cpu.cop0.GetReg(0) % EETLB::NUM_ENTRIES);
+
+    cpu.cop0.SetReg(5, entry.page_mask);
+    cpu.cop0.SetReg(10, entry.entry_hi);
+    cpu.cop0.SetReg(2, entry.entry_lo0);
+    cpu.cop0.SetReg(3, entry.entry_lo1);
+}
+
 void EEInterpreter::tlbwi(EECore& cpu, CPUInstruction inst) {
-    // when we handle mmu emulation the tlb will be used
+    WriteTLBEntry(cpu, cpu.cop0.GetReg(0) % EETLB::NUM_ENTRIES);
+}
+
+void EEInterpreter::tlbwr(EECore& cpu, CPUInstruction inst) {
+    WriteTLBEntry(cpu, cpu.cop0.GetRandom());
+}
+
+void EEInterpreter::tlbp(EECore& cpu, CPUInstruction inst) {
+    int index = cpu.tlb.Probe(cpu.cop0.GetReg(10));
+
+    // the top bit of index is set when there's no match
+    cpu.cop0.SetReg(0, index < 0 ? 0x80000000 : index);
+}
+
+void EEInterpreter::WriteTLBEntry(EECore& cpu, int index) {
+    EETLB::Entry entry;
+
+    entry.page_mask = cpu.cop0.GetReg(5);
+    entry.entry_hi = cpu.cop0.GetReg(10);
+    entry.entry_lo0 = cpu.cop0.GetReg(2);
+    entry.entry_lo1 = cpu.cop0.GetReg(3);
+
+    cpu.tlb.WriteEntry(index, entry);
+    cpu.InvalidateTranslations();
 }
 
 void EEInterpreter::di(EECore& cpu, CPUInstruction inst) {
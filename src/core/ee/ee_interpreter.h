@@ -103,6 +103,126 @@ namespace EEInterpreter {
     void cfc1(EECore& cpu, CPUInstruction inst);
     void madd_s(EECore& cpu, CPUInstruction inst);
     void lwc1(EECore& cpu, CPUInstruction inst);
+    void madd(EECore& cpu, CPUInstruction inst);
+    void maddu(EECore& cpu, CPUInstruction inst);
+    void madd1(EECore& cpu, CPUInstruction inst);
+    void maddu1(EECore& cpu, CPUInstruction inst);
+    void multu1(EECore& cpu, CPUInstruction inst);
+    void div1(EECore& cpu, CPUInstruction inst);
+    void mtsab(EECore& cpu, CPUInstruction inst);
+    void mtsah(EECore& cpu, CPUInstruction inst);
+    void pmfhl(EECore& cpu, CPUInstruction inst);
+    void pmthl(EECore& cpu, CPUInstruction inst);
+    void psllh(EECore& cpu, CPUInstruction inst);
+    void psrlh(EECore& cpu, CPUInstruction inst);
+    void psrah(EECore& cpu, CPUInstruction inst);
+    void psllw(EECore& cpu, CPUInstruction inst);
+    void psrlw(EECore& cpu, CPUInstruction inst);
+    void psraw(EECore& cpu, CPUInstruction inst);
+    void paddw(EECore& cpu, CPUInstruction inst);
+    void psubw(EECore& cpu, CPUInstruction inst);
+    void pcgtw(EECore& cpu, CPUInstruction inst);
+    void pmaxw(EECore& cpu, CPUInstruction inst);
+    void paddh(EECore& cpu, CPUInstruction inst);
+    void psubh(EECore& cpu, CPUInstruction inst);
+    void pcgth(EECore& cpu, CPUInstruction inst);
+    void pmaxh(EECore& cpu, CPUInstruction inst);
+    void paddb(EECore& cpu, CPUInstruction inst);
+    void psubb(EECore& cpu, CPUInstruction inst);
+    void pcgtb(EECore& cpu, CPUInstruction inst);
+    void paddsw(EECore& cpu, CPUInstruction inst);
+    void psubsw(EECore& cpu, CPUInstruction inst);
+    void pextlw(EECore& cpu, CPUInstruction inst);
+    void ppacw(EECore& cpu, CPUInstruction inst);
+    void paddsh(EECore& cpu, CPUInstruction inst);
+    void psubsh(EECore& cpu, CPUInstruction inst);
+    void pextlh(EECore& cpu, CPUInstruction inst);
+    void ppach(EECore& cpu, CPUInstruction inst);
+    void paddsb(EECore& cpu, CPUInstruction inst);
+    void psubsb(EECore& cpu, CPUInstruction inst);
+    void pextlb(EECore& cpu, CPUInstruction inst);
+    void ppacb(EECore& cpu, CPUInstruction inst);
+    void pext5(EECore& cpu, CPUInstruction inst);
+    void ppac5(EECore& cpu, CPUInstruction inst);
+    void pabsw(EECore& cpu, CPUInstruction inst);
+    void pceqw(EECore& cpu, CPUInstruction inst);
+    void pminw(EECore& cpu, CPUInstruction inst);
+    void padsbh(EECore& cpu, CPUInstruction inst);
+    void pabsh(EECore& cpu, CPUInstruction inst);
+    void pceqh(EECore& cpu, CPUInstruction inst);
+    void pminh(EECore& cpu, CPUInstruction inst);
+    void pceqb(EECore& cpu, CPUInstruction inst);
+    void psubuw(EECore& cpu, CPUInstruction inst);
+    void pextuw(EECore& cpu, CPUInstruction inst);
+    void padduh(EECore& cpu, CPUInstruction inst);
+    void psubuh(EECore& cpu, CPUInstruction inst);
+    void pextuh(EECore& cpu, CPUInstruction inst);
+    void paddub(EECore& cpu, CPUInstruction inst);
+    void psubub(EECore& cpu, CPUInstruction inst);
+    void pextub(EECore& cpu, CPUInstruction inst);
+    void qfsrv(EECore& cpu, CPUInstruction inst);
+    void pmaddw(EECore& cpu, CPUInstruction inst);
+    void psllvw(EECore& cpu, CPUInstruction inst);
+    void psrlvw(EECore& cpu, CPUInstruction inst);
+    void pmsubw(EECore& cpu, CPUInstruction inst);
+    void pmfhi(EECore& cpu, CPUInstruction inst);
+    void pmflo(EECore& cpu, CPUInstruction inst);
+    void pinth(EECore& cpu, CPUInstruction inst);
+    void pmultw(EECore& cpu, CPUInstruction inst);
+    void pdivw(EECore& cpu, CPUInstruction inst);
+    void pcpyld(EECore& cpu, CPUInstruction inst);
+    void pmaddh(EECore& cpu, CPUInstruction inst);
+    void phmadh(EECore& cpu, CPUInstruction inst);
+    void pand(EECore& cpu, CPUInstruction inst);
+    void pxor(EECore& cpu, CPUInstruction inst);
+    void pmsubh(EECore& cpu, CPUInstruction inst);
+    void phmsbh(EECore& cpu, CPUInstruction inst);
+    void pexeh(EECore& cpu, CPUInstruction inst);
+    void prevh(EECore& cpu, CPUInstruction inst);
+    void pmulth(EECore& cpu, CPUInstruction inst);
+    void pdivbw(EECore& cpu, CPUInstruction inst);
+    void pexew(EECore& cpu, CPUInstruction inst);
+    void prot3w(EECore& cpu, CPUInstruction inst);
+    void pmadduw(EECore& cpu, CPUInstruction inst);
+    void psravw(EECore& cpu, CPUInstruction inst);
+    void pmthi(EECore& cpu, CPUInstruction inst);
+    void pmtlo(EECore& cpu, CPUInstruction inst);
+    void pinteh(EECore& cpu, CPUInstruction inst);
+    void pmultuw(EECore& cpu, CPUInstruction inst);
+    void pdivuw(EECore& cpu, CPUInstruction inst);
+    void pcpyud(EECore& cpu, CPUInstruction inst);
+    void pnor(EECore& cpu, CPUInstruction inst);
+    void pexch(EECore& cpu, CPUInstruction inst);
+    void pcpyh(EECore& cpu, CPUInstruction inst);
+    void pexcw(EECore& cpu, CPUInstruction inst);
+    void mfc1(EECore& cpu, CPUInstruction inst);
+    void bc1(EECore& cpu, CPUInstruction inst);
+    void add_s(EECore& cpu, CPUInstruction inst);
+    void sub_s(EECore& cpu, CPUInstruction inst);
+    void mul_s(EECore& cpu, CPUInstruction inst);
+    void div_s(EECore& cpu, CPUInstruction inst);
+    void sqrt_s(EECore& cpu, CPUInstruction inst);
+    void abs_s(EECore& cpu, CPUInstruction inst);
+    void mov_s(EECore& cpu, CPUInstruction inst);
+    void neg_s(EECore& cpu, CPUInstruction inst);
+    void rsqrt_s(EECore& cpu, CPUInstruction inst);
+    void suba_s(EECore& cpu, CPUInstruction inst);
+    void mula_s(EECore& cpu, CPUInstruction inst);
+    void msub_s(EECore& cpu, CPUInstruction inst);
+    void madda_s(EECore& cpu, CPUInstruction inst);
+    void msuba_s(EECore& cpu, CPUInstruction inst);
+    void cvt_w_s(EECore& cpu, CPUInstruction inst);
+    void max_s(EECore& cpu, CPUInstruction inst);
+    void min_s(EECore& cpu, CPUInstruction inst);
+    void c_f_s(EECore& cpu, CPUInstruction inst);
+    void c_eq_s(EECore& cpu, CPUInstruction inst);
+    void c_lt_s(EECore& cpu, CPUInstruction inst);
+    void c_le_s(EECore& cpu, CPUInstruction inst);
+    void cvt_s_w(EECore& cpu, CPUInstruction inst);
+    void tlbr(EECore& cpu, CPUInstruction inst);
+    void tlbwr(EECore& cpu, CPUInstruction inst);
+    void tlbp(EECore& cpu, CPUInstruction inst);
+    void WriteTLBEntry(EECore& cpu, int index);
     void unknown_instruction(EECore& cpu, CPUInstruction inst);
     void stub_instruction(EECore& cpu, CPUInstruction inst);
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "core/ee/instruction_info.h"
+#include "core/idle_loop_detector.h"
+
+bool EEIsBranch(CPUInstruction inst) {
+    switch (inst.opcode) {
+    case 0:
+        // jr and jalr
+        return inst.func == 8 || inst.func == 9;
+    case 1:
+        // bltz, bgez, bltzl, bgezl and their linking variants
+        return (inst.rt & 0xC) == 0;
+    case 2: case 3: case 4: case 5: case 6: case 7:
+    case 20: case 21: case 22: case 23:
+        return true;
+    case 16: case 17: case 18:
+        // bc0, bc1 and bc2
+        return inst.rs == 8;
+    }
+
+    return false;
+}
+
+bool EEIsLikelyBranch(CPUInstruction inst) {
+    switch (inst.opcode) {
+    case 1:
+        return ((inst.rt & 0xC) == 0) && (inst.rt & 0x2);
+    case 20: case 21: case 22: case 23:
+        return true;
+    case 16: case 17: case 18:
+        return (inst.rs == 8) && (inst.rt & 0x2);
+    }
+
+    return false;
+}
+
+bool EEIsBlockTerminator(CPUInstruction inst) {
+    switch (inst.opcode) {
+    case 0:
+        // syscall and break
+        return inst.func == 12 || inst.func == 13;
+    case 16:
+        // mtc0 can enable interrupts through status
+        if (inst.rs == 4) {
+            return true;
+        }
+
+        // tlbwi, eret, ei and di
+        return inst.rs == 16;
+    }
+
+    return false;
+}
+
+bool EEIsIdleLoop(u32 pc, const std::vector<CPUInstruction>& code) {
+    if (code.size() < 2) {
+        return false;
+    }
+
+    CPUInstruction inst = code[code.size() - 2];
+    u32 branch_pc = pc + (code.size() - 2) * 4;
+    u32 target = 0;
+
+    if (!EEIsBranch(inst)) {
+        return false;
+    }
+
+    switch (inst.opcode) {
+    case 0: case 16: case 17: case 18:
+        // jumps to registers and coprocessor branches
+        return false;
+    case 2: case 3:
+        target = ((branch_pc + 4) & 0xF0000000) + (inst.offset << 2);
+        break;
+    default:
+        target = branch_pc + (inst.simm << 2) + 4;
+        break;
+    }
+
+    return target == pc && IdleLoopDetector::AnalyseLoop(code);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+#include "common/types.h"
+#include "common/cpu_types.h"
+
+// helpers used by the block based backends to find
+// where a basic block should end
+
+// true for any branch or jump, which means the
+// instruction after it is a delay slot
+bool EEIsBranch(CPUInstruction inst);
+
+// likely branches skip their delay slot when not taken
+bool EEIsLikelyBranch(CPUInstruction inst);
+
+// instructions which can raise an exception or change the
+// interrupt state. execution has to go back to the dispatcher
+// after these so that pc and interrupts can be handled
+bool EEIsBlockTerminator(CPUInstruction inst);
+
+// code starts at pc and ends with a branch and its delay slot.
+// returns true if it's an idle loop which branches back to pc
+bool EEIsIdleLoop(u32 pc, const std::vector<CPUInstruction>& code);
\ No newline at end of file
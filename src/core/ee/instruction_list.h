@@ -0,0 +1,240 @@
+#pragma once
+
+// every instruction that the ee interpreter implements, as
+// X(handler, table, index). this is shared between building the handler
+// table and the threaded interpreter, which needs to know each handler
+// at compile time
+#define EE_INSTRUCTION_LIST(X) \
+    /* primary instructions */ \
+    X(j, Primary, 2) \
+    X(jal, Primary, 3) \
+    X(beq, Primary, 4) \
+    X(bne, Primary, 5) \
+    X(blez, Primary, 6) \
+    X(bgtz, Primary, 7) \
+    X(addiu, Primary, 9) \
+    X(slti, Primary, 10) \
+    X(sltiu, Primary, 11) \
+    X(andi, Primary, 12) \
+    X(ori, Primary, 13) \
+    X(xori, Primary, 14) \
+    X(lui, Primary, 15) \
+    X(beql, Primary, 20) \
+    X(bnel, Primary, 21) \
+    X(daddiu, Primary, 25) \
+    X(ldl, Primary, 26) \
+    X(ldr, Primary, 27) \
+    X(lq, Primary, 30) \
+    X(sq, Primary, 31) \
+    X(lb, Primary, 32) \
+    X(lh, Primary, 33) \
+    X(lw, Primary, 35) \
+    X(lbu, Primary, 36) \
+    X(lhu, Primary, 37) \
+    X(lwu, Primary, 39) \
+    X(sb, Primary, 40) \
+    X(sh, Primary, 41) \
+    X(sw, Primary, 43) \
+    X(sdl, Primary, 44) \
+    X(sdr, Primary, 45) \
+    X(cache, Primary, 47) \
+    X(lwc1, Primary, 49) \
+    X(ld, Primary, 55) \
+    X(swc1, Primary, 57) \
+    X(sd, Primary, 63) \
+    /* secondary instructions */ \
+    X(sll, Secondary, 0) \
+    X(srl, Secondary, 2) \
+    X(sra, Secondary, 3) \
+    X(sllv, Secondary, 4) \
+    X(srlv, Secondary, 6) \
+    X(srav, Secondary, 7) \
+    X(jr, Secondary, 8) \
+    X(jalr, Secondary, 9) \
+    X(movz, Secondary, 10) \
+    X(movn, Secondary, 11) \
+    X(syscall_exception, Secondary, 12) \
+    X(break_exception, Secondary, 13) \
+    X(sync, Secondary, 15) \
+    X(mfhi, Secondary, 16) \
+    X(mthi, Secondary, 17) \
+    X(mflo, Secondary, 18) \
+    X(mtlo, Secondary, 19) \
+    X(dsllv, Secondary, 20) \
+    X(dsrav, Secondary, 23) \
+    X(mult, Secondary, 24) \
+    X(div, Secondary, 26) \
+    X(divu, Secondary, 27) \
+    X(addu, Secondary, 33) \
+    X(subu, Secondary, 35) \
+    X(andd, Secondary, 36) \
+    X(orr, Secondary, 37) \
+    X(nor, Secondary, 39) \
+    X(mfsa, Secondary, 40) \
+    X(mtsa, Secondary, 41) \
+    X(slt, Secondary, 42) \
+    X(sltu, Secondary, 43) \
+    X(daddu, Secondary, 45) \
+    X(dsubu, Secondary, 47) \
+    X(dsll, Secondary, 56) \
+    X(dsrl, Secondary, 58) \
+    X(dsll32, Secondary, 60) \
+    X(dsrl32, Secondary, 62) \
+    X(dsra32, Secondary, 63) \
+    /* regimm instructions */ \
+    X(bltz, RegImm, 0) \
+    X(bgez, RegImm, 1) \
+    X(bltzl, RegImm, 2) \
+    X(bgezl, RegImm, 3) \
+    X(mtsab, RegImm, 24) \
+    X(mtsah, RegImm, 25) \
+    /* cop0 instructions */ \
+    X(mfc0, COP0, 0) \
+    X(mtc0, COP0, 4) \
+    /* cop1 instructions */ \
+    X(mfc1, COP1, 0) \
+    X(cfc1, COP1, 2) \
+    X(mtc1, COP1, 4) \
+    X(ctc1, COP1, 6) \
+    X(bc1, COP1, 8) \
+    /* fpu_s instructions */ \
+    X(add_s, FPUS, 0) \
+    X(sub_s, FPUS, 1) \
+    X(mul_s, FPUS, 2) \
+    X(div_s, FPUS, 3) \
+    X(sqrt_s, FPUS, 4) \
+    X(abs_s, FPUS, 5) \
+    X(mov_s, FPUS, 6) \
+    X(neg_s, FPUS, 7) \
+    X(rsqrt_s, FPUS, 22) \
+    X(adda_s, FPUS, 24) \
+    X(suba_s, FPUS, 25) \
+    X(mula_s, FPUS, 26) \
+    X(madd_s, FPUS, 28) \
+    X(msub_s, FPUS, 29) \
+    X(madda_s, FPUS, 30) \
+    X(msuba_s, FPUS, 31) \
+    X(cvt_w_s, FPUS, 36) \
+    X(max_s, FPUS, 40) \
+    X(min_s, FPUS, 41) \
+    X(c_f_s, FPUS, 48) \
+    X(c_eq_s, FPUS, 50) \
+    X(c_lt_s, FPUS, 52) \
+    X(c_le_s, FPUS, 54) \
+    /* fpu_w instructions */ \
+    X(cvt_s_w, FPUW, 32) \
+    /* cop2 instructions */ \
+    X(cfc2, COP2, 2) \
+    X(ctc2, COP2, 6) \
+    /* tlb instructions */ \
+    X(tlbr, TLB, 1) \
+    X(tlbwi, TLB, 2) \
+    X(tlbwr, TLB, 6) \
+    X(tlbp, TLB, 8) \
+    X(eret, TLB, 24) \
+    X(ei, TLB, 56) \
+    X(di, TLB, 57) \
+    /* mmi instructions */ \
+    X(madd, MMI, 0) \
+    X(maddu, MMI, 1) \
+    X(plzcw, MMI, 4) \
+    X(mfhi1, MMI, 16) \
+    X(mthi1, MMI, 17) \
+    X(mflo1, MMI, 18) \
+    X(mtlo1, MMI, 19) \
+    X(mult1, MMI, 24) \
+    X(multu1, MMI, 25) \
+    X(div1, MMI, 26) \
+    X(divu1, MMI, 27) \
+    X(madd1, MMI, 32) \
+    X(maddu1, MMI, 33) \
+    X(pmfhl, MMI, 48) \
+    X(pmthl, MMI, 49) \
+    X(psllh, MMI, 52) \
+    X(psrlh, MMI, 54) \
+    X(psrah, MMI, 55) \
+    X(psllw, MMI, 60) \
+    X(psrlw, MMI, 62) \
+    X(psraw, MMI, 63) \
+    /* mmi0 instructions */ \
+    X(paddw, MMI0, 0) \
+    X(psubw, MMI0, 1) \
+    X(pcgtw, MMI0, 2) \
+    X(pmaxw, MMI0, 3) \
+    X(paddh, MMI0, 4) \
+    X(psubh, MMI0, 5) \
+    X(pcgth, MMI0, 6) \
+    X(pmaxh, MMI0, 7) \
+    X(paddb, MMI0, 8) \
+    X(psubb, MMI0, 9) \
+    X(pcgtb, MMI0, 10) \
+    X(paddsw, MMI0, 16) \
+    X(psubsw, MMI0, 17) \
+    X(pextlw, MMI0, 18) \
+    X(ppacw, MMI0, 19) \
+    X(paddsh, MMI0, 20) \
+    X(psubsh, MMI0, 21) \
+    X(pextlh, MMI0, 22) \
+    X(ppach, MMI0, 23) \
+    X(paddsb, MMI0, 24) \
+    X(psubsb, MMI0, 25) \
+    X(pextlb, MMI0, 26) \
+    X(ppacb, MMI0, 27) \
+    X(pext5, MMI0, 30) \
+    X(ppac5, MMI0, 31) \
+    /* mmi1 instructions */ \
+    X(pabsw, MMI1, 1) \
+    X(pceqw, MMI1, 2) \
+    X(pminw, MMI1, 3) \
+    X(padsbh, MMI1, 4) \
+    X(pabsh, MMI1, 5) \
+    X(pceqh, MMI1, 6) \
+    X(pminh, MMI1, 7) \
+    X(pceqb, MMI1, 10) \
+    X(padduw, MMI1, 16) \
+    X(psubuw, MMI1, 17) \
+    X(pextuw, MMI1, 18) \
+    X(padduh, MMI1, 20) \
+    X(psubuh, MMI1, 21) \
+    X(pextuh, MMI1, 22) \
+    X(paddub, MMI1, 24) \
+    X(psubub, MMI1, 25) \
+    X(pextub, MMI1, 26) \
+    X(qfsrv, MMI1, 27) \
+    /* mmi2 instructions */ \
+    X(pmaddw, MMI2, 0) \
+    X(psllvw, MMI2, 2) \
+    X(psrlvw, MMI2, 3) \
+    X(pmsubw, MMI2, 4) \
+    X(pmfhi, MMI2, 8) \
+    X(pmflo, MMI2, 9) \
+    X(pinth, MMI2, 10) \
+    X(pmultw, MMI2, 12) \
+    X(pdivw, MMI2, 13) \
+    X(pcpyld, MMI2, 14) \
+    X(pmaddh, MMI2, 16) \
+    X(phmadh, MMI2, 17) \
+    X(pand, MMI2, 18) \
+    X(pxor, MMI2, 19) \
+    X(pmsubh, MMI2, 20) \
+    X(phmsbh, MMI2, 21) \
+    X(pexeh, MMI2, 26) \
+    X(prevh, MMI2, 27) \
+    X(pmulth, MMI2, 28) \
+    X(pdivbw, MMI2, 29) \
+    X(pexew, MMI2, 30) \
+    X(prot3w, MMI2, 31) \
+    /* mmi3 instructions */ \
+    X(pmadduw, MMI3, 0) \
+    X(psravw, MMI3, 3) \
+    X(pmthi, MMI3, 8) \
+    X(pmtlo, MMI3, 9) \
+    X(pinteh, MMI3, 10) \
+    X(pmultuw, MMI3, 12) \
+    X(pdivuw, MMI3, 13) \
+    X(pcpyud, MMI3, 14) \
+    X(por, MMI3, 18) \
+    X(pnor, MMI3, 19) \
+    X(pexch, MMI3, 26) \
+    X(pcpyh, MMI3, 27) \
+    X(pexcw, MMI3, 30)
@@ -1,3 +1,5 @@
+#include "common/log_file.h"
+#include "common/tracer.h"
 #include "core/ee/intc.h"
 #include "core/system.h"
 
@@ -11,21 +13,21 @@ void EEINTC::Reset() {
 }
 
 u16 EEINTC::ReadMask() {
-    log_warn("[INTC] read mask %04x", mask);
+    log_channel(LogChannel::INTC, LogLevel::Trace, "[INTC] read mask %04x\n", mask);
     return mask;
 }
 
 // a bit set to 1 in stat means
 // an irq was raised
 u16 EEINTC::ReadStat() {
-    log_warn("[INTC] read stat %04x", stat);
+    log_channel(LogChannel::INTC, LogLevel::Trace, "[INTC] read stat %04x\n", stat);
     return stat;
 }
 
 // writing 1 to mask reverses a bit
 // while writing 0 has no effect
 void EEINTC::WriteMask(u16 data) {
-    log_warn("[INTC] write mask %04x", data);
+    log_channel(LogChannel::INTC, LogLevel::Debug, "[INTC] write mask %04x\n", data);
     mask ^= (data & 0x7FFF);
     CheckInterruptSignal();
 }
@@ -33,7 +35,7 @@ void EEINTC::WriteMask(u16 data) {
 // writing the bit 1 to stat clears an interrupt
 // while writing 0 has no effect
 void EEINTC::WriteStat(u16 data) {
-    log_warn("[INTC] write stat %04x", data);
+    log_channel(LogChannel::INTC, LogLevel::Debug, "[INTC] write stat %04x\n", data);
     stat &= ~(data & 0x7FFF);
     CheckInterruptSignal();
 }
@@ -44,6 +46,7 @@ void EEINTC::CheckInterruptSignal() {
 }
 
 void EEINTC::RequestInterrupt(EEInterruptSource interrupt) {
+    trace_instant("interrupt", "EE Interrupt", static_cast<u64>(interrupt));
     stat |= (1 << static_cast<int>(interrupt));
     CheckInterruptSignal();
 }
\ No newline at end of file
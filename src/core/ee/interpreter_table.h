@@ -14,17 +14,50 @@ public:
     void Execute(EECore& cpu, CPUInstruction inst);
     void RegisterOpcode(InterpreterInstruction handler, int index, InstructionTable table);
 
+    // all of the tables are flattened into one, so that any instruction
+    // can be dispatched with a single lookup
+    static constexpr int GetTableOffset(InstructionTable table) {
+        switch (table) {
+        case InstructionTable::Primary: return 0;
+        case InstructionTable::Secondary: return 64;
+        case InstructionTable::RegImm: return 128;
+        case InstructionTable::COP0: return 160;
+        case InstructionTable::COP1: return 192;
+        case InstructionTable::FPUS: return 224;
+        case InstructionTable::COP2: return 288;
+        case InstructionTable::TLB: return 320;
+        case InstructionTable::MMI: return 384;
+        case InstructionTable::MMI0: return 448;
+        case InstructionTable::MMI1: return 480;
+        case InstructionTable::MMI2: return 512;
+        case InstructionTable::MMI3: return 544;
+        case InstructionTable::FPUW: return 576;
+        }
+
+        return 0;
+    }
+
+    static constexpr int NUM_INSTRUCTIONS = 640;
+
+    static int GetInstructionIndex(CPUInstruction inst) {
+        // most instructions are primary or secondary, so those are
+        // handled before going through the nested tables
+        if (inst.opcode == 0) {
+            return GetTableOffset(InstructionTable::Secondary) + inst.func;
+        }
+
+        if (!((NESTED_OPCODES >> inst.opcode) & 0x1)) {
+            return inst.opcode;
+        }
+
+        return GetNestedInstructionIndex(inst);
+    }
+
+    static int GetNestedInstructionIndex(CPUInstruction inst);
+
 private:
-    std::array<InterpreterInstruction, 64> primary_table;
-    std::array<InterpreterInstruction, 64> secondary_table;
-    std::array<InterpreterInstruction, 32> regimm_table;
-    std::array<InterpreterInstruction, 32> cop0_table;
-    std::array<InterpreterInstruction, 32> cop1_table;
-    std::array<InterpreterInstruction, 64> fpu_s_table;
-    std::array<InterpreterInstruction, 32> cop2_table;
-    std::array<InterpreterInstruction, 64> tlb_table;
-    std::array<InterpreterInstruction, 64> mmi_table;
-    std::array<InterpreterInstruction, 32> mmi1_table;
-    std::array<InterpreterInstruction, 32> mmi2_table;
-    std::array<InterpreterInstruction, 32> mmi3_table;
+    // special, regimm, cop0, cop1, cop2 and mmi
+    static constexpr u64 NESTED_OPCODES = (1 << 0) | (1 << 1) | (1 << 16) | (1 << 17) | (1 << 18) | (1 << 28);
+
+    std::array<InterpreterInstruction, NUM_INSTRUCTIONS> table;
 };
\ No newline at end of file
@@ -0,0 +1,657 @@
+#include <sys/mman.h>
+#include <type_traits>
+#include "common/log.h"
+#include "core/ee/jit/jit.h"
+#include "core/ee/ee_core.h"
+#include "core/ee/instruction_info.h"
+#include "core/system.h"
+
+// u128 is a plain pair of u64s, so the system v abi passes and returns it in two registers
+static_assert(std::is_trivially_copyable_v<u128> && sizeof(u128) == 16);
+
+// lq and sq work out their address in the block, and only call out for the access itself
+static u128 ReadQuad(EECore* cpu, u32 addr) {
+    return cpu->ReadQuad(addr);
+}
+
+static void WriteQuad(EECore* cpu, u32 addr, u64 low, u64 high) {
+    u128 data;
+    data.ud[0] = low;
+    data.ud[1] = high;
+    cpu->WriteQuad(addr, data);
+}
+
+EEJIT::EEJIT(EECore& cpu) : cpu(cpu) {
+    void* buffer = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (buffer == MAP_FAILED) {
+        log_fatal("[EEJIT] failed to allocate the code buffer");
+    }
+
+    code_buffer = reinterpret_cast<u8*>(buffer);
+
+    gpr_offset = GetOffset(cpu.gpr);
+    pc_offset = GetOffset(cpu.pc);
+    next_pc_offset = GetOffset(cpu.next_pc);
+    hi_offset = GetOffset(cpu.hi);
+    lo_offset = GetOffset(cpu.lo);
+    hi1_offset = GetOffset(cpu.hi1);
+    lo1_offset = GetOffset(cpu.lo1);
+
+    Reset();
+}
+
+EEJIT::~EEJIT() {
+    munmap(code_buffer, CODE_BUFFER_SIZE);
+}
+
+void EEJIT::Reset() {
+    block_cache.Reset();
+    emitter.SetBuffer(code_buffer, CODE_BUFFER_SIZE);
+}
+
+void EEJIT::Run() {
+    while (cpu.cycles_left > 0) {
+        // the rest of the cycles would just be spent going around the same loop
+        if (cpu.idle) {
+            cpu.SkipIdleCycles(cpu.cycles_left);
+            cpu.cycles_left = 0;
+            break;
+        }
+
+        // a branch that was left to the interpreter has to
+        // have its delay slot interpreted as well
+        if (cpu.branch_delay) {
+            cpu.InterpretInstruction();
+            cpu.cycles_left--;
+            continue;
+        }
+
+        u32 paddr = cpu.system.memory.TranslateVirtualAddress(cpu.pc);
+        JITBlock* block = block_cache.GetBlock(paddr);
+
+        if (!block || block->pc != cpu.pc) {
+            block = CompileBlock(cpu.pc, paddr);
+        }
+
+        if (!block) {
+            cpu.InterpretInstruction();
+            cpu.cycles_left--;
+            continue;
+        }
+
+        u32 block_pc = cpu.pc;
+
+        cpu.cycles_left -= block->code(&cpu);
+
+        if (cpu.interrupt_pending) {
+            cpu.CheckInterrupts();
+        }
+
+        // the block might have been invalidated while it ran, but it isn't freed until after this
+        if (!block->idle_loop.empty() && cpu.pc == block_pc) {
+            cpu.CheckIdleLoop(block_pc, block->idle_loop);
+        }
+
+        block_cache.FreeInvalidated();
+    }
+}
+
+JITBlock* EEJIT::CompileBlock(u32 pc, u32 paddr) {
+    if (!BlockCache<JITBlock>::IsCacheable(paddr)) {
+        return nullptr;
+    }
+
+    CPUInstruction first = cpu.ReadWord(pc);
+
+    if (EEIsBranch(first) && !CanCompileBranch(first, cpu.ReadWord(pc + 4))) {
+        return nullptr;
+    }
+
+    // when the code buffer runs out we just start again from scratch.
+    // this is safe since we only compile in between blocks
+    if (emitter.GetRemainingSpace() < MAX_BLOCK_CODE_SIZE) {
+        Reset();
+    }
+
+    std::unique_ptr<JITBlock> block = std::make_unique<JITBlock>();
+    block->pc = pc;
+    block->code = reinterpret_cast<JITFunction>(emitter.GetCurrentPointer());
+
+    EmitPrologue();
+
+    std::vector<CPUInstruction> code;
+    u32 current_pc = pc;
+    int cycles = 0;
+
+    while (true) {
+        CPUInstruction inst = cpu.ReadWord(current_pc);
+
+        if (EEIsBranch(inst)) {
+            CPUInstruction delay_slot = cpu.ReadWord(current_pc + 4);
+
+            if (!CanCompileBranch(inst, delay_slot)) {
+                // leave the branch for the interpreter to handle
+                emitter.StoreImm32(X64Reg::RBX, pc_offset, current_pc);
+                EmitEpilogue(cycles);
+                current_pc -= 4;
+                break;
+            }
+
+            EmitBranch(inst, delay_slot, current_pc, cycles);
+            code.push_back(inst);
+            code.push_back(delay_slot);
+            current_pc += 4;
+            break;
+        }
+
+        EmitInstruction(inst, current_pc);
+        code.push_back(inst);
+        cycles++;
+
+        if (EEIsBlockTerminator(inst)) {
+            // the handler has set pc up in the same way as the interpreter would,
+            // so we just need to do the increment after the instruction
+            emitter.AluImm32(X64AluOp::Add, X64Reg::RBX, pc_offset, 4);
+            EmitEpilogue(cycles);
+            break;
+        }
+
+        current_pc += 4;
+
+        // keep blocks within a single page apart from delay slots,
+        // so that invalidating a page doesn't need to look at its neighbours
+        if (cycles == MAX_BLOCK_SIZE || (current_pc & 0xFFF) == 0) {
+            emitter.StoreImm32(X64Reg::RBX, pc_offset, current_pc);
+            EmitEpilogue(cycles);
+            current_pc -= 4;
+            break;
+        }
+    }
+
+    if (EEIsIdleLoop(pc, code)) {
+        block->idle_loop = code;
+    }
+
+    // current_pc is now the last instruction in the block
+    u32 end = cpu.system.memory.TranslateVirtualAddress(current_pc);
+
+    cpu.system.memory.MarkEECode(paddr);
+    cpu.system.memory.MarkEECode(end);
+
+    return block_cache.InsertBlock(paddr, end, std::move(block));
+}
+
+void EEJIT::InvalidateCode(u32 paddr) {
+    block_cache.InvalidatePage(BlockCache<JITBlock>::GetPageIndex(paddr));
+}
+
+bool EEJIT::CanCompileBranch(CPUInstruction inst, CPUInstruction delay_slot) {
+    if (EEIsBranch(delay_slot) || EEIsBlockTerminator(delay_slot)) {
+        return false;
+    }
+
+    // only the branches which the interpreter supports get compiled
+    switch (inst.opcode) {
+    case 0:
+        return inst.func == 8 || inst.func == 9;
+    case 1:
+        return inst.rt <= 3;
+    case 2: case 3: case 4: case 5: case 6: case 7: case 20: case 21:
+        return true;
+    }
+
+    return false;
+}
+
+void EEJIT::EmitPrologue() {
+    // rbx holds the pointer to the cpu state for the whole block.
+    // pushing it also keeps the stack 16 byte aligned for calls
+    emitter.Push(X64Reg::RBX);
+    emitter.Mov64(X64Reg::RBX, X64Reg::RDI);
+}
+
+void EEJIT::EmitEpilogue(int cycles) {
+    emitter.MovImm32(X64Reg::RAX, cycles);
+    emitter.Pop(X64Reg::RBX);
+    emitter.Ret();
+}
+
+void EEJIT::EmitInstruction(CPUInstruction inst, u32 pc) {
+    if (!EmitNativeInstruction(inst)) {
+        EmitInterpreterCall(inst, pc);
+    }
+}
+
+void EEJIT::EmitInterpreterCall(CPUInstruction inst, u32 pc) {
+    InterpreterInstruction handler = cpu.interpreter_table.GetInterpreterInstruction(cpu, inst);
+
+    // some handlers rely on pc, such as syscall and eret
+    emitter.StoreImm32(X64Reg::RBX, pc_offset, pc);
+    emitter.Mov64(X64Reg::RDI, X64Reg::RBX);
+    emitter.MovImm32(X64Reg::RSI, inst.data);
+    emitter.Call(reinterpret_cast<const void*>(handler));
+}
+
+bool EEJIT::EmitNativeInstruction(CPUInstruction inst) {
+    switch (inst.opcode) {
+    case 0:
+        switch (inst.func) {
+        case 0: case 2: case 3: {
+            // sll, srl and sra
+            if (!inst.rd) {
+                return true;
+            }
+
+            X64ShiftOp op = inst.func == 0 ? X64ShiftOp::Shl : inst.func == 2 ? X64ShiftOp::Shr : X64ShiftOp::Sar;
+
+            emitter.Load32(X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rt));
+            emitter.Shift32(op, X64Reg::RAX, inst.imm5);
+            emitter.Movsxd(X64Reg::RAX, X64Reg::RAX);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+        case 4: case 6: case 7: {
+            // sllv, srlv and srav. the shift amount is masked
+            // to 5 bits by the host for 32 bit shifts
+            if (!inst.rd) {
+                return true;
+            }
+
+            X64ShiftOp op = inst.func == 4 ? X64ShiftOp::Shl : inst.func == 6 ? X64ShiftOp::Shr : X64ShiftOp::Sar;
+
+            emitter.Load32(X64Reg::RCX, X64Reg::RBX, GPROffset(inst.rs));
+            emitter.Load32(X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rt));
+            emitter.ShiftCL32(op, X64Reg::RAX);
+            emitter.Movsxd(X64Reg::RAX, X64Reg::RAX);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+        case 20: case 23: {
+            // dsllv and dsrav
+            if (!inst.rd) {
+                return true;
+            }
+
+            emitter.Load32(X64Reg::RCX, X64Reg::RBX, GPROffset(inst.rs));
+            EmitLoadGPR(X64Reg::RAX, inst.rt);
+            emitter.ShiftCL64(inst.func == 20 ? X64ShiftOp::Shl : X64ShiftOp::Sar, X64Reg::RAX);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+        case 56: case 58: case 60: case 62: case 63: {
+            // dsll, dsrl, dsll32, dsrl32 and dsra32
+            if (!inst.rd) {
+                return true;
+            }
+
+            X64ShiftOp op = (inst.func == 56 || inst.func == 60) ? X64ShiftOp::Shl : inst.func == 63 ? X64ShiftOp::Sar : X64ShiftOp::Shr;
+            u8 amount = inst.func >= 60 ? inst.imm5 + 32 : inst.imm5;
+
+            EmitLoadGPR(X64Reg::RAX, inst.rt);
+            emitter.Shift64(op, X64Reg::RAX, amount);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+        case 10: case 11: {
+            // movz and movn
+            if (!inst.rd) {
+                return true;
+            }
+
+            EmitLoadGPR(X64Reg::RAX, inst.rt);
+            emitter.Test64(X64Reg::RAX, X64Reg::RAX);
+            u8* skip = emitter.Jcc(inst.func == 10 ? X64Condition::NotEqual : X64Condition::Equal);
+            EmitLoadGPR(X64Reg::RAX, inst.rs);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            emitter.SetJumpTarget(skip);
+            return true;
+        }
+        case 16: case 18:
+            // mfhi and mflo
+            if (!inst.rd) {
+                return true;
+            }
+
+            emitter.Load64(X64Reg::RAX, X64Reg::RBX, inst.func == 16 ? hi_offset : lo_offset);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        case 17: case 19:
+            // mthi and mtlo
+            EmitLoadGPR(X64Reg::RAX, inst.rs);
+            emitter.Store64(X64Reg::RBX, inst.func == 17 ? hi_offset : lo_offset, X64Reg::RAX);
+            return true;
+        case 33: case 35: case 45: case 47: case 36: case 37: case 39: {
+            // addu, subu, daddu, dsubu, and, or and nor
+            if (!inst.rd) {
+                return true;
+            }
+
+            X64AluOp op;
+
+            switch (inst.func) {
+            case 33: case 45:
+                op = X64AluOp::Add;
+                break;
+            case 35: case 47:
+                op = X64AluOp::Sub;
+                break;
+            case 36:
+                op = X64AluOp::And;
+                break;
+            default:
+                op = X64AluOp::Or;
+                break;
+            }
+
+            EmitLoadGPR(X64Reg::RAX, inst.rs);
+            emitter.Alu64(op, X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rt));
+
+            if (inst.func == 33 || inst.func == 35) {
+                emitter.Movsxd(X64Reg::RAX, X64Reg::RAX);
+            } else if (inst.func == 39) {
+                emitter.Not64(X64Reg::RAX);
+            }
+
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+        case 42: case 43:
+            // slt and sltu
+            if (!inst.rd) {
+                return true;
+            }
+
+            EmitLoadGPR(X64Reg::RAX, inst.rs);
+            emitter.Alu64(X64AluOp::Cmp, X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rt));
+            emitter.SetCC(inst.func == 42 ? X64Condition::Less : X64Condition::Below, X64Reg::RAX);
+            emitter.MovzxByte(X64Reg::RAX, X64Reg::RAX);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        }
+
+        return false;
+    case 9: case 25:
+        // addiu and daddiu
+        if (!inst.rt) {
+            return true;
+        }
+
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.AluImm64(X64AluOp::Add, X64Reg::RAX, inst.simm);
+
+        if (inst.opcode == 9) {
+            emitter.Movsxd(X64Reg::RAX, X64Reg::RAX);
+        }
+
+        EmitStoreGPR(inst.rt, X64Reg::RAX);
+        return true;
+    case 10: case 11:
+        // slti and sltiu
+        if (!inst.rt) {
+            return true;
+        }
+
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.AluImm64(X64AluOp::Cmp, X64Reg::RAX, inst.simm);
+        emitter.SetCC(inst.opcode == 10 ? X64Condition::Less : X64Condition::Below, X64Reg::RAX);
+        emitter.MovzxByte(X64Reg::RAX, X64Reg::RAX);
+        EmitStoreGPR(inst.rt, X64Reg::RAX);
+        return true;
+    case 12: case 13: case 14: {
+        // andi, ori and xori
+        if (!inst.rt) {
+            return true;
+        }
+
+        X64AluOp op = inst.opcode == 12 ? X64AluOp::And : inst.opcode == 13 ? X64AluOp::Or : X64AluOp::Xor;
+
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.AluImm64(op, X64Reg::RAX, inst.imm);
+        EmitStoreGPR(inst.rt, X64Reg::RAX);
+        return true;
+    }
+    case 15:
+        // lui
+        if (inst.rt) {
+            emitter.StoreImm64(X64Reg::RBX, GPROffset(inst.rt), static_cast<s32>(inst.imm << 16));
+        }
+
+        return true;
+    case 28:
+        switch (inst.func) {
+        case 16: case 18:
+            // mfhi1 and mflo1
+            if (!inst.rd) {
+                return true;
+            }
+
+            emitter.Load64(X64Reg::RAX, X64Reg::RBX, inst.func == 16 ? hi1_offset : lo1_offset);
+            EmitStoreGPR(inst.rd, X64Reg::RAX);
+            return true;
+        case 17: case 19:
+            // mthi1 and mtlo1
+            EmitLoadGPR(X64Reg::RAX, inst.rs);
+            emitter.Store64(X64Reg::RBX, inst.func == 17 ? hi1_offset : lo1_offset, X64Reg::RAX);
+            return true;
+        case 8: case 9: case 40: case 41:
+            // mmi0, mmi2, mmi1 and mmi3
+            return EmitParallelInstruction(inst);
+        }
+
+        return false;
+    case 30: case 31:
+        // lq and sq ignore the low 4 bits of the address
+        emitter.Load32(X64Reg::RSI, X64Reg::RBX, GPROffset(inst.rs));
+        emitter.AluImm32(X64AluOp::Add, X64Reg::RSI, inst.simm);
+        emitter.AluImm32(X64AluOp::And, X64Reg::RSI, ~0xF);
+        emitter.Mov64(X64Reg::RDI, X64Reg::RBX);
+
+        if (inst.opcode == 30) {
+            // the read still has to happen for rt = 0, since it could be to io
+            emitter.Call(reinterpret_cast<const void*>(ReadQuad));
+
+            if (inst.rt) {
+                emitter.Store64(X64Reg::RBX, GPROffset(inst.rt), X64Reg::RAX);
+                emitter.Store64(X64Reg::RBX, GPROffset(inst.rt) + 8, X64Reg::RDX);
+            }
+        } else {
+            emitter.Load64(X64Reg::RDX, X64Reg::RBX, GPROffset(inst.rt));
+            emitter.Load64(X64Reg::RCX, X64Reg::RBX, GPROffset(inst.rt) + 8);
+            emitter.Call(reinterpret_cast<const void*>(WriteQuad));
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool EEJIT::EmitParallelInstruction(CPUInstruction inst) {
+    X64SseOp op;
+
+    // the extend instructions put rt in the even lanes and pcpyld puts it in the
+    // low doubleword, so those take rt as the first operand rather than rs
+    bool rt_first = false;
+
+    switch (inst.func) {
+    case 8:
+        switch (inst.imm5) {
+        case 0: op = X64SseOp::Paddd; break;
+        case 1: op = X64SseOp::Psubd; break;
+        case 2: op = X64SseOp::Pcmpgtd; break;
+        case 4: op = X64SseOp::Paddw; break;
+        case 5: op = X64SseOp::Psubw; break;
+        case 6: op = X64SseOp::Pcmpgtw; break;
+        case 7: op = X64SseOp::Pmaxsw; break;
+        case 8: op = X64SseOp::Paddb; break;
+        case 9: op = X64SseOp::Psubb; break;
+        case 10: op = X64SseOp::Pcmpgtb; break;
+        case 18: op = X64SseOp::Punpckldq; rt_first = true; break;
+        case 20: op = X64SseOp::Paddsw; break;
+        case 21: op = X64SseOp::Psubsw; break;
+        case 22: op = X64SseOp::Punpcklwd; rt_first = true; break;
+        case 24: op = X64SseOp::Paddsb; break;
+        case 25: op = X64SseOp::Psubsb; break;
+        case 26: op = X64SseOp::Punpcklbw; rt_first = true; break;
+        default: return false;
+        }
+
+        break;
+    case 40:
+        switch (inst.imm5) {
+        case 2: op = X64SseOp::Pcmpeqd; break;
+        case 6: op = X64SseOp::Pcmpeqw; break;
+        case 7: op = X64SseOp::Pminsw; break;
+        case 10: op = X64SseOp::Pcmpeqb; break;
+        case 18: op = X64SseOp::Punpckhdq; rt_first = true; break;
+        case 20: op = X64SseOp::Paddusw; break;
+        case 21: op = X64SseOp::Psubusw; break;
+        case 22: op = X64SseOp::Punpckhwd; rt_first = true; break;
+        case 24: op = X64SseOp::Paddusb; break;
+        case 25: op = X64SseOp::Psubusb; break;
+        case 26: op = X64SseOp::Punpckhbw; rt_first = true; break;
+        default: return false;
+        }
+
+        break;
+    case 9:
+        switch (inst.imm5) {
+        case 14: op = X64SseOp::Punpcklqdq; rt_first = true; break;
+        case 18: op = X64SseOp::Pand; break;
+        case 19: op = X64SseOp::Pxor; break;
+        default: return false;
+        }
+
+        break;
+    case 41:
+        switch (inst.imm5) {
+        case 14: op = X64SseOp::Punpckhqdq; break;
+        case 18: case 19: op = X64SseOp::Por; break;
+        case 27:
+            // pcpyh copies halfword 0 of each doubleword across the whole doubleword
+            if (inst.rd) {
+                emitter.MovdquLoad(XMMReg::XMM0, X64Reg::RBX, GPROffset(inst.rt));
+                emitter.Pshuflw(XMMReg::XMM0, XMMReg::XMM0, 0x00);
+                emitter.Pshufhw(XMMReg::XMM0, XMMReg::XMM0, 0x00);
+                emitter.MovdquStore(X64Reg::RBX, GPROffset(inst.rd), XMMReg::XMM0);
+            }
+
+            return true;
+        default: return false;
+        }
+
+        break;
+    default:
+        return false;
+    }
+
+    // none of these have side effects, so writes to $zero can be dropped entirely
+    if (!inst.rd) {
+        return true;
+    }
+
+    emitter.MovdquLoad(XMMReg::XMM0, X64Reg::RBX, GPROffset(rt_first ? inst.rt : inst.rs));
+    emitter.MovdquLoad(XMMReg::XMM1, X64Reg::RBX, GPROffset(rt_first ? inst.rs : inst.rt));
+    emitter.Sse(op, XMMReg::XMM0, XMMReg::XMM1);
+
+    // pnor is por followed by flipping every bit
+    if (inst.func == 41 && inst.imm5 == 19) {
+        emitter.Sse(X64SseOp::Pcmpeqd, XMMReg::XMM1, XMMReg::XMM1);
+        emitter.Sse(X64SseOp::Pxor, XMMReg::XMM0, XMMReg::XMM1);
+    }
+
+    emitter.MovdquStore(X64Reg::RBX, GPROffset(inst.rd), XMMReg::XMM0);
+    return true;
+}
+
+void EEJIT::EmitBranch(CPUInstruction inst, CPUInstruction delay_slot, u32 pc, int cycles) {
+    u32 target = pc + (inst.simm << 2) + 4;
+    u32 fallthrough = pc + 8;
+    X64Condition condition = X64Condition::Equal;
+
+    // the branch and its delay slot
+    cycles += 2;
+
+    switch (inst.opcode) {
+    case 0:
+        if (inst.func == 9) {
+            // jalr writes the link register before reading rs
+            if (inst.rd) {
+                emitter.MovImm32(X64Reg::RAX, pc + 8);
+                EmitStoreGPR(inst.rd, X64Reg::RAX);
+            }
+        }
+
+        // the target must be read before the delay slot runs
+        emitter.Load32(X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rs));
+        emitter.Store32(X64Reg::RBX, next_pc_offset, X64Reg::RAX);
+        EmitInstruction(delay_slot, pc + 4);
+        emitter.Load32(X64Reg::RAX, X64Reg::RBX, next_pc_offset);
+        emitter.Store32(X64Reg::RBX, pc_offset, X64Reg::RAX);
+        EmitEpilogue(cycles);
+        return;
+    case 2: case 3:
+        if (inst.opcode == 3) {
+            emitter.MovImm32(X64Reg::RAX, pc + 8);
+            EmitStoreGPR(31, X64Reg::RAX);
+        }
+
+        EmitInstruction(delay_slot, pc + 4);
+        emitter.StoreImm32(X64Reg::RBX, pc_offset, ((pc + 4) & 0xF0000000) + (inst.offset << 2));
+        EmitEpilogue(cycles);
+        return;
+    case 1:
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.AluImm64(X64AluOp::Cmp, X64Reg::RAX, 0);
+        condition = (inst.rt & 0x1) ? X64Condition::GreaterEqual : X64Condition::Less;
+        break;
+    case 4: case 5: case 20: case 21:
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.Alu64(X64AluOp::Cmp, X64Reg::RAX, X64Reg::RBX, GPROffset(inst.rt));
+        condition = (inst.opcode & 0x1) ? X64Condition::NotEqual : X64Condition::Equal;
+        break;
+    case 6: case 7:
+        EmitLoadGPR(X64Reg::RAX, inst.rs);
+        emitter.AluImm64(X64AluOp::Cmp, X64Reg::RAX, 0);
+        condition = inst.opcode == 6 ? X64Condition::LessEqual : X64Condition::Greater;
+        break;
+    }
+
+    if (EEIsLikelyBranch(inst)) {
+        // the delay slot is only executed if the branch is taken.
+        // inverting an x86 condition code just flips the lowest bit
+        u8* not_taken = emitter.Jcc(static_cast<X64Condition>(static_cast<int>(condition) ^ 0x1));
+        EmitInstruction(delay_slot, pc + 4);
+        emitter.StoreImm32(X64Reg::RBX, pc_offset, target);
+        EmitEpilogue(cycles);
+
+        emitter.SetJumpTarget(not_taken);
+        emitter.StoreImm32(X64Reg::RBX, pc_offset, fallthrough);
+        EmitEpilogue(cycles - 1);
+    } else {
+        emitter.MovImm32(X64Reg::RAX, fallthrough);
+        emitter.MovImm32(X64Reg::RCX, target);
+        emitter.Cmov32(condition, X64Reg::RAX, X64Reg::RCX);
+        emitter.Store32(X64Reg::RBX, next_pc_offset, X64Reg::RAX);
+        EmitInstruction(delay_slot, pc + 4);
+        emitter.Load32(X64Reg::RAX, X64Reg::RBX, next_pc_offset);
+        emitter.Store32(X64Reg::RBX, pc_offset, X64Reg::RAX);
+        EmitEpilogue(cycles);
+    }
+}
+
+void EEJIT::EmitLoadGPR(X64Reg dst, int reg) {
+    emitter.Load64(dst, X64Reg::RBX, GPROffset(reg));
+}
+
+void EEJIT::EmitStoreGPR(int reg, X64Reg src) {
+    // writes to $zero are discarded
+    if (reg) {
+        emitter.Store64(X64Reg::RBX, GPROffset(reg), src);
+    }
+}
+
+s32 EEJIT::GPROffset(int reg) {
+    return gpr_offset + reg * sizeof(u64) * 2;
+}
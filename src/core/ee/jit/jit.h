@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include "common/types.h"
+#include "common/cpu_types.h"
+#include "core/ee/block_cache.h"
+#include "core/ee/jit/x64_emitter.h"
+
+class EECore;
+
+// compiled blocks return how many cycles they took
+using JITFunction = int (*)(EECore* cpu);
+
+struct JITBlock {
+    // the virtual address the block was compiled at,
+    // since branch targets are baked into the code
+    u32 pc;
+    JITFunction code;
+    
+    // the block's code if it's an idle loop, which has
+    // to be checked each time that it loops back
+    std::vector<CPUInstruction> idle_loop;
+};
+
+// compiles basic blocks of r5900 code to x86-64. common alu and branch instructions,
+// lq and sq, and the parallel instructions which map onto a single sse2 instruction
+// are emitted natively, while everything else calls into its interpreter handler,
+// so anything the interpreter supports can run in a block.
+// blocks end after a branch and its delay slot, or after an instruction that
+// can raise an exception, so interrupts are checked per block
+class EEJIT {
+public:
+    EEJIT(EECore& cpu);
+    ~EEJIT();
+
+    void Reset();
+    void Run();
+    void InvalidateCode(u32 paddr);
+
+private:
+    JITBlock* CompileBlock(u32 pc, u32 paddr);
+    bool CanCompileBranch(CPUInstruction inst, CPUInstruction delay_slot);
+
+    void EmitPrologue();
+    void EmitEpilogue(int cycles);
+    void EmitInstruction(CPUInstruction inst, u32 pc);
+    bool EmitNativeInstruction(CPUInstruction inst);
+    bool EmitParallelInstruction(CPUInstruction inst);
+    void EmitInterpreterCall(CPUInstruction inst, u32 pc);
+    void EmitBranch(CPUInstruction inst, CPUInstruction delay_slot, u32 pc, int cycles);
+    void EmitLoadGPR(X64Reg dst, int reg);
+    void EmitStoreGPR(int reg, X64Reg src);
+    s32 GPROffset(int reg);
+
+    template <typename T>
+    s32 GetOffset(T& field) {
+        return reinterpret_cast<u8*>(&field) - reinterpret_cast<u8*>(&cpu);
+    }
+
+    static constexpr int CODE_BUFFER_SIZE = 32 * 1024 * 1024;
+    static constexpr int MAX_BLOCK_SIZE = 64;
+
+    // generous upper bound on how much code a single block can need
+    static constexpr int MAX_BLOCK_CODE_SIZE = MAX_BLOCK_SIZE * 128;
+
+    u8* code_buffer = nullptr;
+    X64Emitter emitter;
+    BlockCache<JITBlock> block_cache;
+
+    s32 gpr_offset;
+    s32 pc_offset;
+    s32 next_pc_offset;
+    s32 hi_offset;
+    s32 lo_offset;
+    s32 hi1_offset;
+    s32 lo1_offset;
+
+    EECore& cpu;
+};
@@ -0,0 +1,306 @@
+#include <string.h>
+#include "common/log.h"
+#include "core/ee/jit/x64_emitter.h"
+
+void X64Emitter::SetBuffer(u8* new_buffer, int new_capacity) {
+    buffer = new_buffer;
+    current = new_buffer;
+    capacity = new_capacity;
+}
+
+u8* X64Emitter::GetCurrentPointer() {
+    return current;
+}
+
+int X64Emitter::GetRemainingSpace() {
+    return capacity - (current - buffer);
+}
+
+void X64Emitter::Push(X64Reg reg) {
+    Emit8(0x50 + static_cast<int>(reg));
+}
+
+void X64Emitter::Pop(X64Reg reg) {
+    Emit8(0x58 + static_cast<int>(reg));
+}
+
+void X64Emitter::Ret() {
+    Emit8(0xC3);
+}
+
+void X64Emitter::MovImm32(X64Reg reg, u32 imm) {
+    Emit8(0xB8 + static_cast<int>(reg));
+    Emit32(imm);
+}
+
+void X64Emitter::MovImm64(X64Reg reg, u64 imm) {
+    EmitRexW();
+    Emit8(0xB8 + static_cast<int>(reg));
+    Emit64(imm);
+}
+
+void X64Emitter::Mov32(X64Reg dst, X64Reg src) {
+    Emit8(0x8B);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Mov64(X64Reg dst, X64Reg src) {
+    EmitRexW();
+    Emit8(0x8B);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Movsxd(X64Reg dst, X64Reg src) {
+    EmitRexW();
+    Emit8(0x63);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Load32(X64Reg dst, X64Reg base, s32 disp) {
+    Emit8(0x8B);
+    EmitMemoryOperand(static_cast<int>(dst), base, disp);
+}
+
+void X64Emitter::Load64(X64Reg dst, X64Reg base, s32 disp) {
+    EmitRexW();
+    Emit8(0x8B);
+    EmitMemoryOperand(static_cast<int>(dst), base, disp);
+}
+
+void X64Emitter::LoadByte(X64Reg dst, X64Reg base, s32 disp) {
+    // movzx r32, byte [base + disp]
+    Emit8(0x0F);
+    Emit8(0xB6);
+    EmitMemoryOperand(static_cast<int>(dst), base, disp);
+}
+
+void X64Emitter::Store32(X64Reg base, s32 disp, X64Reg src) {
+    Emit8(0x89);
+    EmitMemoryOperand(static_cast<int>(src), base, disp);
+}
+
+void X64Emitter::Store64(X64Reg base, s32 disp, X64Reg src) {
+    EmitRexW();
+    Emit8(0x89);
+    EmitMemoryOperand(static_cast<int>(src), base, disp);
+}
+
+void X64Emitter::StoreImm32(X64Reg base, s32 disp, u32 imm) {
+    Emit8(0xC7);
+    EmitMemoryOperand(0, base, disp);
+    Emit32(imm);
+}
+
+void X64Emitter::StoreImm64(X64Reg base, s32 disp, s32 imm) {
+    EmitRexW();
+    Emit8(0xC7);
+    EmitMemoryOperand(0, base, disp);
+    Emit32(imm);
+}
+
+void X64Emitter::StoreByte(X64Reg base, s32 disp, u8 imm) {
+    Emit8(0xC6);
+    EmitMemoryOperand(0, base, disp);
+    Emit8(imm);
+}
+
+void X64Emitter::Alu64(X64AluOp op, X64Reg dst, X64Reg src) {
+    // the r64, r/m64 form of each group 1 opcode is (op << 3) + 3
+    EmitRexW();
+    Emit8((static_cast<int>(op) << 3) + 3);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Alu64(X64AluOp op, X64Reg dst, X64Reg base, s32 disp) {
+    EmitRexW();
+    Emit8((static_cast<int>(op) << 3) + 3);
+    EmitMemoryOperand(static_cast<int>(dst), base, disp);
+}
+
+void X64Emitter::AluImm32(X64AluOp op, X64Reg dst, s32 imm) {
+    Emit8(0x81);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(dst));
+    Emit32(imm);
+}
+
+void X64Emitter::AluImm64(X64AluOp op, X64Reg dst, s32 imm) {
+    EmitRexW();
+    Emit8(0x81);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(dst));
+    Emit32(imm);
+}
+
+void X64Emitter::AluImm32(X64AluOp op, X64Reg base, s32 disp, s32 imm) {
+    Emit8(0x81);
+    EmitMemoryOperand(static_cast<int>(op), base, disp);
+    Emit32(imm);
+}
+
+void X64Emitter::Shift32(X64ShiftOp op, X64Reg reg, u8 amount) {
+    Emit8(0xC1);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(reg));
+    Emit8(amount);
+}
+
+void X64Emitter::Shift64(X64ShiftOp op, X64Reg reg, u8 amount) {
+    EmitRexW();
+    Emit8(0xC1);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(reg));
+    Emit8(amount);
+}
+
+void X64Emitter::ShiftCL32(X64ShiftOp op, X64Reg reg) {
+    Emit8(0xD3);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(reg));
+}
+
+void X64Emitter::ShiftCL64(X64ShiftOp op, X64Reg reg) {
+    EmitRexW();
+    Emit8(0xD3);
+    EmitModRM(3, static_cast<int>(op), static_cast<int>(reg));
+}
+
+void X64Emitter::Not64(X64Reg reg) {
+    EmitRexW();
+    Emit8(0xF7);
+    EmitModRM(3, 2, static_cast<int>(reg));
+}
+
+void X64Emitter::Test64(X64Reg a, X64Reg b) {
+    EmitRexW();
+    Emit8(0x85);
+    EmitModRM(3, static_cast<int>(b), static_cast<int>(a));
+}
+
+void X64Emitter::SetCC(X64Condition cond, X64Reg dst) {
+    // only al, cl, dl and bl can be encoded without a rex prefix
+    if (static_cast<int>(dst) >= 4) {
+        log_fatal("[X64Emitter] setcc with register %d needs a rex prefix", static_cast<int>(dst));
+    }
+
+    Emit8(0x0F);
+    Emit8(0x90 + static_cast<int>(cond));
+    EmitModRM(3, 0, static_cast<int>(dst));
+}
+
+void X64Emitter::MovzxByte(X64Reg dst, X64Reg src) {
+    Emit8(0x0F);
+    Emit8(0xB6);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Cmov32(X64Condition cond, X64Reg dst, X64Reg src) {
+    Emit8(0x0F);
+    Emit8(0x40 + static_cast<int>(cond));
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Cmov64(X64Condition cond, X64Reg dst, X64Reg src) {
+    EmitRexW();
+    Emit8(0x0F);
+    Emit8(0x40 + static_cast<int>(cond));
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+u8* X64Emitter::Jcc(X64Condition cond) {
+    Emit8(0x0F);
+    Emit8(0x80 + static_cast<int>(cond));
+    u8* jump = current;
+    Emit32(0);
+    return jump;
+}
+
+u8* X64Emitter::Jmp() {
+    Emit8(0xE9);
+    u8* jump = current;
+    Emit32(0);
+    return jump;
+}
+
+void X64Emitter::SetJumpTarget(u8* jump) {
+    // the displacement is relative to the end of the jump instruction
+    s32 displacement = current - (jump + 4);
+    memcpy(jump, &displacement, 4);
+}
+
+void X64Emitter::Call(const void* function) {
+    // the code buffer isn't guaranteed to be within 2GB of the function,
+    // so call indirectly through rax
+    MovImm64(X64Reg::RAX, reinterpret_cast<u64>(function));
+    Emit8(0xFF);
+    EmitModRM(3, 2, static_cast<int>(X64Reg::RAX));
+}
+
+void X64Emitter::MovdquLoad(XMMReg dst, X64Reg base, s32 disp) {
+    Emit8(0xF3);
+    Emit8(0x0F);
+    Emit8(0x6F);
+    EmitMemoryOperand(static_cast<int>(dst), base, disp);
+}
+
+void X64Emitter::MovdquStore(X64Reg base, s32 disp, XMMReg src) {
+    Emit8(0xF3);
+    Emit8(0x0F);
+    Emit8(0x7F);
+    EmitMemoryOperand(static_cast<int>(src), base, disp);
+}
+
+void X64Emitter::Sse(X64SseOp op, XMMReg dst, XMMReg src) {
+    Emit8(0x66);
+    Emit8(0x0F);
+    Emit8(static_cast<int>(op));
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+}
+
+void X64Emitter::Pshuflw(XMMReg dst, XMMReg src, u8 order) {
+    Emit8(0xF2);
+    Emit8(0x0F);
+    Emit8(0x70);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+    Emit8(order);
+}
+
+void X64Emitter::Pshufhw(XMMReg dst, XMMReg src, u8 order) {
+    Emit8(0xF3);
+    Emit8(0x0F);
+    Emit8(0x70);
+    EmitModRM(3, static_cast<int>(dst), static_cast<int>(src));
+    Emit8(order);
+}
+
+void X64Emitter::Emit8(u8 data) {
+    *current++ = data;
+}
+
+void X64Emitter::Emit32(u32 data) {
+    memcpy(current, &data, 4);
+    current += 4;
+}
+
+void X64Emitter::Emit64(u64 data) {
+    memcpy(current, &data, 8);
+    current += 8;
+}
+
+void X64Emitter::EmitRexW() {
+    Emit8(0x48);
+}
+
+void X64Emitter::EmitModRM(int mod, int reg, int rm) {
+    Emit8((mod << 6) | (reg << 3) | rm);
+}
+
+void X64Emitter::EmitMemoryOperand(int reg, X64Reg base, s32 disp) {
+    // rsp as a base would need a sib byte, which we never use
+    if (base == X64Reg::RSP) {
+        log_fatal("[X64Emitter] rsp can't be used as a base register");
+    }
+
+    if (disp >= -128 && disp <= 127) {
+        EmitModRM(1, reg, static_cast<int>(base));
+        Emit8(disp);
+    } else {
+        EmitModRM(2, reg, static_cast<int>(base));
+        Emit32(disp);
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "common/types.h"
+
+enum class X64Reg : int {
+    RAX = 0,
+    RCX = 1,
+    RDX = 2,
+    RBX = 3,
+    RSP = 4,
+    RBP = 5,
+    RSI = 6,
+    RDI = 7,
+};
+
+enum class XMMReg : int {
+    XMM0 = 0,
+    XMM1 = 1,
+};
+
+enum class X64Condition : int {
+    Below = 0x2,
+    AboveEqual = 0x3,
+    Equal = 0x4,
+    NotEqual = 0x5,
+    BelowEqual = 0x6,
+    Above = 0x7,
+    Sign = 0x8,
+    NotSign = 0x9,
+    Less = 0xC,
+    GreaterEqual = 0xD,
+    LessEqual = 0xE,
+    Greater = 0xF,
+};
+
+// the opcode extensions used by the group 1 arithmetic instructions
+enum class X64AluOp : int {
+    Add = 0,
+    Or = 1,
+    And = 4,
+    Sub = 5,
+    Xor = 6,
+    Cmp = 7,
+};
+
+// the opcode extensions used by the group 2 shift instructions
+enum class X64ShiftOp : int {
+    Shl = 4,
+    Shr = 5,
+    Sar = 7,
+};
+
+// the second opcode byte of the sse2 integer instructions which
+// are encoded as 66 0f op, and take xmm, xmm/m128 operands
+enum class X64SseOp : int {
+    Punpcklbw = 0x60,
+    Punpcklwd = 0x61,
+    Punpckldq = 0x62,
+    Pcmpgtb = 0x64,
+    Pcmpgtw = 0x65,
+    Pcmpgtd = 0x66,
+    Punpckhbw = 0x68,
+    Punpckhwd = 0x69,
+    Punpckhdq = 0x6A,
+    Punpcklqdq = 0x6C,
+    Punpckhqdq = 0x6D,
+    Pcmpeqb = 0x74,
+    Pcmpeqw = 0x75,
+    Pcmpeqd = 0x76,
+    Psubusb = 0xD8,
+    Psubusw = 0xD9,
+    Pand = 0xDB,
+    Paddusb = 0xDC,
+    Paddusw = 0xDD,
+    Psubsb = 0xE8,
+    Psubsw = 0xE9,
+    Pminsw = 0xEA,
+    Por = 0xEB,
+    Paddsb = 0xEC,
+    Paddsw = 0xED,
+    Pmaxsw = 0xEE,
+    Pxor = 0xEF,
+    Psubb = 0xF8,
+    Psubw = 0xF9,
+    Psubd = 0xFA,
+    Paddb = 0xFC,
+    Paddw = 0xFD,
+    Paddd = 0xFE,
+};
+
+// a small x86-64 code emitter with just enough of the instruction set
+// for the ee jit. only the first 8 general purpose registers are supported,
+// so no rex prefix is needed apart from rex.w. memory operands are always
+// in the form [base + displacement]
+class X64Emitter {
+public:
+    void SetBuffer(u8* buffer, int capacity);
+    u8* GetCurrentPointer();
+    int GetRemainingSpace();
+
+    void Push(X64Reg reg);
+    void Pop(X64Reg reg);
+    void Ret();
+
+    void MovImm32(X64Reg reg, u32 imm);
+    void MovImm64(X64Reg reg, u64 imm);
+    void Mov32(X64Reg dst, X64Reg src);
+    void Mov64(X64Reg dst, X64Reg src);
+    void Movsxd(X64Reg dst, X64Reg src);
+
+    void Load32(X64Reg dst, X64Reg base, s32 disp);
+    void Load64(X64Reg dst, X64Reg base, s32 disp);
+    void LoadByte(X64Reg dst, X64Reg base, s32 disp);
+    void Store32(X64Reg base, s32 disp, X64Reg src);
+    void Store64(X64Reg base, s32 disp, X64Reg src);
+    void StoreImm32(X64Reg base, s32 disp, u32 imm);
+    void StoreImm64(X64Reg base, s32 disp, s32 imm);
+    void StoreByte(X64Reg base, s32 disp, u8 imm);
+
+    void Alu64(X64AluOp op, X64Reg dst, X64Reg src);
+    void Alu64(X64AluOp op, X64Reg dst, X64Reg base, s32 disp);
+    void AluImm32(X64AluOp op, X64Reg dst, s32 imm);
+    void AluImm64(X64AluOp op, X64Reg dst, s32 imm);
+    void AluImm32(X64AluOp op, X64Reg base, s32 disp, s32 imm);
+    void Shift32(X64ShiftOp op, X64Reg reg, u8 amount);
+    void Shift64(X64ShiftOp op, X64Reg reg, u8 amount);
+    void ShiftCL32(X64ShiftOp op, X64Reg reg);
+    void ShiftCL64(X64ShiftOp op, X64Reg reg);
+    void Not64(X64Reg reg);
+    void Test64(X64Reg a, X64Reg b);
+
+    void SetCC(X64Condition cond, X64Reg dst);
+    void MovzxByte(X64Reg dst, X64Reg src);
+    void Cmov32(X64Condition cond, X64Reg dst, X64Reg src);
+    void Cmov64(X64Condition cond, X64Reg dst, X64Reg src);
+
+    // jumps return the location of their displacement,
+    // which gets patched once the target is known
+    u8* Jcc(X64Condition cond);
+    u8* Jmp();
+    void SetJumpTarget(u8* jump);
+
+    void Call(const void* function);
+
+    void MovdquLoad(XMMReg dst, X64Reg base, s32 disp);
+    void MovdquStore(X64Reg base, s32 disp, XMMReg src);
+
+    // only the register form is provided, since the memory
+    // form needs its operand to be 16 byte aligned
+    void Sse(X64SseOp op, XMMReg dst, XMMReg src);
+    void Pshuflw(XMMReg dst, XMMReg src, u8 order);
+    void Pshufhw(XMMReg dst, XMMReg src, u8 order);
+
+private:
+    void Emit8(u8 data);
+    void Emit32(u32 data);
+    void Emit64(u64 data);
+    void EmitRexW();
+    void EmitModRM(int mod, int reg, int rm);
+    void EmitMemoryOperand(int reg, X64Reg base, s32 disp);
+
+    u8* buffer = nullptr;
+    u8* current = nullptr;
+    int capacity = 0;
+};
@@ -0,0 +1,1359 @@
+#include <limits>
+#include <string.h>
+#include "common/types.h"
+#include "common/arithmetic.h"
+#include "core/ee/ee_interpreter.h"
+
+// the parallel instructions work on all 128 bits of a register at once. on hosts with
+// sse2 (every x86-64 cpu) they map onto the equivalent sse instructions, with a scalar
+// fallback for everything else. the few which have a much better sse4.1 equivalent
+// pick it at runtime, unless the build already targets sse4.1
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__GNUC__)
+#include <smmintrin.h>
+#define MMI_RUNTIME_SSE41
+
+static bool DetectSSE41() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+}
+
+static const bool has_sse41 = DetectSSE41();
+#endif
+#endif
+
+template <typename T>
+struct Lanes {
+    static constexpr int count = 16 / sizeof(T);
+
+    T& operator[](int index) {
+        return data[index];
+    }
+
+    T data[count];
+};
+
+template <typename T>
+static inline Lanes<T> GetLanes(EECore& cpu, int reg) {
+    Lanes<T> lanes;
+    memcpy(lanes.data, &cpu.gpr[reg * 16], 16);
+    return lanes;
+}
+
+template <typename T>
+static inline void SetLanes(EECore& cpu, int reg, Lanes<T>& lanes) {
+    if (reg) {
+        memcpy(&cpu.gpr[reg * 16], lanes.data, 16);
+    }
+}
+
+// hi and lo are 128 bits wide for the parallel instructions,
+// with hi1 and lo1 being the upper 64 bits
+template <typename T>
+static inline Lanes<T> Combine(u64 low, u64 high) {
+    Lanes<T> lanes;
+    memcpy(&lanes.data[0], &low, 8);
+    memcpy(&lanes.data[Lanes<T>::count / 2], &high, 8);
+    return lanes;
+}
+
+template <typename T>
+static inline void Split(Lanes<T>& lanes, u64& low, u64& high) {
+    memcpy(&low, &lanes.data[0], 8);
+    memcpy(&high, &lanes.data[Lanes<T>::count / 2], 8);
+}
+
+template <typename T, typename Func>
+static inline void ParallelOp(EECore& cpu, CPUInstruction inst, Func func) {
+    Lanes<T> rs = GetLanes<T>(cpu, inst.rs);
+    Lanes<T> rt = GetLanes<T>(cpu, inst.rt);
+    Lanes<T> rd;
+
+    for (int i = 0; i < Lanes<T>::count; i++) {
+        rd[i] = func(rs[i], rt[i]);
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+template <typename T>
+static inline T Saturate(s64 value) {
+    if (value > static_cast<s64>(std::numeric_limits<T>::max())) {
+        return std::numeric_limits<T>::max();
+    } else if (value < static_cast<s64>(std::numeric_limits<T>::min())) {
+        return std::numeric_limits<T>::min();
+    }
+
+    return value;
+}
+
+#if defined(__SSE2__)
+static inline __m128i GetVector(EECore& cpu, int reg) {
+    return _mm_loadu_si128(reinterpret_cast<__m128i*>(&cpu.gpr[reg * 16]));
+}
+
+static inline void SetVector(EECore& cpu, int reg, __m128i data) {
+    if (reg) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&cpu.gpr[reg * 16]), data);
+    }
+}
+
+static inline __m128i CombineVector(u64 low, u64 high) {
+    return _mm_set_epi64x(high, low);
+}
+
+static inline void SplitVector(__m128i data, u64& low, u64& high) {
+    u64 values[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values), data);
+    low = values[0];
+    high = values[1];
+}
+
+// takes words 0 and 2 from hi and lo in the order lo, hi, lo, hi
+static inline __m128i InterleaveHILO(__m128i lo, __m128i hi) {
+    return _mm_unpacklo_epi64(_mm_unpacklo_epi32(lo, hi), _mm_unpackhi_epi32(lo, hi));
+}
+
+// the signed 32 bit product of each pair of halfwords, returned as
+// products 0-3 in low and products 4-7 in high
+static inline void MultiplyHalfwords(__m128i a, __m128i b, __m128i& low, __m128i& high) {
+    __m128i products_lo = _mm_mullo_epi16(a, b);
+    __m128i products_hi = _mm_mulhi_epi16(a, b);
+    low = _mm_unpacklo_epi16(products_lo, products_hi);
+    high = _mm_unpackhi_epi16(products_lo, products_hi);
+}
+#endif
+
+// the results of multiplies and divides on words 0 and 2 go into words 0 of lo/hi and lo1/hi1
+static inline void SetParallelHILO(EECore& cpu, int lane, u32 lo, u32 hi) {
+    if (lane == 0) {
+        cpu.lo = sign_extend<s64, 32>(lo);
+        cpu.hi = sign_extend<s64, 32>(hi);
+    } else {
+        cpu.lo1 = sign_extend<s64, 32>(lo);
+        cpu.hi1 = sign_extend<s64, 32>(hi);
+    }
+}
+
+static inline s64 GetParallelHILO(EECore& cpu, int lane) {
+    u64 lo = lane == 0 ? cpu.lo : cpu.lo1;
+    u64 hi = lane == 0 ? cpu.hi : cpu.hi1;
+    return static_cast<s64>((hi << 32) | (lo & 0xFFFFFFFF));
+}
+
+static inline void SignedDivide(s32 dividend, s32 divisor, u32& quotient, u32& remainder) {
+    if (divisor == 0) {
+        quotient = dividend < 0 ? 1 : 0xFFFFFFFF;
+        remainder = dividend;
+    } else if (dividend == static_cast<s32>(0x80000000) && divisor == -1) {
+        quotient = 0x80000000;
+        remainder = 0;
+    } else {
+        quotient = dividend / divisor;
+        remainder = dividend % divisor;
+    }
+}
+
+// MMI instructions
+void EEInterpreter::plzcw(EECore& cpu, CPUInstruction inst) {
+    for (int i = 0; i < 2; i++) {
+        u32 data = cpu.GetReg<u32>(inst.rs, i);
+        cpu.SetReg<u32>(inst.rd, CountLeadingSignBits(data) - 1, i);
+    }
+}
+
+void EEInterpreter::pmfhl(EECore& cpu, CPUInstruction inst) {
+    switch (inst.imm5) {
+    case 0: case 1: case 3: case 4: {
+#if defined(__SSE2__)
+        __m128i lo = CombineVector(cpu.lo, cpu.lo1);
+        __m128i hi = CombineVector(cpu.hi, cpu.hi1);
+        __m128i low_words = _mm_unpacklo_epi32(lo, hi);
+        __m128i high_words = _mm_unpackhi_epi32(lo, hi);
+
+        if (inst.imm5 == 0) {
+            // lw
+            SetVector(cpu, inst.rd, _mm_unpacklo_epi64(low_words, high_words));
+        } else if (inst.imm5 == 1) {
+            // uw
+            SetVector(cpu, inst.rd, _mm_unpackhi_epi64(low_words, high_words));
+        } else {
+            low_words = _mm_unpacklo_epi64(lo, hi);
+            high_words = _mm_unpackhi_epi64(lo, hi);
+
+            if (inst.imm5 == 3) {
+                // lh
+                low_words = _mm_srai_epi32(_mm_slli_epi32(low_words, 16), 16);
+                high_words = _mm_srai_epi32(_mm_slli_epi32(high_words, 16), 16);
+            }
+
+            // sh
+            SetVector(cpu, inst.rd, _mm_packs_epi32(low_words, high_words));
+        }
+#else
+        Lanes<u32> lo = Combine<u32>(cpu.lo, cpu.lo1);
+        Lanes<u32> hi = Combine<u32>(cpu.hi, cpu.hi1);
+
+        if (inst.imm5 == 0 || inst.imm5 == 1) {
+            int offset = inst.imm5;
+            Lanes<u32> rd;
+            rd[0] = lo[offset];
+            rd[1] = hi[offset];
+            rd[2] = lo[2 + offset];
+            rd[3] = hi[2 + offset];
+            SetLanes(cpu, inst.rd, rd);
+        } else {
+            u32 words[8] = {lo[0], lo[1], hi[0], hi[1], lo[2], lo[3], hi[2], hi[3]};
+            Lanes<s16> rd;
+
+            for (int i = 0; i < 8; i++) {
+                rd[i] = inst.imm5 == 3 ? static_cast<s16>(words[i]) : Saturate<s16>(static_cast<s32>(words[i]));
+            }
+
+            SetLanes(cpu, inst.rd, rd);
+        }
+#endif
+        break;
+    }
+    case 2: {
+        // slw
+        Lanes<u64> rd;
+
+        for (int i = 0; i < 2; i++) {
+            rd[i] = static_cast<s64>(Saturate<s32>(GetParallelHILO(cpu, i)));
+        }
+
+        SetLanes(cpu, inst.rd, rd);
+        break;
+    }
+    default:
+        log_fatal("[EEInterpreter] pmfhl with format %d is undefined", inst.imm5);
+    }
+}
+
+void EEInterpreter::pmthl(EECore& cpu, CPUInstruction inst) {
+    if (inst.imm5 != 0) {
+        log_fatal("[EEInterpreter] pmthl with format %d is undefined", inst.imm5);
+    }
+
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> lo = Combine<u32>(cpu.lo, cpu.lo1);
+    Lanes<u32> hi = Combine<u32>(cpu.hi, cpu.hi1);
+
+    lo[0] = rs[0];
+    hi[0] = rs[1];
+    lo[2] = rs[2];
+    hi[2] = rs[3];
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+}
+
+void EEInterpreter::psllh(EECore& cpu, CPUInstruction inst) {
+    int shift = inst.imm5 & 0xF;
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sll_epi16(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(shift)));
+#else
+    ParallelOp<u16>(cpu, inst, [shift](u16, u16 rt) -> u16 { return rt << shift; });
+#endif
+}
+
+void EEInterpreter::psrlh(EECore& cpu, CPUInstruction inst) {
+    int shift = inst.imm5 & 0xF;
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_srl_epi16(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(shift)));
+#else
+    ParallelOp<u16>(cpu, inst, [shift](u16, u16 rt) -> u16 { return rt >> shift; });
+#endif
+}
+
+void EEInterpreter::psrah(EECore& cpu, CPUInstruction inst) {
+    int shift = inst.imm5 & 0xF;
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sra_epi16(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(shift)));
+#else
+    ParallelOp<s16>(cpu, inst, [shift](s16, s16 rt) -> s16 { return rt >> shift; });
+#endif
+}
+
+void EEInterpreter::psllw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sll_epi32(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(inst.imm5)));
+#else
+    int shift = inst.imm5;
+    ParallelOp<u32>(cpu, inst, [shift](u32, u32 rt) -> u32 { return rt << shift; });
+#endif
+}
+
+void EEInterpreter::psrlw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_srl_epi32(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(inst.imm5)));
+#else
+    int shift = inst.imm5;
+    ParallelOp<u32>(cpu, inst, [shift](u32, u32 rt) -> u32 { return rt >> shift; });
+#endif
+}
+
+void EEInterpreter::psraw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sra_epi32(GetVector(cpu, inst.rt), _mm_cvtsi32_si128(inst.imm5)));
+#else
+    int shift = inst.imm5;
+    ParallelOp<s32>(cpu, inst, [shift](s32, s32 rt) -> s32 { return rt >> shift; });
+#endif
+}
+
+// MMI0 instructions
+void EEInterpreter::paddw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_add_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 { return rs + rt; });
+#endif
+}
+
+void EEInterpreter::psubw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sub_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 { return rs - rt; });
+#endif
+}
+
+void EEInterpreter::pcgtw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpgt_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s32>(cpu, inst, [](s32 rs, s32 rt) -> s32 { return rs > rt ? -1 : 0; });
+#endif
+}
+
+#if defined(MMI_RUNTIME_SSE41)
+__attribute__((target("sse4.1"))) static void pmaxw_sse41(EECore& cpu, CPUInstruction inst) {
+    SetVector(cpu, inst.rd, _mm_max_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+}
+#endif
+
+void EEInterpreter::pmaxw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE4_1__)
+    SetVector(cpu, inst.rd, _mm_max_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#elif defined(__SSE2__)
+#if defined(MMI_RUNTIME_SSE41)
+    if (has_sse41) {
+        pmaxw_sse41(cpu, inst);
+        return;
+    }
+#endif
+
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i mask = _mm_cmpgt_epi32(rs, rt);
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_and_si128(mask, rs), _mm_andnot_si128(mask, rt)));
+#else
+    ParallelOp<s32>(cpu, inst, [](s32 rs, s32 rt) -> s32 { return rs > rt ? rs : rt; });
+#endif
+}
+
+void EEInterpreter::paddh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_add_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u16>(cpu, inst, [](u16 rs, u16 rt) -> u16 { return rs + rt; });
+#endif
+}
+
+void EEInterpreter::psubh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sub_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u16>(cpu, inst, [](u16 rs, u16 rt) -> u16 { return rs - rt; });
+#endif
+}
+
+void EEInterpreter::pcgth(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpgt_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16 rs, s16 rt) -> s16 { return rs > rt ? -1 : 0; });
+#endif
+}
+
+void EEInterpreter::pmaxh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_max_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16 rs, s16 rt) -> s16 { return rs > rt ? rs : rt; });
+#endif
+}
+
+void EEInterpreter::paddb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_add_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u8>(cpu, inst, [](u8 rs, u8 rt) -> u8 { return rs + rt; });
+#endif
+}
+
+void EEInterpreter::psubb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_sub_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u8>(cpu, inst, [](u8 rs, u8 rt) -> u8 { return rs - rt; });
+#endif
+}
+
+void EEInterpreter::pcgtb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpgt_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s8>(cpu, inst, [](s8 rs, s8 rt) -> s8 { return rs > rt ? -1 : 0; });
+#endif
+}
+
+void EEInterpreter::paddsw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i sum = _mm_add_epi32(rs, rt);
+
+    // the sum overflowed if its sign differs from both operands
+    __m128i overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(rs, sum), _mm_xor_si128(rt, sum)), 31);
+    __m128i saturated = _mm_xor_si128(_mm_srai_epi32(rs, 31), _mm_set1_epi32(0x7FFFFFFF));
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, sum)));
+#else
+    ParallelOp<s32>(cpu, inst, [](s32 rs, s32 rt) -> s32 { return Saturate<s32>(static_cast<s64>(rs) + rt); });
+#endif
+}
+
+void EEInterpreter::psubsw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i difference = _mm_sub_epi32(rs, rt);
+
+    // the difference overflowed if the operands had different signs
+    // and its sign differs from the first operand
+    __m128i overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(rs, rt), _mm_xor_si128(rs, difference)), 31);
+    __m128i saturated = _mm_xor_si128(_mm_srai_epi32(rs, 31), _mm_set1_epi32(0x7FFFFFFF));
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, difference)));
+#else
+    ParallelOp<s32>(cpu, inst, [](s32 rs, s32 rt) -> s32 { return Saturate<s32>(static_cast<s64>(rs) - rt); });
+#endif
+}
+
+void EEInterpreter::pextlw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi32(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[0], rs[0], rt[1], rs[1]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::ppacw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = _mm_shuffle_epi32(GetVector(cpu, inst.rs), 0x08);
+    __m128i rt = _mm_shuffle_epi32(GetVector(cpu, inst.rt), 0x08);
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi64(rt, rs));
+#else
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[0], rt[2], rs[0], rs[2]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::paddsh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_adds_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16 rs, s16 rt) -> s16 { return Saturate<s16>(rs + rt); });
+#endif
+}
+
+void EEInterpreter::psubsh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_subs_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16 rs, s16 rt) -> s16 { return Saturate<s16>(rs - rt); });
+#endif
+}
+
+void EEInterpreter::pextlh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi16(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u16> rs = GetLanes<u16>(cpu, inst.rs);
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i * 2] = rt[i];
+        rd[i * 2 + 1] = rs[i];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::ppach(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    // sign extending the low halfwords means packing them can't saturate
+    __m128i rs = _mm_srai_epi32(_mm_slli_epi32(GetVector(cpu, inst.rs), 16), 16);
+    __m128i rt = _mm_srai_epi32(_mm_slli_epi32(GetVector(cpu, inst.rt), 16), 16);
+    SetVector(cpu, inst.rd, _mm_packs_epi32(rt, rs));
+#else
+    Lanes<u16> rs = GetLanes<u16>(cpu, inst.rs);
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i] = rt[i * 2];
+        rd[i + 4] = rs[i * 2];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::paddsb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_adds_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s8>(cpu, inst, [](s8 rs, s8 rt) -> s8 { return Saturate<s8>(rs + rt); });
+#endif
+}
+
+void EEInterpreter::psubsb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_subs_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s8>(cpu, inst, [](s8 rs, s8 rt) -> s8 { return Saturate<s8>(rs - rt); });
+#endif
+}
+
+void EEInterpreter::pextlb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi8(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u8> rs = GetLanes<u8>(cpu, inst.rs);
+    Lanes<u8> rt = GetLanes<u8>(cpu, inst.rt);
+    Lanes<u8> rd;
+
+    for (int i = 0; i < 8; i++) {
+        rd[i * 2] = rt[i];
+        rd[i * 2 + 1] = rs[i];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::ppacb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i mask = _mm_set1_epi16(0xFF);
+    __m128i rs = _mm_and_si128(GetVector(cpu, inst.rs), mask);
+    __m128i rt = _mm_and_si128(GetVector(cpu, inst.rt), mask);
+    SetVector(cpu, inst.rd, _mm_packus_epi16(rt, rs));
+#else
+    Lanes<u8> rs = GetLanes<u8>(cpu, inst.rs);
+    Lanes<u8> rt = GetLanes<u8>(cpu, inst.rt);
+    Lanes<u8> rd;
+
+    for (int i = 0; i < 8; i++) {
+        rd[i] = rt[i * 2];
+        rd[i + 8] = rs[i * 2];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pext5(EECore& cpu, CPUInstruction inst) {
+    // expands 1:5:5:5 colours in the low halfword of each word to 8:8:8:8
+#if defined(__SSE2__)
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i r = _mm_slli_epi32(_mm_and_si128(rt, _mm_set1_epi32(0x1F)), 3);
+    __m128i g = _mm_slli_epi32(_mm_and_si128(rt, _mm_set1_epi32(0x3E0)), 6);
+    __m128i b = _mm_slli_epi32(_mm_and_si128(rt, _mm_set1_epi32(0x7C00)), 9);
+    __m128i a = _mm_slli_epi32(_mm_and_si128(rt, _mm_set1_epi32(0x8000)), 16);
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32, u32 rt) -> u32 {
+        return ((rt & 0x1F) << 3) | ((rt & 0x3E0) << 6) | ((rt & 0x7C00) << 9) | ((rt & 0x8000) << 16);
+    });
+#endif
+}
+
+void EEInterpreter::ppac5(EECore& cpu, CPUInstruction inst) {
+    // packs 8:8:8:8 colours in each word down to 1:5:5:5
+#if defined(__SSE2__)
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(rt, 3), _mm_set1_epi32(0x1F));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(rt, 6), _mm_set1_epi32(0x3E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(rt, 9), _mm_set1_epi32(0x7C00));
+    __m128i a = _mm_and_si128(_mm_srli_epi32(rt, 16), _mm_set1_epi32(0x8000));
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32, u32 rt) -> u32 {
+        return ((rt >> 3) & 0x1F) | ((rt >> 6) & 0x3E0) | ((rt >> 9) & 0x7C00) | ((rt >> 16) & 0x8000);
+    });
+#endif
+}
+
+// MMI1 instructions
+void EEInterpreter::pabsw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i sign = _mm_srai_epi32(rt, 31);
+    __m128i absolute = _mm_sub_epi32(_mm_xor_si128(rt, sign), sign);
+
+    // 0x80000000 saturates to 0x7FFFFFFF
+    absolute = _mm_add_epi32(absolute, _mm_cmpeq_epi32(absolute, _mm_set1_epi32(0x80000000)));
+    SetVector(cpu, inst.rd, absolute);
+#else
+    ParallelOp<s32>(cpu, inst, [](s32, s32 rt) -> s32 {
+        return rt == static_cast<s32>(0x80000000) ? 0x7FFFFFFF : (rt < 0 ? -rt : rt);
+    });
+#endif
+}
+
+void EEInterpreter::pceqw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpeq_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 { return rs == rt ? 0xFFFFFFFF : 0; });
+#endif
+}
+
+#if defined(MMI_RUNTIME_SSE41)
+__attribute__((target("sse4.1"))) static void pminw_sse41(EECore& cpu, CPUInstruction inst) {
+    SetVector(cpu, inst.rd, _mm_min_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+}
+#endif
+
+void EEInterpreter::pminw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE4_1__)
+    SetVector(cpu, inst.rd, _mm_min_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#elif defined(__SSE2__)
+#if defined(MMI_RUNTIME_SSE41)
+    if (has_sse41) {
+        pminw_sse41(cpu, inst);
+        return;
+    }
+#endif
+
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i mask = _mm_cmpgt_epi32(rs, rt);
+    SetVector(cpu, inst.rd, _mm_or_si128(_mm_and_si128(mask, rt), _mm_andnot_si128(mask, rs)));
+#else
+    ParallelOp<s32>(cpu, inst, [](s32 rs, s32 rt) -> s32 { return rs < rt ? rs : rt; });
+#endif
+}
+
+void EEInterpreter::padsbh(EECore& cpu, CPUInstruction inst) {
+    // the lower 4 halfwords are subtracted and the upper 4 are added
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i difference = _mm_sub_epi16(rs, rt);
+    __m128i sum = _mm_add_epi16(rs, rt);
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi64(difference, _mm_unpackhi_epi64(sum, sum)));
+#else
+    Lanes<u16> rs = GetLanes<u16>(cpu, inst.rs);
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i] = rs[i] - rt[i];
+        rd[i + 4] = rs[i + 4] + rt[i + 4];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pabsh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    // a saturated negation means 0x8000 becomes 0x7FFF
+    __m128i rt = GetVector(cpu, inst.rt);
+    SetVector(cpu, inst.rd, _mm_max_epi16(rt, _mm_subs_epi16(_mm_setzero_si128(), rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16, s16 rt) -> s16 { return rt == -0x8000 ? 0x7FFF : (rt < 0 ? -rt : rt); });
+#endif
+}
+
+void EEInterpreter::pceqh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpeq_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u16>(cpu, inst, [](u16 rs, u16 rt) -> u16 { return rs == rt ? 0xFFFF : 0; });
+#endif
+}
+
+void EEInterpreter::pminh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_min_epi16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<s16>(cpu, inst, [](s16 rs, s16 rt) -> s16 { return rs < rt ? rs : rt; });
+#endif
+}
+
+void EEInterpreter::pceqb(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_cmpeq_epi8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u8>(cpu, inst, [](u8 rs, u8 rt) -> u8 { return rs == rt ? 0xFF : 0; });
+#endif
+}
+
+void EEInterpreter::padduw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i sum = _mm_add_epi32(rs, rt);
+
+    // sse2 only has signed compares, so flip the sign bits for an unsigned one
+    __m128i sign = _mm_set1_epi32(0x80000000);
+    __m128i overflow = _mm_cmpgt_epi32(_mm_xor_si128(rs, sign), _mm_xor_si128(sum, sign));
+    SetVector(cpu, inst.rd, _mm_or_si128(sum, overflow));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 {
+        u64 result = static_cast<u64>(rs) + rt;
+        return result > 0xFFFFFFFF ? 0xFFFFFFFF : result;
+    });
+#endif
+}
+
+void EEInterpreter::psubuw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i sign = _mm_set1_epi32(0x80000000);
+    __m128i underflow = _mm_cmpgt_epi32(_mm_xor_si128(rt, sign), _mm_xor_si128(rs, sign));
+    SetVector(cpu, inst.rd, _mm_andnot_si128(underflow, _mm_sub_epi32(rs, rt)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 { return rt > rs ? 0 : rs - rt; });
+#endif
+}
+
+void EEInterpreter::pextuw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpackhi_epi32(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[2], rs[2], rt[3], rs[3]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::padduh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_adds_epu16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u16>(cpu, inst, [](u16 rs, u16 rt) -> u16 { return rs + rt > 0xFFFF ? 0xFFFF : rs + rt; });
+#endif
+}
+
+void EEInterpreter::psubuh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_subs_epu16(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u16>(cpu, inst, [](u16 rs, u16 rt) -> u16 { return rt > rs ? 0 : rs - rt; });
+#endif
+}
+
+void EEInterpreter::pextuh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpackhi_epi16(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u16> rs = GetLanes<u16>(cpu, inst.rs);
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i * 2] = rt[i + 4];
+        rd[i * 2 + 1] = rs[i + 4];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::paddub(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_adds_epu8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u8>(cpu, inst, [](u8 rs, u8 rt) -> u8 { return rs + rt > 0xFF ? 0xFF : rs + rt; });
+#endif
+}
+
+void EEInterpreter::psubub(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_subs_epu8(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u8>(cpu, inst, [](u8 rs, u8 rt) -> u8 { return rt > rs ? 0 : rs - rt; });
+#endif
+}
+
+void EEInterpreter::pextub(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpackhi_epi8(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u8> rs = GetLanes<u8>(cpu, inst.rs);
+    Lanes<u8> rt = GetLanes<u8>(cpu, inst.rt);
+    Lanes<u8> rd;
+
+    for (int i = 0; i < 8; i++) {
+        rd[i * 2] = rt[i + 8];
+        rd[i * 2 + 1] = rs[i + 8];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::qfsrv(EECore& cpu, CPUInstruction inst) {
+    // shifts the 256 bit value rs:rt right by the number of bytes in sa
+    u8 data[32];
+    memcpy(&data[0], &cpu.gpr[inst.rt * 16], 16);
+    memcpy(&data[16], &cpu.gpr[inst.rs * 16], 16);
+
+    if (inst.rd) {
+        memcpy(&cpu.gpr[inst.rd * 16], &data[cpu.sa & 0xF], 16);
+    }
+}
+
+// MMI2 instructions
+void EEInterpreter::pmaddw(EECore& cpu, CPUInstruction inst) {
+    Lanes<s32> rs = GetLanes<s32>(cpu, inst.rs);
+    Lanes<s32> rt = GetLanes<s32>(cpu, inst.rt);
+    Lanes<u64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        u64 result = GetParallelHILO(cpu, i) + static_cast<s64>(rs[i * 2]) * rt[i * 2];
+        SetParallelHILO(cpu, i, result, result >> 32);
+        rd[i] = result;
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::psllvw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        rd[i] = sign_extend<s64, 32>(rt[i * 2] << (rs[i * 2] & 0x1F));
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::psrlvw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        rd[i] = sign_extend<s64, 32>(rt[i * 2] >> (rs[i * 2] & 0x1F));
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::pmsubw(EECore& cpu, CPUInstruction inst) {
+    Lanes<s32> rs = GetLanes<s32>(cpu, inst.rs);
+    Lanes<s32> rt = GetLanes<s32>(cpu, inst.rt);
+    Lanes<u64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        u64 result = GetParallelHILO(cpu, i) - static_cast<s64>(rs[i * 2]) * rt[i * 2];
+        SetParallelHILO(cpu, i, result, result >> 32);
+        rd[i] = result;
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::pmfhi(EECore& cpu, CPUInstruction inst) {
+    cpu.SetReg<u64>(inst.rd, cpu.hi, 0);
+    cpu.SetReg<u64>(inst.rd, cpu.hi1, 1);
+}
+
+void EEInterpreter::pmflo(EECore& cpu, CPUInstruction inst) {
+    cpu.SetReg<u64>(inst.rd, cpu.lo, 0);
+    cpu.SetReg<u64>(inst.rd, cpu.lo1, 1);
+}
+
+void EEInterpreter::pinth(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi16(GetVector(cpu, inst.rt), _mm_unpackhi_epi64(rs, rs)));
+#else
+    Lanes<u16> rs = GetLanes<u16>(cpu, inst.rs);
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i * 2] = rt[i];
+        rd[i * 2 + 1] = rs[i + 4];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+#if defined(MMI_RUNTIME_SSE41)
+__attribute__((target("sse4.1"))) static __m128i MultiplyWordsSSE41(__m128i a, __m128i b) {
+    return _mm_mul_epi32(a, b);
+}
+#endif
+
+void EEInterpreter::pmultw(EECore& cpu, CPUInstruction inst) {
+    Lanes<s64> rd;
+
+#if defined(__SSE4_1__)
+    __m128i products = _mm_mul_epi32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt));
+    memcpy(rd.data, &products, 16);
+#else
+#if defined(MMI_RUNTIME_SSE41)
+    if (has_sse41) {
+        __m128i products = MultiplyWordsSSE41(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt));
+        memcpy(rd.data, &products, 16);
+    } else
+#endif
+    {
+        Lanes<s32> rs = GetLanes<s32>(cpu, inst.rs);
+        Lanes<s32> rt = GetLanes<s32>(cpu, inst.rt);
+
+        for (int i = 0; i < 2; i++) {
+            rd[i] = static_cast<s64>(rs[i * 2]) * rt[i * 2];
+        }
+    }
+#endif
+
+    for (int i = 0; i < 2; i++) {
+        SetParallelHILO(cpu, i, rd[i], rd[i] >> 32);
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::pdivw(EECore& cpu, CPUInstruction inst) {
+    Lanes<s32> rs = GetLanes<s32>(cpu, inst.rs);
+    Lanes<s32> rt = GetLanes<s32>(cpu, inst.rt);
+
+    for (int i = 0; i < 2; i++) {
+        u32 quotient;
+        u32 remainder;
+        SignedDivide(rs[i * 2], rt[i * 2], quotient, remainder);
+        SetParallelHILO(cpu, i, quotient, remainder);
+    }
+}
+
+void EEInterpreter::pcpyld(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi64(GetVector(cpu, inst.rt), GetVector(cpu, inst.rs)));
+#else
+    Lanes<u64> rs = GetLanes<u64>(cpu, inst.rs);
+    Lanes<u64> rt = GetLanes<u64>(cpu, inst.rt);
+    Lanes<u64> rd = {{rt[0], rs[0]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+// products 0, 1, 4 and 5 of the halfword multiplies go into lo
+// and products 2, 3, 6 and 7 go into hi
+void EEInterpreter::pmaddh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i products_low;
+    __m128i products_high;
+    MultiplyHalfwords(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt), products_low, products_high);
+
+    __m128i lo = _mm_add_epi32(CombineVector(cpu.lo, cpu.lo1), _mm_unpacklo_epi64(products_low, products_high));
+    __m128i hi = _mm_add_epi32(CombineVector(cpu.hi, cpu.hi1), _mm_unpackhi_epi64(products_low, products_high));
+    SplitVector(lo, cpu.lo, cpu.lo1);
+    SplitVector(hi, cpu.hi, cpu.hi1);
+    SetVector(cpu, inst.rd, InterleaveHILO(lo, hi));
+#else
+    Lanes<s16> rs = GetLanes<s16>(cpu, inst.rs);
+    Lanes<s16> rt = GetLanes<s16>(cpu, inst.rt);
+    Lanes<u32> lo = Combine<u32>(cpu.lo, cpu.lo1);
+    Lanes<u32> hi = Combine<u32>(cpu.hi, cpu.hi1);
+
+    for (int i = 0; i < 8; i++) {
+        Lanes<u32>& accumulator = (i & 0x2) ? hi : lo;
+        accumulator[((i >> 1) & 0x2) | (i & 0x1)] += rs[i] * rt[i];
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+
+    Lanes<u32> rd = {{lo[0], hi[0], lo[2], hi[2]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::phmadh(EECore& cpu, CPUInstruction inst) {
+    // each pair of halfword products is summed into words 0 and 2 of lo and hi,
+    // while words 1 and 3 are left with the odd products
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i sums = _mm_madd_epi16(rs, rt);
+    __m128i odd = _mm_madd_epi16(rs, _mm_and_si128(rt, _mm_set1_epi32(0xFFFF0000)));
+    __m128i low_words = _mm_unpacklo_epi32(sums, odd);
+    __m128i high_words = _mm_unpackhi_epi32(sums, odd);
+
+    SplitVector(_mm_unpacklo_epi64(low_words, high_words), cpu.lo, cpu.lo1);
+    SplitVector(_mm_unpackhi_epi64(low_words, high_words), cpu.hi, cpu.hi1);
+    SetVector(cpu, inst.rd, sums);
+#else
+    Lanes<s16> rs = GetLanes<s16>(cpu, inst.rs);
+    Lanes<s16> rt = GetLanes<s16>(cpu, inst.rt);
+    Lanes<u32> lo;
+    Lanes<u32> hi;
+    Lanes<u32> rd;
+
+    for (int i = 0; i < 4; i++) {
+        u32 odd = rs[i * 2 + 1] * rt[i * 2 + 1];
+        u32 sum = odd + static_cast<u32>(rs[i * 2] * rt[i * 2]);
+        Lanes<u32>& accumulator = (i & 0x1) ? hi : lo;
+        accumulator[(i & 0x2)] = sum;
+        accumulator[(i & 0x2) + 1] = odd;
+        rd[i] = sum;
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pand(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_and_si128(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u64>(cpu, inst, [](u64 rs, u64 rt) -> u64 { return rs & rt; });
+#endif
+}
+
+void EEInterpreter::pxor(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_xor_si128(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u64>(cpu, inst, [](u64 rs, u64 rt) -> u64 { return rs ^ rt; });
+#endif
+}
+
+void EEInterpreter::pmsubh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i products_low;
+    __m128i products_high;
+    MultiplyHalfwords(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt), products_low, products_high);
+
+    __m128i lo = _mm_sub_epi32(CombineVector(cpu.lo, cpu.lo1), _mm_unpacklo_epi64(products_low, products_high));
+    __m128i hi = _mm_sub_epi32(CombineVector(cpu.hi, cpu.hi1), _mm_unpackhi_epi64(products_low, products_high));
+    SplitVector(lo, cpu.lo, cpu.lo1);
+    SplitVector(hi, cpu.hi, cpu.hi1);
+    SetVector(cpu, inst.rd, InterleaveHILO(lo, hi));
+#else
+    Lanes<s16> rs = GetLanes<s16>(cpu, inst.rs);
+    Lanes<s16> rt = GetLanes<s16>(cpu, inst.rt);
+    Lanes<u32> lo = Combine<u32>(cpu.lo, cpu.lo1);
+    Lanes<u32> hi = Combine<u32>(cpu.hi, cpu.hi1);
+
+    for (int i = 0; i < 8; i++) {
+        Lanes<u32>& accumulator = (i & 0x2) ? hi : lo;
+        accumulator[((i >> 1) & 0x2) | (i & 0x1)] -= rs[i] * rt[i];
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+
+    Lanes<u32> rd = {{lo[0], hi[0], lo[2], hi[2]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::phmsbh(EECore& cpu, CPUInstruction inst) {
+    // the same as phmadh, except the even products are subtracted
+    // and words 1 and 3 are left with the inverted odd products
+#if defined(__SSE2__)
+    __m128i rs = GetVector(cpu, inst.rs);
+    __m128i rt = GetVector(cpu, inst.rt);
+    __m128i odd = _mm_madd_epi16(rs, _mm_and_si128(rt, _mm_set1_epi32(0xFFFF0000)));
+    __m128i even = _mm_madd_epi16(rs, _mm_and_si128(rt, _mm_set1_epi32(0xFFFF)));
+    __m128i differences = _mm_sub_epi32(odd, even);
+    __m128i inverted = _mm_xor_si128(odd, _mm_set1_epi32(0xFFFFFFFF));
+    __m128i low_words = _mm_unpacklo_epi32(differences, inverted);
+    __m128i high_words = _mm_unpackhi_epi32(differences, inverted);
+
+    SplitVector(_mm_unpacklo_epi64(low_words, high_words), cpu.lo, cpu.lo1);
+    SplitVector(_mm_unpackhi_epi64(low_words, high_words), cpu.hi, cpu.hi1);
+    SetVector(cpu, inst.rd, differences);
+#else
+    Lanes<s16> rs = GetLanes<s16>(cpu, inst.rs);
+    Lanes<s16> rt = GetLanes<s16>(cpu, inst.rt);
+    Lanes<u32> lo;
+    Lanes<u32> hi;
+    Lanes<u32> rd;
+
+    for (int i = 0; i < 4; i++) {
+        u32 odd = rs[i * 2 + 1] * rt[i * 2 + 1];
+        u32 difference = odd - static_cast<u32>(rs[i * 2] * rt[i * 2]);
+        Lanes<u32>& accumulator = (i & 0x1) ? hi : lo;
+        accumulator[(i & 0x2)] = difference;
+        accumulator[(i & 0x2) + 1] = ~odd;
+        rd[i] = difference;
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pexeh(EECore& cpu, CPUInstruction inst) {
+    // swaps halfwords 0 and 2 of each doubleword
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shufflehi_epi16(_mm_shufflelo_epi16(GetVector(cpu, inst.rt), 0xC6), 0xC6));
+#else
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd = {{rt[2], rt[1], rt[0], rt[3], rt[6], rt[5], rt[4], rt[7]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::prevh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shufflehi_epi16(_mm_shufflelo_epi16(GetVector(cpu, inst.rt), 0x1B), 0x1B));
+#else
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd = {{rt[3], rt[2], rt[1], rt[0], rt[7], rt[6], rt[5], rt[4]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pmulth(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i products_low;
+    __m128i products_high;
+    MultiplyHalfwords(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt), products_low, products_high);
+
+    SplitVector(_mm_unpacklo_epi64(products_low, products_high), cpu.lo, cpu.lo1);
+    SplitVector(_mm_unpackhi_epi64(products_low, products_high), cpu.hi, cpu.hi1);
+    SetVector(cpu, inst.rd, _mm_unpacklo_epi64(_mm_shuffle_epi32(products_low, 0x08), _mm_shuffle_epi32(products_high, 0x08)));
+#else
+    Lanes<s16> rs = GetLanes<s16>(cpu, inst.rs);
+    Lanes<s16> rt = GetLanes<s16>(cpu, inst.rt);
+    Lanes<u32> lo;
+    Lanes<u32> hi;
+    Lanes<u32> rd;
+
+    for (int i = 0; i < 8; i++) {
+        Lanes<u32>& accumulator = (i & 0x2) ? hi : lo;
+        u32 product = rs[i] * rt[i];
+        accumulator[((i >> 1) & 0x2) | (i & 0x1)] = product;
+
+        if ((i & 0x1) == 0) {
+            rd[i >> 1] = product;
+        }
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pdivbw(EECore& cpu, CPUInstruction inst) {
+    Lanes<s32> rs = GetLanes<s32>(cpu, inst.rs);
+    s16 divisor = cpu.GetReg<s16>(inst.rt);
+    Lanes<u32> lo;
+    Lanes<u32> hi;
+
+    for (int i = 0; i < 4; i++) {
+        SignedDivide(rs[i], divisor, lo[i], hi[i]);
+    }
+
+    Split(lo, cpu.lo, cpu.lo1);
+    Split(hi, cpu.hi, cpu.hi1);
+}
+
+void EEInterpreter::pexew(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shuffle_epi32(GetVector(cpu, inst.rt), 0xC6));
+#else
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[2], rt[1], rt[0], rt[3]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::prot3w(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shuffle_epi32(GetVector(cpu, inst.rt), 0xC9));
+#else
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[1], rt[2], rt[0], rt[3]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+// MMI3 instructions
+void EEInterpreter::pmadduw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        u64 result = GetParallelHILO(cpu, i) + static_cast<u64>(rs[i * 2]) * rt[i * 2];
+        SetParallelHILO(cpu, i, result, result >> 32);
+        rd[i] = result;
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::psravw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<s32> rt = GetLanes<s32>(cpu, inst.rt);
+    Lanes<s64> rd;
+
+    for (int i = 0; i < 2; i++) {
+        rd[i] = rt[i * 2] >> (rs[i * 2] & 0x1F);
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::pmthi(EECore& cpu, CPUInstruction inst) {
+    cpu.hi = cpu.GetReg<u64>(inst.rs, 0);
+    cpu.hi1 = cpu.GetReg<u64>(inst.rs, 1);
+}
+
+void EEInterpreter::pmtlo(EECore& cpu, CPUInstruction inst) {
+    cpu.lo = cpu.GetReg<u64>(inst.rs, 0);
+    cpu.lo1 = cpu.GetReg<u64>(inst.rs, 1);
+}
+
+void EEInterpreter::pinteh(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i rt = _mm_and_si128(GetVector(cpu, inst.rt), _mm_set1_epi32(0xFFFF));
+    SetVector(cpu, inst.rd, _mm_or_si128(rt, _mm_slli_epi32(GetVector(cpu, inst.rs), 16)));
+#else
+    ParallelOp<u32>(cpu, inst, [](u32 rs, u32 rt) -> u32 { return (rt & 0xFFFF) | (rs << 16); });
+#endif
+}
+
+void EEInterpreter::pmultuw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u64> rd;
+
+#if defined(__SSE2__)
+    __m128i products = _mm_mul_epu32(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt));
+    memcpy(rd.data, &products, 16);
+#else
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+
+    for (int i = 0; i < 2; i++) {
+        rd[i] = static_cast<u64>(rs[i * 2]) * rt[i * 2];
+    }
+#endif
+
+    for (int i = 0; i < 2; i++) {
+        SetParallelHILO(cpu, i, rd[i], rd[i] >> 32);
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+}
+
+void EEInterpreter::pdivuw(EECore& cpu, CPUInstruction inst) {
+    Lanes<u32> rs = GetLanes<u32>(cpu, inst.rs);
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+
+    for (int i = 0; i < 2; i++) {
+        if (rt[i * 2]) {
+            SetParallelHILO(cpu, i, rs[i * 2] / rt[i * 2], rs[i * 2] % rt[i * 2]);
+        } else {
+            SetParallelHILO(cpu, i, 0xFFFFFFFF, rs[i * 2]);
+        }
+    }
+}
+
+void EEInterpreter::pcpyud(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_unpackhi_epi64(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    Lanes<u64> rs = GetLanes<u64>(cpu, inst.rs);
+    Lanes<u64> rt = GetLanes<u64>(cpu, inst.rt);
+    Lanes<u64> rd = {{rs[1], rt[1]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::por(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_or_si128(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt)));
+#else
+    ParallelOp<u64>(cpu, inst, [](u64 rs, u64 rt) -> u64 { return rs | rt; });
+#endif
+}
+
+void EEInterpreter::pnor(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    __m128i result = _mm_or_si128(GetVector(cpu, inst.rs), GetVector(cpu, inst.rt));
+    SetVector(cpu, inst.rd, _mm_xor_si128(result, _mm_set1_epi32(0xFFFFFFFF)));
+#else
+    ParallelOp<u64>(cpu, inst, [](u64 rs, u64 rt) -> u64 { return ~(rs | rt); });
+#endif
+}
+
+void EEInterpreter::pexch(EECore& cpu, CPUInstruction inst) {
+    // swaps halfwords 1 and 2 of each doubleword
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shufflehi_epi16(_mm_shufflelo_epi16(GetVector(cpu, inst.rt), 0xD8), 0xD8));
+#else
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd = {{rt[0], rt[2], rt[1], rt[3], rt[4], rt[6], rt[5], rt[7]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pcpyh(EECore& cpu, CPUInstruction inst) {
+    // copies halfword 0 of each doubleword across the whole doubleword
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shufflehi_epi16(_mm_shufflelo_epi16(GetVector(cpu, inst.rt), 0x00), 0x00));
+#else
+    Lanes<u16> rt = GetLanes<u16>(cpu, inst.rt);
+    Lanes<u16> rd;
+
+    for (int i = 0; i < 4; i++) {
+        rd[i] = rt[0];
+        rd[i + 4] = rt[4];
+    }
+
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
+
+void EEInterpreter::pexcw(EECore& cpu, CPUInstruction inst) {
+#if defined(__SSE2__)
+    SetVector(cpu, inst.rd, _mm_shuffle_epi32(GetVector(cpu, inst.rt), 0xD8));
+#else
+    Lanes<u32> rt = GetLanes<u32>(cpu, inst.rt);
+    Lanes<u32> rd = {{rt[0], rt[2], rt[1], rt[3]}};
+    SetLanes(cpu, inst.rd, rd);
+#endif
+}
\ No newline at end of file
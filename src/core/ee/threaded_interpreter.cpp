@@ -0,0 +1,134 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string.h>
+#include "core/ee/threaded_interpreter.h"
+#include "core/ee/ee_core.h"
+#include "core/ee/ee_interpreter.h"
+#include "core/ee/instruction_list.h"
+#include "core/system.h"
+
+EEThreadedInterpreter::EEThreadedInterpreter(EECore& cpu) : cpu(cpu) {}
+
+inline u32 EEThreadedInterpreter::Fetch() {
+    if ((cpu.pc >> 12) != fetch_page) {
+        UpdateFetchPage();
+    }
+
+    if (fetch_pointer) {
+        u32 data;
+        memcpy(&data, fetch_pointer + (cpu.pc & 0xFFF), sizeof(u32));
+        return data;
+    }
+
+    return cpu.ReadWord(cpu.pc);
+}
+
+void EEThreadedInterpreter::UpdateFetchPage() {
+    Memory& memory = cpu.system.memory;
+
+    fetch_page = cpu.pc >> 12;
+    fetch_pointer = memory.ee_map.GetReadPage(memory.TranslateVirtualAddress(cpu.pc));
+}
+
+void EEThreadedInterpreter::InvalidateFetchPage() {
+    fetch_page = 0xFFFFFFFF;
+}
+
+#if defined(__GNUC__)
+
+void EEThreadedInterpreter::Run() {
+    static std::array<void*, InterpreterTable::NUM_INSTRUCTIONS> dispatch_table;
+    static std::atomic<bool> dispatch_table_generated = false;
+    static std::mutex dispatch_table_mutex;
+
+    // several systems can be running on different threads, so only one of them gets to fill the table
+    if (!dispatch_table_generated.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(dispatch_table_mutex);
+
+        if (!dispatch_table_generated.load(std::memory_order_relaxed)) {
+            dispatch_table.fill(&&unknown_instruction);
+
+            for (int i = 0; i < 32; i++) {
+                dispatch_table[InterpreterTable::GetTableOffset(InstructionTable::COP2) + i] = &&stub_instruction;
+            }
+
+#define REGISTER_LABEL(name, table, index) \
+            dispatch_table[InterpreterTable::GetTableOffset(InstructionTable::table) + index] = &&op_##name;
+            EE_INSTRUCTION_LIST(REGISTER_LABEL)
+#undef REGISTER_LABEL
+
+            dispatch_table_generated.store(true, std::memory_order_release);
+        }
+    }
+
+    // keeping the core in a local saves going through this on every instruction
+    EECore& cpu = this->cpu;
+    CPUInstruction inst;
+
+// finishes off the current instruction, then fetches
+// the next one and jumps straight to its handler
+#define DISPATCH() \
+    cpu.pc += 4; \
+    if (cpu.branch_delay) { \
+        cpu.UpdateBranchDelay(); \
+    } \
+    if (cpu.interrupt_pending) { \
+        cpu.CheckInterrupts(); \
+    } \
+    if (--cpu.cycles_left <= 0 || cpu.idle) { \
+        goto done; \
+    } \
+    inst = CPUInstruction{Fetch()}; \
+    cpu.inst = inst; \
+    goto *dispatch_table[InterpreterTable::GetInstructionIndex(inst)];
+
+    if (cpu.cycles_left <= 0) {
+        return;
+    }
+
+    fetch_page = 0xFFFFFFFF;
+    inst = CPUInstruction{Fetch()};
+    cpu.inst = inst;
+    goto *dispatch_table[InterpreterTable::GetInstructionIndex(inst)];
+
+#define HANDLER_LABEL(name, table, index) \
+op_##name: \
+    EEInterpreter::name(cpu, inst); \
+    DISPATCH();
+    EE_INSTRUCTION_LIST(HANDLER_LABEL)
+#undef HANDLER_LABEL
+
+unknown_instruction:
+    EEInterpreter::unknown_instruction(cpu, inst);
+    DISPATCH();
+
+stub_instruction:
+    EEInterpreter::stub_instruction(cpu, inst);
+    DISPATCH();
+
+#undef DISPATCH
+
+done:
+    if (cpu.idle) {
+        cpu.SkipIdleCycles(cpu.cycles_left);
+        cpu.cycles_left = 0;
+    }
+}
+
+#else
+
+void EEThreadedInterpreter::Run() {
+    while (cpu.cycles_left > 0) {
+        cpu.InterpretInstruction();
+        cpu.cycles_left--;
+
+        if (cpu.idle) {
+            cpu.SkipIdleCycles(cpu.cycles_left);
+            cpu.cycles_left = 0;
+            break;
+        }
+    }
+}
+
+#endif
\ No newline at end of file
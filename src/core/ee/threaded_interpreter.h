@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/types.h"
+
+class EECore;
+
+// the same as the interpreter, except each handler is called directly and
+// then jumps straight to the next one through a computed goto. this gives every
+// handler its own indirect branch to the next instruction, which the host cpu can
+// predict far better than a single shared one. on compilers without computed
+// gotos this falls back to the normal interpreter.
+// instructions are fetched straight from a host pointer to the current code
+// page rather than through the memory map, which is where most of the
+// interpreter's time goes otherwise
+class EEThreadedInterpreter {
+public:
+    EEThreadedInterpreter(EECore& cpu);
+
+    void Run();
+    void InvalidateFetchPage();
+
+private:
+    u32 Fetch();
+    void UpdateFetchPage();
+
+    EECore& cpu;
+
+    // the virtual page that fetch_pointer points to. this is refreshed
+    // on every run and whenever the tlb changes, so mappings can't change from under it
+    u32 fetch_page = 0xFFFFFFFF;
+    u8* fetch_pointer = nullptr;
+};
\ No newline at end of file
@@ -1,8 +1,13 @@
+#include <algorithm>
+#include <limits>
 #include "common/log_file.h"
 #include "core/ee/timers.h"
 #include "core/system.h"
+#include "core/timing.h"
 
-Timers::Timers(System& system) : system(system) {}
+Timers::Timers(System& system) : system(system) {
+    interrupt_kind = system.scheduler.RegisterEvent<&Timers::InterruptEvent>(this, "EE Timer Interrupt");
+}
 
 void Timers::Reset() {
     for (int i = 0; i < 4; i++) {
@@ -10,17 +15,13 @@ void Timers::Reset() {
         channels[i].control = 0;
         channels[i].compare = 0;
         channels[i].hold = 0;
-        channels[i].cycles = 0;
-        channels[i].cycles_per_tick = 0;
-    }
-}
+        channels[i].timestamp = 0;
+        channels[i].cycles_per_tick = 2;
 
-void Timers::Run(int cycles) {
-    for (int i = 0; i < 4; i++) {
-        if (channels[i].control & (1 << 7)) {
-            channels[i].cycles += cycles;
-            Increment(i);
-        }
+        // the scheduler has already been reset, so there's nothing to cancel
+        channels[i].interrupt_event = Scheduler::INVALID_EVENT;
+        channels[i].compare_time = std::numeric_limits<u64>::max();
+        channels[i].overflow_time = std::numeric_limits<u64>::max();
     }
 }
 
@@ -28,10 +29,17 @@ u32 Timers::ReadRegister(u32 addr) {
     int index = (addr >> 11) & 0x3;
 
     switch (addr & 0xFF) {
+    case 0x00:
+        Sync(index, system.ee_core.GetCurrentTime());
+        return channels[index].counter;
     case 0x10:
         return channels[index].control;
     case 0x14:
         return 0;
+    case 0x20:
+        return channels[index].compare;
+    case 0x30:
+        return channels[index].hold;
     default:
         log_fatal("[Timers] handle %02x", addr & 0xFF);
     }
@@ -39,45 +47,42 @@ u32 Timers::ReadRegister(u32 addr) {
 
 void Timers::WriteRegister(u32 addr, u32 data) {
     int index = (addr >> 11) & 0x3;
+    TimerChannel& channel = channels[index];
+
+    // the counter has to be brought up to date using the old state before anything changes
+    Sync(index, system.ee_core.GetCurrentTime());
 
     switch (addr & 0xFF) {
     case 0x00:
-        log_debug("[Timer] T%d TN_COUNT write %04x", index, data);
-        channels[index].counter = data;
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d TN_COUNT write %04x\n", index, data);
+        channel.counter = data & 0xFFFF;
         break;
     case 0x4:
         break;
     case 0x10:
-        log_debug("[Timer] T%d TN_MODE write %04x", index, data);
-        channels[index].control = data;
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d TN_MODE write %04x\n", index, data);
 
-        // writing 1 to bit 10 or 11 clears them
-        if (data & (1 << 10)) {
-            channels[index].control &= ~(1 << 10);
-        }
+        // writing 1 to bit 10 or 11 clears them, and writing 0 leaves them alone
+        channel.control = (data & ~0xC00) | (channel.control & ~data & 0xC00);
 
-        if (data & (1 << 11)) {
-            channels[index].control &= ~(1 << 11);
-        }
-
-        // update how many timer cycles are required to increment the corresponding channel
+        // update how many ee cycles are required to increment the corresponding channel
         // counter by 1
-        switch (channels[index].control & 0x3) {
+        switch (channel.control & 0x3) {
         case 0:
             // bus clock
-            channels[index].cycles_per_tick = 1;
+            channel.cycles_per_tick = 2;
             break;
         case 1:
             // bus clock / 16
-            channels[index].cycles_per_tick = 16;
+            channel.cycles_per_tick = 2 * 16;
             break;
         case 2:
             // bus block / 256
-            channels[index].cycles_per_tick = 256;
+            channel.cycles_per_tick = 2 * 256;
             break;
         case 3:
             // hblank
-            channels[index].cycles_per_tick = 9370;
+            channel.cycles_per_tick = HBLANK_CYCLES;
             break;
         }
 
@@ -85,77 +90,144 @@ void Timers::WriteRegister(u32 addr, u32 data) {
     case 0x14:
         break;
     case 0x20:
-        log_debug("[Timer] T%d TN_COMP write %04x", index, data);
-        channels[index].compare = data;
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d TN_COMP write %04x\n", index, data);
+        channel.compare = data;
         break;
     case 0x30:
-        log_debug("[Timer] T%d TN_HOLD write %04x", index, data);
-        channels[index].hold = data;
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d TN_HOLD write %04x\n", index, data);
+        channel.hold = data;
         break;
     default:
         log_fatal("[Timer] handle address %08x", addr);
     }
+
+    ScheduleInterrupt(index);
 }
 
-u32 Timers::ReadChannel(u32 addr) {
-    int reg = (addr >> 4) & 0xF;
+void Timers::Sync(int index, u64 now) {
+    TimerChannel& channel = channels[index];
 
-    switch (reg) {
-    default:
-        log_fatal("handle reg %d", reg);
+    // never go past an interrupt that hasn't been raised yet. its event
+    // brings the counter up to the time it's due and raises it from there
+    now = std::min({now, channel.compare_time, channel.overflow_time});
+
+    // the ee can be slightly ahead of the scheduler, so the counter
+    // might already be further along than the time we're given
+    if (now <= channel.timestamp) {
+        return;
+    }
+
+    if (channel.control & (1 << 7)) {
+        // ticks happen on multiples of the tick length, rather than relative to when the counter started
+        Advance(channel, (now / channel.cycles_per_tick) - (channel.timestamp / channel.cycles_per_tick));
+    }
+
+    channel.timestamp = now;
+}
+
+void Timers::Advance(TimerChannel& channel, u64 ticks) {
+    // with zero return set the counter goes back to 0 when it reaches compare, otherwise when it overflows
+    bool zero_return = (channel.control & (1 << 6)) && channel.compare;
+
+    while (ticks) {
+        u64 limit = (zero_return && channel.counter < channel.compare) ? channel.compare : 0x10000;
+
+        if (channel.counter + ticks < limit) {
+            channel.counter += ticks;
+            return;
+        }
+
+        ticks -= limit - channel.counter;
+        channel.counter = 0;
+
+        // after wrapping the counter goes round the same cycle,
+        // so any whole cycles left over can be skipped
+        ticks %= zero_return ? channel.compare : 0x10000;
     }
+}
 
-    return 0;
+u64 Timers::GetTickTime(TimerChannel& channel, u64 ticks) {
+    return ((channel.timestamp / channel.cycles_per_tick) + ticks) * channel.cycles_per_tick;
 }
 
-void Timers::Increment(int index) {
-    // if enough ticks have passed then we can increment the timer counter by 1
-    if (channels[index].cycles >= channels[index].cycles_per_tick) {
-        channels[index].cycles -= channels[index].cycles_per_tick;
-    } else {
-        // don't do any further calculations as
-        // counter wouldn't have changed
+void Timers::ScheduleInterrupt(int index) {
+    TimerChannel& channel = channels[index];
+    Scheduler& scheduler = system.scheduler;
+
+    scheduler.Cancel(channel.interrupt_event);
+    channel.interrupt_event = Scheduler::INVALID_EVENT;
+    channel.compare_time = std::numeric_limits<u64>::max();
+    channel.overflow_time = std::numeric_limits<u64>::max();
+
+    if (!(channel.control & (1 << 7))) {
         return;
     }
 
-    channels[index].counter++;
+    // timer interrupts are edge triggered, meaning they can only be
+    // requested if either interrupt bit goes from 0 to 1
+    bool compare_enabled = (channel.control & (1 << 8)) && !(channel.control & (1 << 10));
+    bool overflow_enabled = (channel.control & (1 << 9)) && !(channel.control & (1 << 11));
+    bool zero_return = (channel.control & (1 << 6)) && channel.compare;
 
-    if (channels[index].counter == channels[index].compare) {
-        if (channels[index].control & (1 << 6)) {
-            channels[index].counter = 0;
-        }
+    // the counter can never be incremented to 0, so a compare of 0 never matches
+    if (compare_enabled && channel.compare) {
+        u64 ticks = channel.compare > channel.counter ? channel.compare - channel.counter : 0x10000 - channel.counter + channel.compare;
+        channel.compare_time = GetTickTime(channel, ticks);
+    }
 
-        if (channels[index].control & (1 << 8)) {
-            log_fatal("handle timer interrupt with compare");
-        }
+    // with zero return the counter never gets past compare once it's below it
+    if (overflow_enabled && !(zero_return && channel.counter < channel.compare)) {
+        channel.overflow_time = GetTickTime(channel, 0x10000 - channel.counter);
     }
 
-    if (channels[index].counter > 0xFFFF) {
-        channels[index].counter = 0;
-
-        // timer interrupts are edge triggered,
-        // meaning they can only be requested
-        // if either interrupt bit goes from 0 to 1
-        if ((channels[index].control & (1 << 9)) && !(channels[index].control & (1 << 11))) {
-            // set the overflow interrupt flag and request a timer interrupt
-            channels[index].control |= (1 << 11);
-            
-            LogFile::Get().Log("[Timer] T%d request overflow interrupt\n", index);
-
-            switch (index) {
-            case 0:
-                system.ee_intc.RequestInterrupt(EEInterruptSource::Timer0);
-                break;
-            case 1:
-                system.ee_intc.RequestInterrupt(EEInterruptSource::Timer1);
-                break;
-            case 2:
-                system.ee_intc.RequestInterrupt(EEInterruptSource::Timer2);
-                break;
-            case 3:
-                system.ee_intc.RequestInterrupt(EEInterruptSource::Timer3);
-                break;
-            }
-        }
+    u64 time = std::min(channel.compare_time, channel.overflow_time);
+
+    if (time == std::numeric_limits<u64>::max()) {
+        return;
+    }
+
+    u64 now = scheduler.GetCurrentTime();
+    channel.interrupt_event = scheduler.Add(time > now ? time - now : 0, interrupt_kind, index);
+}
+
+void Timers::InterruptEvent(u64 index) {
+    TimerChannel& channel = channels[index];
+
+    channel.interrupt_event = Scheduler::INVALID_EVENT;
+    Sync(index, system.scheduler.GetCurrentTime());
+
+    if (channel.timestamp >= channel.compare_time) {
+        // set the compare interrupt flag and request a timer interrupt
+        channel.control |= (1 << 10);
+
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d request compare interrupt\n", static_cast<int>(index));
+        RequestInterrupt(index);
+    }
+
+    if (channel.timestamp >= channel.overflow_time) {
+        // set the overflow interrupt flag and request a timer interrupt
+        channel.control |= (1 << 11);
+
+        log_channel(LogChannel::Timers, LogLevel::Debug, "[Timer] T%d request overflow interrupt\n", static_cast<int>(index));
+        RequestInterrupt(index);
+    }
+
+    ScheduleInterrupt(index);
+}
+
+void Timers::RequestInterrupt(int index) {
+    switch (index) {
+    case 0:
+        system.ee_intc.RequestInterrupt(EEInterruptSource::Timer0);
+        break;
+    case 1:
+        system.ee_intc.RequestInterrupt(EEInterruptSource::Timer1);
+        break;
+    case 2:
+        system.ee_intc.RequestInterrupt(EEInterruptSource::Timer2);
+        break;
+    case 3:
+        system.ee_intc.RequestInterrupt(EEInterruptSource::Timer3);
+        break;
     }
 }
\ No newline at end of file
@@ -2,18 +2,33 @@
 
 #include "common/types.h"
 #include "common/log.h"
+#include "core/scheduler.h"
 
 struct TimerChannel {
     u32 counter;
     u16 control;
     u16 compare;
     u16 hold;
-    int cycles;
-    int cycles_per_tick;
+
+    // the ee timestamp that counter was last brought up to date at
+    u64 timestamp;
+
+    // how many ee cycles it takes for the counter to increment by 1
+    u64 cycles_per_tick;
+
+    EventHandle interrupt_event;
+
+    // when the pending interrupts are due, or the largest possible time if they aren't
+    u64 compare_time;
+    u64 overflow_time;
 };
 
 class System;
 
+// the counters aren't stepped every slice. instead each channel remembers its
+// counter at a timestamp and works out the current value from the scheduler
+// time whenever it's accessed. compare and overflow interrupts are scheduled
+// as events for when they'll happen, so nothing runs between them
 class Timers {
 public:
     Timers(System& system);
@@ -21,13 +36,24 @@ public:
     void Reset();
     u32 ReadRegister(u32 addr);
     void WriteRegister(u32 addr, u32 data);
-    
-    u32 ReadChannel(u32 addr);
 
-    void Increment(int index);
-    void Run(int cycles);
-    
 private:
+    // brings the counter up to date with the given ee timestamp
+    void Sync(int index, u64 now);
+
+    // moves the counter on by a number of ticks, wrapping it the same way counting up would
+    void Advance(TimerChannel& channel, u64 ticks);
+
+    // reschedules the interrupt event for a channel after its state has changed
+    void ScheduleInterrupt(int index);
+
+    // works out the timestamp that the counter will have ticked a number of times after its last sync
+    u64 GetTickTime(TimerChannel& channel, u64 ticks);
+
+    void InterruptEvent(u64 index);
+    void RequestInterrupt(int index);
+
     TimerChannel channels[4];
+    EventKind interrupt_kind;
     System& system;
 };
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include "core/ee/tlb.h"
+
+// only these bits can be written in each part of an entry
+#define PAGE_MASK_BITS 0x01FFE000
+#define ENTRY_HI_BITS 0xFFFFE0FF
+#define ENTRY_LO0_BITS 0x83FFFFFF
+#define ENTRY_LO1_BITS 0x03FFFFFF
+
+#define SCRATCHPAD_BASE 0x70000000
+#define SCRATCHPAD_SIZE 0x4000
+
+EETLB::EETLB() {
+    Reset();
+}
+
+void EETLB::Reset() {
+    for (Entry& entry : entries) {
+        entry = Entry{};
+    }
+
+    MapDefaultPages(0, 0);
+}
+
+EETLB::Entry EETLB::ReadEntry(int index) {
+    return entries[index];
+}
+
+void EETLB::WriteEntry(int index, Entry entry) {
+    entry.page_mask &= PAGE_MASK_BITS;
+    entry.entry_hi &= ENTRY_HI_BITS;
+    entry.entry_lo0 &= ENTRY_LO0_BITS;
+    entry.entry_lo1 &= ENTRY_LO1_BITS;
+
+    Entry old_entry = entries[index];
+    UnmapEntry(old_entry);
+    entries[index] = entry;
+
+    // other entries can cover some of the pages that were just unmapped
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        if (i != index && Overlaps(entries[i], old_entry)) {
+            MapEntry(entries[i]);
+        }
+    }
+
+    MapEntry(entries[index]);
+}
+
+int EETLB::Probe(u32 entry_hi) {
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        u32 mask = ~(entries[i].page_mask | 0x1FFF);
+
+        if ((entries[i].entry_hi & mask) == (entry_hi & mask)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void EETLB::TakeDirtyPages(u32& first, u32& last) {
+    first = dirty_first;
+    last = dirty_last;
+    dirty_first = 0;
+    dirty_last = 0;
+}
+
+void EETLB::MapEntry(Entry& entry) {
+    u32 vaddr = GetVirtualAddress(entry);
+    u32 size = GetPageSize(entry);
+
+    // the scratchpad bit maps the 16KB scratchpad instead of physical memory
+    if (entry.entry_lo0 & 0x80000000) {
+        MapPages(vaddr, SCRATCHPAD_BASE, SCRATCHPAD_SIZE);
+        return;
+    }
+
+    // only valid pages get mapped
+    if (entry.entry_lo0 & 0x2) {
+        MapPages(vaddr, ((entry.entry_lo0 >> 6) & 0xFFFFF) << 12, size);
+    }
+
+    if (entry.entry_lo1 & 0x2) {
+        MapPages(vaddr + size, ((entry.entry_lo1 >> 6) & 0xFFFFF) << 12, size);
+    }
+}
+
+void EETLB::UnmapEntry(Entry& entry) {
+    // entries without any valid pages never mapped anything
+    if (!(entry.entry_lo0 & 0x80000002) && !(entry.entry_lo1 & 0x2)) {
+        return;
+    }
+
+    MapDefaultPages(GetVirtualAddress(entry), GetPageSize(entry) * 2);
+}
+
+void EETLB::MapPages(u32 vaddr, u32 paddr, u32 size) {
+    MarkDirty(vaddr >> 12, (vaddr >> 12) + (size >> 12));
+
+    for (u32 offset = 0; offset < size; offset += 0x1000) {
+        u32 page = (vaddr + offset) >> 12;
+
+        // kseg0 and kseg1 are never mapped through the tlb
+        if (page >= 0x80000 && page < 0xC0000) {
+            continue;
+        }
+
+        page_table[page] = paddr + offset;
+    }
+}
+
+// a size of 0 resets the whole address space
+void EETLB::MapDefaultPages(u32 vaddr, u32 size) {
+    u32 first = vaddr >> 12;
+    u32 last = size ? std::min<u32>(first + (size >> 12), page_table.size()) : page_table.size();
+
+    MarkDirty(first, last);
+
+    for (u32 page = first; page < last; page++) {
+        page_table[page] = GetDefaultMapping(page << 12);
+    }
+}
+
+void EETLB::MarkDirty(u32 first, u32 last) {
+    if (dirty_first == dirty_last) {
+        dirty_first = first;
+        dirty_last = last;
+    } else {
+        dirty_first = std::min(dirty_first, first);
+        dirty_last = std::max(dirty_last, last);
+    }
+}
+
+bool EETLB::Overlaps(Entry& a, Entry& b) {
+    u32 a_start = GetVirtualAddress(a);
+    u32 b_start = GetVirtualAddress(b);
+    u64 a_end = static_cast<u64>(a_start) + GetPageSize(a) * 2;
+    u64 b_end = static_cast<u64>(b_start) + GetPageSize(b) * 2;
+
+    return a_start < b_end && b_start < a_end;
+}
+
+u32 EETLB::GetPageSize(Entry& entry) {
+    // the mask covers both pages of the pair
+    return ((entry.page_mask | 0x1FFF) + 1) >> 1;
+}
+
+u32 EETLB::GetVirtualAddress(Entry& entry) {
+    return entry.entry_hi & ~(entry.page_mask | 0x1FFF);
+}
+
+u32 EETLB::GetDefaultMapping(u32 vaddr) {
+    if (vaddr >= SCRATCHPAD_BASE && vaddr < SCRATCHPAD_BASE + SCRATCHPAD_SIZE) {
+        return vaddr;
+    } else if (vaddr >= 0x30100000 && vaddr < 0x32000000) {
+        // uncached accelerated ram
+        return vaddr & 0x1FFFFFF;
+    } else {
+        return vaddr & 0x1FFFFFFF;
+    }
+}
\ No newline at end of file
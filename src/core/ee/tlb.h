@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include "common/types.h"
+
+// the ee has a 48 entry tlb, where each entry maps an even and odd pair of
+// virtual pages. rather than searching the entries on every access, each write
+// rebuilds a flat table of 4KB pages, so that translating an address is a
+// single lookup. pages which no entry maps keep the fixed segment mapping that
+// the bios relies on before it sets up the tlb.
+// tlb misses aren't raised as exceptions and asids are ignored, since
+// everything on the ps2 runs in kernel mode with global entries anyway
+class EETLB {
+public:
+    struct Entry {
+        u32 page_mask = 0;
+        u32 entry_hi = 0;
+        u32 entry_lo0 = 0;
+        u32 entry_lo1 = 0;
+    };
+
+    EETLB();
+
+    void Reset();
+    Entry ReadEntry(int index);
+    void WriteEntry(int index, Entry entry);
+
+    // returns the index of the entry with the same virtual page as entry_hi, or -1 if there isn't one
+    int Probe(u32 entry_hi);
+
+    // gives the range of virtual pages which have changed since the last call,
+    // so that anything built from the page table only needs to update those pages
+    void TakeDirtyPages(u32& first, u32& last);
+
+    u32 Translate(u32 vaddr) {
+        return page_table[vaddr >> 12] | (vaddr & 0xFFF);
+    }
+
+    static constexpr int NUM_ENTRIES = 48;
+
+private:
+    void MapEntry(Entry& entry);
+    void UnmapEntry(Entry& entry);
+    void MapPages(u32 vaddr, u32 paddr, u32 size);
+    void MapDefaultPages(u32 vaddr, u32 size);
+    void MarkDirty(u32 first, u32 last);
+    bool Overlaps(Entry& a, Entry& b);
+
+    static u32 GetPageSize(Entry& entry);
+    static u32 GetVirtualAddress(Entry& entry);
+    static u32 GetDefaultMapping(u32 vaddr);
+
+    std::array<Entry, NUM_ENTRIES> entries;
+
+    // the physical address of each virtual page. scratchpad pages use
+    // 0x70000000 onwards, since the scratchpad isn't in the physical address space
+    std::array<u32, 0x100000> page_table;
+
+    u32 dirty_first = 0;
+    u32 dirty_last = 0;
+};
\ No newline at end of file
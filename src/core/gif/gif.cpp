@@ -17,6 +17,7 @@ void GIF::Reset() {
     current_tag.nregs = 0;
     current_tag.reglist = 0;
     current_tag.reglist_offset = 0;
+    current_tag.registers_left = 0;
     current_tag.transfers_left = 0;
 }
 
@@ -25,13 +26,13 @@ void GIF::SystemReset() {
 }
 
 u32 GIF::ReadStat() {
-    log_warn("[GIF] read stat %08x", stat);
+    log_channel(LogChannel::GIF, LogLevel::Trace, "[GIF] read stat %08x\n", stat);
 
     return stat;
 }
 
 void GIF::WriteCTRL(u8 data) {
-    log_warn("[GIF] write ctrl %02x", data);
+    log_channel(LogChannel::GIF, LogLevel::Debug, "[GIF] write ctrl %02x\n", data);
 
     if (data & 0x1) {
         SystemReset();
@@ -57,7 +58,7 @@ void GIF::SendPath3(u128 data) {
         current_tag.reglist = data.ud[1];
         current_tag.reglist_offset = 0;
 
-        LogFile::Get().Log("[GIF] receive giftag %016lx%016lx format %d\n", data.ud[1], data.ud[0], current_tag.format);
+        log_channel(LogChannel::GIF, LogLevel::Trace, "[GIF] receive giftag %016lx%016lx format %d\n", data.ud[1], data.ud[0], current_tag.format);
 
         if (!current_tag.nregs) {
             current_tag.nregs = 16;
@@ -69,16 +70,26 @@ void GIF::SendPath3(u128 data) {
         case 0:
             current_tag.transfers_left = current_tag.nloop * current_tag.nregs;
             break;
-        default:
-            log_fatal("[GIF] handle GIFTag format %d", current_tag.format);
+        case 1:
+            // registers are packed 2 to a quadword, and an odd one out leaves the upper half unused
+            current_tag.registers_left = current_tag.nloop * current_tag.nregs;
+            current_tag.transfers_left = (current_tag.registers_left + 1) / 2;
+            break;
+        case 2: case 3:
+            current_tag.transfers_left = current_tag.nloop;
+            break;
         }
     } else {
         switch (current_tag.format) {
         case 0:
             ProcessPacked(data);
             break;
-        default:
-            log_fatal("[GIF] handle GIFTag format %d", current_tag.format);
+        case 1:
+            ProcessReglist(data);
+            break;
+        case 2: case 3:
+            ProcessImage(data);
+            break;
         }
 
         current_tag.transfers_left--;
@@ -90,10 +101,10 @@ void GIF::ProcessPacked(u128 data) {
 
     switch (reg) {
     case 0x00:
-        system.gs.WriteRegister(0x00, data.uw[0] & 0x7FF);
+        system.gs_thread.WriteRegister(0x00, data.uw[0] & 0x7FF);
         break;
     case 0x0E:
-        system.gs.WriteRegister(data.ud[1] & 0xFF, data.ud[0]);
+        system.gs_thread.WriteRegister(data.ud[1] & 0xFF, data.ud[0]);
         break;
     default:
         log_fatal("[GIF] handle register %02x", reg);
@@ -106,6 +117,26 @@ void GIF::ProcessPacked(u128 data) {
     }
 }
 
-void GIF::ProcessImage(u128 data) {
+void GIF::ProcessReglist(u128 data) {
+    for (int i = 0; i < 2 && current_tag.registers_left; i++) {
+        u8 reg = (current_tag.reglist >> (current_tag.reglist_offset * 4)) & 0xF;
+
+        // a+d and nop don't write anything in reglist mode
+        if (reg < 0x0E) {
+            system.gs_thread.WriteRegister(reg, data.ud[i]);
+        }
 
+        current_tag.reglist_offset++;
+        current_tag.registers_left--;
+
+        if (current_tag.reglist_offset == current_tag.nregs) {
+            current_tag.reglist_offset = 0;
+        }
+    }
+}
+
+// image data goes through the same path as register writes, as writes to hwreg
+void GIF::ProcessImage(u128 data) {
+    system.gs_thread.WriteRegister(0x54, data.ud[0]);
+    system.gs_thread.WriteRegister(0x54, data.ud[1]);
 }
\ No newline at end of file
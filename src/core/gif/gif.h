@@ -28,6 +28,7 @@ public:
 
     void SendPath3(u128 data);
     void ProcessPacked(u128 data);
+    void ProcessReglist(u128 data);
     void ProcessImage(u128 data);
 
 private:
@@ -45,6 +46,9 @@ private:
         u32 nregs;
         u64 reglist;
         u32 reglist_offset;
+
+        // how many registers are left in a reglist transfer
+        u32 registers_left;
         int transfers_left;
     } current_tag;
 
@@ -1,8 +1,9 @@
+#include <string.h>
 #include "common/log.h"
 #include "core/gs/gs.h"
 #include "core/system.h"
 
-GS::GS(System* system) : system(system) {
+GS::GS(System* system) : local_memory(std::make_unique<u32[]>(LOCAL_MEMORY_WORDS)), system(system) {
 
 }
 
@@ -29,6 +30,12 @@ void GS::Reset() {
     trxpos = 0;
     trxreg = 0;
     trxdir = 0;
+    siglblid = 0;
+    transfer_active = false;
+    transfer_x = 0;
+    transfer_y = 0;
+    transfer_bits = 0;
+    memset(local_memory.get(), 0, LOCAL_MEMORY_WORDS * 4);
 }
 
 void GS::SystemReset() {
@@ -38,7 +45,15 @@ void GS::SystemReset() {
 u32 GS::ReadRegisterPrivileged(u32 addr) {
     switch (addr) {
     case 0x12001000:
+        // finish and signal get set by writes that might still be queued for the gs thread
+        system->gs_thread.Sync();
         return csr;
+    case 0x12001080:
+        system->gs_thread.Sync();
+        return siglblid;
+    case 0x12001084:
+        system->gs_thread.Sync();
+        return siglblid >> 32;
     default:
         log_fatal("[GS] handle privileged read %08x", addr);
     }
@@ -104,13 +119,17 @@ void GS::WriteRegisterPrivileged(u32 addr, u32 data) {
         break;
     case 0x120000E4:
         break;
-    case 0x12001000:
+    case 0x12001000: {
         if (data & 0x200) {
             SystemReset();
         }
 
-        csr = data;
+        // writing 1 to any of the interrupt flags clears them, and writing 0 leaves them alone
+        u32 old_csr = csr;
+
+        while (!csr.compare_exchange_weak(old_csr, (data & ~0x1F) | (old_csr & ~data & 0x1F))) {}
         break;
+    }
     case 0x12001004:
         break;
     case 0x12001010:
@@ -153,9 +172,139 @@ void GS::WriteRegister(u32 addr, u64 data) {
         trxreg = data;
         break;
     case 0x53:
-        trxdir = data;
+        trxdir = data & 0x3;
+        StartTransfer();
+        break;
+    case 0x54:
+        WriteHWREG(data);
         break;
+    case 0x60: {
+        // the high word masks which bits of the id get replaced
+        u32 mask = data >> 32;
+        u32 id = (siglblid & ~mask) | (data & mask);
+
+        siglblid = (siglblid & ~0xFFFFFFFFULL) | id;
+        csr |= 0x1;
+        break;
+    }
+    case 0x61:
+        csr |= 0x2;
+        break;
+    case 0x62: {
+        u32 mask = data >> 32;
+        u32 id = ((siglblid >> 32) & ~mask) | (data & mask);
+
+        siglblid = (siglblid & 0xFFFFFFFF) | (static_cast<u64>(id) << 32);
+        break;
+    }
     default:
         log_fatal("[GS] handle write %08x = %016lx", addr, data);
     }
 }
+
+void GS::RaiseEventInterrupt(u32 addr) {
+    // SIGMSK and FINISHMSK in imr
+    int mask_bit = addr == 0x60 ? 8 : 9;
+
+    if (!(imr & (1 << mask_bit))) {
+        system->ee_intc.RequestInterrupt(EEInterruptSource::GS);
+    }
+}
+
+void GS::StartTransfer() {
+    switch (trxdir) {
+    case 0: {
+        transfer_active = true;
+        transfer_x = 0;
+        transfer_y = 0;
+        transfer_bits = 0;
+
+        u32 psm = (bitbltbuf >> 56) & 0x3F;
+
+        if (psm != 0) {
+            log_warn("[GS] host to local transfer with psm %02x isn't stored yet", psm);
+        }
+
+        break;
+    }
+    case 3:
+        transfer_active = false;
+        break;
+    default:
+        // TODO: handle local to host and local to local transfers
+        log_warn("[GS] handle transfer direction %d", trxdir);
+        transfer_active = false;
+        break;
+    }
+}
+
+int GS::GetTransferBitsPerPixel(u32 psm) {
+    switch (psm) {
+    case 0x00: case 0x30:
+        return 32;
+    case 0x01: case 0x31:
+        return 24;
+    case 0x02: case 0x0A: case 0x32: case 0x3A:
+        return 16;
+    case 0x13: case 0x1B:
+        return 8;
+    case 0x14: case 0x24: case 0x2C:
+        return 4;
+    default:
+        log_warn("[GS] unknown psm %02x", psm);
+        return 32;
+    }
+}
+
+void GS::AdvanceTransfer() {
+    u32 rrw = trxreg & 0xFFF;
+    u32 rrh = (trxreg >> 32) & 0xFFF;
+
+    if (++transfer_x >= rrw) {
+        transfer_x = 0;
+
+        if (++transfer_y >= rrh) {
+            transfer_active = false;
+        }
+    }
+}
+
+// pixels are stored in rows of the buffer width, rather than in the gs's swizzled page layout.
+// nothing reads local memory back yet, so the layout can change once something does
+void GS::WriteHWREG(u64 data) {
+    if (!transfer_active) {
+        log_warn("[GS] hwreg write %016lx with no transfer active", data);
+        return;
+    }
+
+    u32 psm = (bitbltbuf >> 56) & 0x3F;
+
+    // only psmct32 gets stored for now. other formats have their data dropped, but the
+    // transfer still moves along by however many pixels were sent, so that it ends on time
+    if (psm != 0) {
+        int bits_per_pixel = GetTransferBitsPerPixel(psm);
+
+        transfer_bits += 64;
+
+        while (transfer_active && transfer_bits >= bits_per_pixel) {
+            transfer_bits -= bits_per_pixel;
+            AdvanceTransfer();
+        }
+
+        return;
+    }
+
+    // dbp is in units of 64 words, and dbw in units of 64 pixels
+    u32 base = ((bitbltbuf >> 32) & 0x3FFF) * 64;
+    u32 width = ((bitbltbuf >> 48) & 0x3F) * 64;
+    u32 x = (trxpos >> 32) & 0x7FF;
+    u32 y = (trxpos >> 48) & 0x7FF;
+
+    // psmct32 has 2 pixels in each write
+    for (int i = 0; i < 2 && transfer_active; i++) {
+        u32 addr = base + ((y + transfer_y) * width) + x + transfer_x;
+
+        local_memory[addr & (LOCAL_MEMORY_WORDS - 1)] = data >> (i * 32);
+        AdvanceTransfer();
+    }
+}
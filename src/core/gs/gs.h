@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include "common/types.h"
 
 class System;
@@ -12,11 +14,24 @@ public:
     void WriteRegisterPrivileged(u32 addr, u32 data);
     void WriteRegister(u32 addr, u64 data);
 
+    // signal and finish raise their interrupts through the intc, which belongs to the ee
+    // thread. so once one of their writes has been processed, this gets called from there
+    void RaiseEventInterrupt(u32 addr);
+
     void Reset();
     void SystemReset();
 
 private:
-    u32 csr;
+    void StartTransfer();
+    int GetTransferBitsPerPixel(u32 psm);
+    void AdvanceTransfer();
+    void WriteHWREG(u64 data);
+
+    // 4MB of local memory, in 32 bit words
+    static constexpr int LOCAL_MEMORY_WORDS = 0x100000;
+
+    // the gs thread sets the finish and signal bits while the ee can be writing to it
+    std::atomic<u32> csr;
 
     // these registers seem to be undocumented
     u64 smode1;
@@ -42,5 +57,18 @@ private:
     u64 trxreg;
     u8 trxdir;
 
+    // the signal id in the low word and the label id in the high word
+    u64 siglblid;
+
+    // where the current host to local transfer has got to, relative to trxpos
+    bool transfer_active;
+    u32 transfer_x;
+    u32 transfer_y;
+
+    // bits left over from the last write, for formats that don't fit a whole number of pixels in one
+    int transfer_bits;
+
+    std::unique_ptr<u32[]> local_memory;
+
     System* system;
 };
\ No newline at end of file
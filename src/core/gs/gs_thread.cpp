@@ -0,0 +1,196 @@
+#include <algorithm>
+#include "common/log_file.h"
+#include "common/tracer.h"
+#include "core/gs/gs_thread.h"
+#include "core/system.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPIN_PAUSE() _mm_pause()
+#else
+#define SPIN_PAUSE()
+#endif
+
+// how many times to check the ring before backing off
+#define SPIN_COUNT 4096
+
+// the most commands processed before they're consumed from the ring
+#define CONSUME_INTERVAL 64
+
+// how many commands have to be queued before a sleeping thread gets woken up
+#define WAKE_THRESHOLD 1024
+
+// spinning only helps when the other thread can be running at the same time
+GSThread::GSThread(System& system) : system(system), spin_count(std::thread::hardware_concurrency() > 1 ? SPIN_COUNT : 1) {}
+
+GSThread::~GSThread() {
+    Stop();
+}
+
+void GSThread::Start() {
+    if (IsRunning()) {
+        return;
+    }
+
+    quit = false;
+    ring.Reset();
+
+    LogFile* log_file = &LogFile::Get();
+
+    thread = std::thread{[this, log_file]() {
+        ThreadLoop(log_file);
+    }};
+}
+
+void GSThread::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    condition.notify_one();
+    thread.join();
+}
+
+void GSThread::WriteRegister(u32 addr, u64 data) {
+    if (!IsRunning()) {
+        system.gs.WriteRegister(addr, data);
+    } else {
+        Push(Command{addr, data});
+    }
+
+    // signal and finish
+    if (addr == 0x60 || addr == 0x61) {
+        Sync();
+        system.gs.RaiseEventInterrupt(addr);
+    }
+
+    // a local to host transfer reads back local memory, so everything queued before it has
+    // to have been drawn by the time the ee goes to read the data, like with privileged reads
+    if (addr == 0x53 && (data & 0x3) == 1) {
+        Sync();
+    }
+}
+
+void GSThread::Push(const Command& command) {
+    int spins = 0;
+
+    // the ring is full, so the ee has to wait for the gs to catch up
+    while (!ring.Push(command)) {
+        if (++spins < spin_count) {
+            SPIN_PAUSE();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // pairs with the fence in WaitForCommands. either we see the thread is sleeping, or it sees what we pushed.
+    // once it's asleep it's left until a decent batch has built up, as waking it for every
+    // write means a context switch each time when there aren't any cores to spare
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleeping.load(std::memory_order_relaxed) && ring.Size() >= WAKE_THRESHOLD) {
+        Wake();
+    }
+}
+
+void GSThread::Sync() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    // anything left below the wake threshold still has to be processed
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleeping.load(std::memory_order_relaxed)) {
+        Wake();
+    }
+
+    int spins = 0;
+
+    while (!ring.Empty()) {
+        if (++spins < spin_count) {
+            SPIN_PAUSE();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void GSThread::Flush() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleeping.load(std::memory_order_relaxed) && !ring.Empty()) {
+        Wake();
+    }
+}
+
+// only the first wake after the thread goes to sleep has to notify it. taking the lock
+// means the thread is either already waiting on the condition or hasn't checked the
+// ring yet, so the notification can't get lost
+void GSThread::Wake() {
+    if (sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_one();
+    }
+}
+
+void GSThread::ThreadLoop(LogFile* log_file) {
+    LogFile::Bind(log_file);
+    Tracer::SetThreadName("GS");
+
+    while (WaitForCommands()) {
+        const Command* commands;
+        int count;
+
+        // commands are consumed a batch at a time, so the ee's cache line isn't bounced on every write
+        while ((count = ring.Peek(commands)) != 0) {
+            count = std::min(count, CONSUME_INTERVAL);
+
+            for (int i = 0; i < count; i++) {
+                system.gs.WriteRegister(commands[i].addr, commands[i].data);
+            }
+
+            ring.Consume(count);
+        }
+    }
+
+    LogFile::Bind(nullptr);
+}
+
+bool GSThread::WaitForCommands() {
+    for (int i = 0; i < spin_count; i++) {
+        if (!ring.Empty()) {
+            return true;
+        }
+
+        SPIN_PAUSE();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // the ee clears sleeping when it wakes us, so it has to be set again after every wakeup
+    while (true) {
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (quit || !ring.Empty()) {
+            break;
+        }
+
+        condition.wait(lock);
+    }
+
+    sleeping.store(false, std::memory_order_relaxed);
+
+    // anything queued before stopping still gets processed
+    return !ring.Empty();
+}
\ No newline at end of file
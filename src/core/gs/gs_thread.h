@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "common/types.h"
+#include "common/ring_buffer.h"
+
+class System;
+class LogFile;
+
+// runs the gs on its own host thread. the gif still decodes giftags on the ee thread,
+// and pushes what it decodes as writes to the general gs registers into a ring, which
+// the gs thread works through in the background. image data becomes writes to hwreg.
+// the ee only has to wait for the gs when the ring is full, or when it needs to see the
+// result of what's been queued, like when reading csr
+class GSThread {
+public:
+    GSThread(System& system);
+    ~GSThread();
+
+    // the thread picks up the log of the thread that starts it.
+    // stopping it processes anything that's still queued first
+    void Start();
+    void Stop();
+
+    bool IsRunning() {
+        return thread.joinable();
+    }
+
+    // queues a write to a general gs register. when the thread isn't running it's done straight away.
+    // signal and finish wait for the gs to get to them, since their interrupts come from the ee thread
+    void WriteRegister(u32 addr, u64 data);
+
+    // blocks until every queued write has been processed
+    void Sync();
+
+    // wakes the thread if it's sleeping with writes queued, without waiting for it. a sleeping
+    // thread is otherwise only woken once a batch has built up, so this is called every
+    // vblank to stop a few writes from sitting in the ring indefinitely
+    void Flush();
+
+private:
+    struct Command {
+        u32 addr;
+        u64 data;
+    };
+
+    void Push(const Command& command);
+    void ThreadLoop(LogFile* log_file);
+    void Wake();
+
+    // waits for something to be queued. returns false once the thread should quit
+    bool WaitForCommands();
+
+    static constexpr int RING_SIZE = 1 << 16;
+
+    System& system;
+    std::thread thread;
+    int spin_count;
+
+    // commands stay in the ring until they've been processed, so when it's empty the gs is up to date
+    RingBuffer<Command, RING_SIZE> ring;
+
+    std::atomic<bool> quit = false;
+    std::atomic<bool> sleeping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "core/idle_loop_detector.h"
+
+void IdleLoopDetector::Reset() {
+    last_loop = NO_LOOP;
+    current_loop = 0;
+    loops.clear();
+    stats.clear();
+}
+
+void IdleLoopDetector::InvalidateCode() {
+    last_loop = NO_LOOP;
+    loops.clear();
+}
+
+void IdleLoopDetector::RecordSkip(u64 cycles) {
+    if (cycles == 0) {
+        return;
+    }
+
+    IdleLoopStats& loop_stats = stats[current_loop];
+
+    loop_stats.hits++;
+    loop_stats.skipped_cycles += cycles;
+}
+
+bool IdleLoopDetector::AnalyseLoop(const std::vector<CPUInstruction>& code) {
+    // registers that are read before they're written in the loop,
+    // and registers that the loop writes to
+    u32 inputs = 0;
+    u32 outputs = 0;
+    int last = code.size() - 1;
+
+    for (int i = 0; i <= last; i++) {
+        CPUInstruction inst = code[i];
+        u32 reads = 0;
+        u32 writes = 0;
+        bool branch = false;
+
+        switch (inst.opcode) {
+        case 0:
+            switch (inst.func) {
+            case 0: case 2: case 3:
+                // sll, srl and sra
+                reads = 1 << inst.rt;
+                writes = 1 << inst.rd;
+                break;
+            case 4: case 6: case 7:
+            case 33: case 35: case 36: case 37: case 38: case 39: case 42: case 43:
+                // variable shifts, addu, subu, and, or, xor, nor, slt and sltu
+                reads = (1 << inst.rs) | (1 << inst.rt);
+                writes = 1 << inst.rd;
+                break;
+            default:
+                return false;
+            }
+
+            break;
+        case 1:
+            // bltz, bgez, bltzl and bgezl
+            if (inst.rt > 3) {
+                return false;
+            }
+
+            reads = 1 << inst.rs;
+            branch = true;
+            break;
+        case 2:
+            // j
+            branch = true;
+            break;
+        case 4: case 5: case 20: case 21:
+            // beq, bne, beql and bnel
+            reads = (1 << inst.rs) | (1 << inst.rt);
+            branch = true;
+            break;
+        case 6: case 7: case 22: case 23:
+            // blez, bgtz, blezl and bgtzl
+            reads = 1 << inst.rs;
+            branch = true;
+            break;
+        case 9: case 10: case 11: case 12: case 13: case 14:
+            // addiu, slti, sltiu, andi, ori and xori
+            reads = 1 << inst.rs;
+            writes = 1 << inst.rt;
+            break;
+        case 15:
+            // lui
+            writes = 1 << inst.rt;
+            break;
+        case 30: case 32: case 33: case 35: case 36: case 37: case 39: case 55:
+            // loads, including ld, lwu and lq which only exist on the ee
+            reads = 1 << inst.rs;
+            writes = 1 << inst.rt;
+            break;
+        default:
+            return false;
+        }
+
+        // the only branch allowed is the one back to the start
+        if (branch != (i == last - 1)) {
+            return false;
+        }
+
+        inputs |= reads & ~outputs;
+        outputs |= writes;
+    }
+
+    // $zero can be written to without changing anything. if nothing that the
+    // loop depends on is changed by the loop, each iteration is identical
+    outputs &= ~1;
+
+    return (inputs & outputs) == 0;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "common/types.h"
+#include "common/cpu_types.h"
+
+struct IdleLoopStats {
+    // how many times the loop was skipped
+    u64 hits = 0;
+
+    // how many cpu cycles didn't need to be run because of it
+    u64 skipped_cycles = 0;
+};
+
+// finds short loops which only load, compare and branch on state that the loop itself
+// never changes, like polling INTC_STAT or a vsync flag in ram. once a full iteration
+// of one of these has branched back to the start, every following iteration does the
+// exact same thing until something outside of the cpu changes, so the cpu can stop
+// running it until an interrupt comes in. that only holds when the loop's loads go to
+// state which can't change without an interrupt, so a loop polling something like a dma
+// channel or a timer is never idle. this works for both the ee and iop, since the
+// instructions that are allowed in an idle loop are the same on both
+class IdleLoopDetector {
+public:
+    void Reset();
+
+    // called for each taken branch, where start is the target and end is the address
+    // of the branch. a loop is only reported as idle once its branch has been taken
+    // twice in a row, as that guarantees a full iteration was run from the start.
+    // read_word is only used the first time that a loop is seen, while read_reg and
+    // is_idle_address are used by CheckLoads each time the loop would be reported as idle
+    template <typename F, typename R, typename A>
+    bool CheckBranch(u32 start, u32 end, F read_word, R read_reg, A is_idle_address) {
+        if ((end - start) >= MAX_LOOP_SIZE * 4) {
+            last_loop = NO_LOOP;
+            return false;
+        }
+
+        u64 key = (static_cast<u64>(start) << 32) | end;
+
+        if (key != last_loop) {
+            last_loop = key;
+            return false;
+        }
+
+        auto loop = loops.find(key);
+
+        if (loop == loops.end()) {
+            std::vector<CPUInstruction> code;
+
+            // include the delay slot as well
+            for (u32 addr = start; addr <= end + 4; addr += 4) {
+                code.push_back(CPUInstruction{read_word(addr)});
+            }
+
+            // only idle loops need their code kept around
+            if (!AnalyseLoop(code)) {
+                code.clear();
+            }
+
+            loop = loops.emplace(key, std::move(code)).first;
+        }
+
+        // the same loop can poll different addresses each time it's
+        // run, so where its loads go has to be checked every time
+        if (loop->second.empty() || !CheckLoads(loop->second, read_reg, is_idle_address)) {
+            return false;
+        }
+
+        current_loop = start;
+        return true;
+    }
+
+    // exceptions can come back anywhere in a loop
+    void ResetLastBranch() {
+        last_loop = NO_LOOP;
+    }
+
+    // code in a loop that was already analysed may have been overwritten
+    void InvalidateCode();
+
+    // for block based backends which know they ran a loop from its start
+    void SetCurrentLoop(u32 start) {
+        current_loop = start;
+    }
+
+    void RecordSkip(u64 cycles);
+
+    const std::unordered_map<u32, IdleLoopStats>& GetStats() {
+        return stats;
+    }
+
+    // code should contain every instruction from the start of the loop
+    // up to and including the delay slot of the branch back to the start
+    static bool AnalyseLoop(const std::vector<CPUInstruction>& code);
+
+    // for a loop that AnalyseLoop accepted, checks that is_idle_address is true for the address
+    // of every load. read_reg gives the low 32 bits of a register as it is after a full iteration.
+    // the loop never changes the registers it reads before writing, so those are the same as
+    // during the iteration, and the ones it does write are worked out again here. loads from an
+    // address that can't be worked out, like a pointer which the loop loaded, aren't allowed
+    template <typename R, typename A>
+    static bool CheckLoads(const std::vector<CPUInstruction>& code, R read_reg, A is_idle_address) {
+        u32 values[32];
+
+        // which registers hold a value that's known
+        u32 known = ~0u;
+
+        for (int i = 0; i < 32; i++) {
+            values[i] = read_reg(i);
+        }
+
+        for (CPUInstruction inst : code) {
+            u32 rs = values[inst.rs];
+            u32 rt = values[inst.rt];
+            bool operands_known = ((known >> inst.rs) & (known >> inst.rt)) & 0x1;
+            int dest = -1;
+            u32 result = 0;
+
+            // only what's needed to work out addresses is tracked, and
+            // anything else the loop writes is treated as unknown
+            switch (inst.opcode) {
+            case 0:
+                dest = inst.rd;
+
+                switch (inst.func) {
+                case 0:
+                    result = rt << inst.imm5;
+                    operands_known = (known >> inst.rt) & 0x1;
+                    break;
+                case 33:
+                    result = rs + rt;
+                    break;
+                case 35:
+                    result = rs - rt;
+                    break;
+                case 36:
+                    result = rs & rt;
+                    break;
+                case 37:
+                    result = rs | rt;
+                    break;
+                default:
+                    operands_known = false;
+                    break;
+                }
+
+                break;
+            case 9:
+                dest = inst.rt;
+                result = rs + inst.simm;
+                operands_known = (known >> inst.rs) & 0x1;
+                break;
+            case 13:
+                dest = inst.rt;
+                result = rs | inst.imm;
+                operands_known = (known >> inst.rs) & 0x1;
+                break;
+            case 15:
+                dest = inst.rt;
+                result = inst.imm << 16;
+                operands_known = true;
+                break;
+            case 30: case 32: case 33: case 35: case 36: case 37: case 39: case 55:
+                if (!((known >> inst.rs) & 0x1) || !is_idle_address(rs + inst.simm)) {
+                    return false;
+                }
+
+                dest = inst.rt;
+                operands_known = false;
+                break;
+            case 10: case 11: case 12: case 14:
+                dest = inst.rt;
+                operands_known = false;
+                break;
+            }
+
+            // $zero always stays known
+            if (dest > 0) {
+                values[dest] = result;
+                known = operands_known ? (known | (1 << dest)) : (known & ~(1 << dest));
+            }
+        }
+
+        return true;
+    }
+
+    static constexpr int MAX_LOOP_SIZE = 16;
+
+private:
+    static constexpr u64 NO_LOOP = ~0ULL;
+
+    u64 last_loop = NO_LOOP;
+    u32 current_loop = 0;
+
+    // the code of each loop which is idle, or nothing for loops that aren't,
+    // keyed by its start and branch address
+    std::unordered_map<u64, std::vector<CPUInstruction>> loops;
+    std::unordered_map<u32, IdleLoopStats> stats;
+};
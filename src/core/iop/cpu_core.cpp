@@ -1,4 +1,5 @@
 #include "common/log_file.h"
+#include "common/tracer.h"
 #include "core/iop/cpu_core.h"
 #include "core/system.h"
 
@@ -6,6 +7,11 @@ IOPCore::IOPCore(System* system) : system(system), interrupt_controller(*this) {
 
 }
 
+u64 IOPCore::GetCurrentTime() {
+    // the iop runs at 1 / 8 speed of the ee
+    return system->scheduler.GetCurrentTime() + static_cast<u64>(slice_cycles - cycles_left) * 8;
+}
+
 u8 IOPCore::ReadByte(u32 addr) {
     return system->memory.IOPRead<u8>(addr);
 }
@@ -31,11 +37,15 @@ void IOPCore::WriteWord(u32 addr, u32 data) {
 }
 
 void IOPCore::SendInterruptSignal(bool value) {
+    idle = false;
+
     if (value) {
         cop0.gpr[13] |= (1 << 10);
     } else {
         cop0.gpr[13] &= ~(1 << 10);
     }
+
+    UpdateInterrupts();
 }
 
 void IOPCore::CheckInterrupts() {
@@ -48,8 +58,20 @@ void IOPCore::CheckInterrupts() {
     }
 }
 
+void IOPCore::UpdateInterrupts() {
+    bool iec = cop0.gpr[12] & 0x1;
+    u8 im = (cop0.gpr[12] >> 8) & 0xFF;
+    u8 ip = (cop0.gpr[13] >> 8) & 0xFF;
+
+    interrupt_pending = iec && (im & ip);
+}
+
 void IOPCore::DoException(ExceptionType exception) {
-    LogFile::Get().Log("[IOP] trigger exception with type %02x\n", static_cast<int>(exception));
+    log_channel(LogChannel::IOP, LogLevel::Debug, "[IOP] trigger exception with type %02x\n", static_cast<int>(exception));
+    trace_instant("exception", "IOP Exception", static_cast<u64>(exception));
+
+    idle = false;
+    idle_loop_detector.ResetLastBranch();
 
     // record the cause of the exception
     cop0.gpr[13] &= ~0x7C;
@@ -90,4 +112,6 @@ void IOPCore::DoException(ExceptionType exception) {
 
     branch_delay = false;
     branch = false;
+
+    UpdateInterrupts();
 }
\ No newline at end of file
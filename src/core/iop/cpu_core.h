@@ -5,6 +5,7 @@
 #include "core/iop/cpu_regs.h"
 #include "core/iop/cop0.h"
 #include "core/iop/interrupt_controller.h"
+#include "core/idle_loop_detector.h"
 
 class System;
 
@@ -16,6 +17,20 @@ public:
     virtual void Reset() = 0;
     virtual void Run(int cycles) = 0;
 
+    // backends which cache code must throw away anything they cached from the page
+    // of paddr. this is only called on the thread running the iop, or while it's stopped
+    virtual void InvalidateCode(u32 paddr) {
+        idle_loop_detector.InvalidateCode();
+    }
+
+    void SkipIdleCycles(int cycles) {
+        idle_loop_detector.RecordSkip(cycles);
+    }
+
+    // the time in ee cycles that the core has run up to. this can be ahead
+    // of the scheduler while in the middle of a slice
+    u64 GetCurrentTime();
+
     u32 GetReg(int reg) {
         return regs.gpr[reg];
     }
@@ -36,6 +51,7 @@ public:
 
     void SendInterruptSignal(bool value);
     void CheckInterrupts();
+    void UpdateInterrupts();
 
     enum class ExceptionType {
         Interrupt = 0x00,
@@ -56,4 +72,18 @@ public:
     
     bool branch_delay;
     bool branch;
+
+    // iop cycles left to run in the current slice, and how many the slice started with
+    int cycles_left = 0;
+    int slice_cycles = 0;
+
+    // set when an interrupt is able to be taken, so that we only
+    // need to check for one after something changes
+    bool interrupt_pending = false;
+
+    IdleLoopDetector idle_loop_detector;
+
+    // set when the core stopped running because it's stuck in an idle loop.
+    // any change to the interrupt signal clears it, and so does sif1 dma writing to ram
+    bool idle = false;
 };
\ No newline at end of file
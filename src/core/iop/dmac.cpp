@@ -1,8 +1,17 @@
 #include "common/log_file.h"
 #include "common/log.h"
+#include "common/tracer.h"
 #include "core/iop/dmac.h"
 #include "core/system.h"
 
+static const char* channel_names[13] = {
+    "MDEC_IN", "MDEC_OUT", "SIF2", "CDVD", "SPU1", "PIO", "OTC",
+    "SPU2", "DEV9", "SIF0", "SIF1", "SIO2_IN", "SIO2_OUT",
+};
+
+// the ee dmac's transfers use their channel index as the id, so these are moved out of the way
+constexpr int TRACE_ID_BASE = 100;
+
 IOPDMAC::IOPDMAC(System& system) : system(system) {}
 
 void IOPDMAC::Reset() {
@@ -24,22 +33,33 @@ void IOPDMAC::Reset() {
 }
 
 void IOPDMAC::Run(int cycles) {
-    for (int i = 7; i < 13; i++) {
-        if (GetChannelEnable(i) && (channels[i].control & (1 << 24))) {
-            switch (i) {
-            case 7:
-                DoSPU2Transfer();
-                break;
-            case 9:
-                DoSIF0Transfer();
-                break;
-            case 10:
-                DoSIF1Transfer();
-                break;
-            default:
-                log_fatal("[IOPDMAC] handle transfer for channel %d", i);
+    // each active channel transfers a word every 4 cycles
+    for (int step = 0; step < cycles; step += 4) {
+        bool active = false;
+
+        for (int i = 7; i < 13; i++) {
+            if (GetChannelEnable(i) && (channels[i].control & (1 << 24))) {
+                active = true;
+
+                switch (i) {
+                case 7:
+                    DoSPU2Transfer();
+                    break;
+                case 9:
+                    DoSIF0Transfer();
+                    break;
+                case 10:
+                    DoSIF1Transfer();
+                    break;
+                default:
+                    log_fatal("[IOPDMAC] handle transfer for channel %d", i);
+                }
             }
         }
+
+        if (!active) {
+            return;
+        }
     }
 }
 
@@ -48,12 +68,12 @@ u32 IOPDMAC::ReadRegister(u32 addr) {
     case 0x1F8010F0:
         return dpcr;
     case 0x1F8010F4:
-        LogFile::Get().Log("[IOPDMAC] dicr read %08x\n", dicr.data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC] dicr read %08x\n", dicr.data);
         return dicr.data;
     case 0x1F801570:
         return dpcr2;
     case 0x1F801574:
-        LogFile::Get().Log("[IOPDMAC] dicr2 read %08x\n", dicr2.data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC] dicr2 read %08x\n", dicr2.data);
         return dicr2.data;
     case 0x1F801578:
         return global_dma_enable;
@@ -70,16 +90,16 @@ u32 IOPDMAC::ReadChannel(u32 addr) {
 
     switch (index) {
     case 0x0:
-        log_debug("[IOPDMAC %d] Dn_MADR read %08x", channel, channels[channel].address);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC %d] Dn_MADR read %08x\n", channel, channels[channel].address);
         return channels[channel].address;
     case 0x4:
-        log_debug("[IOPDMAC %d] Dn_BCR read %08x", channel, (channels[channel].block_count << 16) | (channels[channel].block_size));
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC %d] Dn_BCR read %08x\n", channel, (channels[channel].block_count << 16) | (channels[channel].block_size));
         return (channels[channel].block_count << 16) | (channels[channel].block_size);
     case 0x8:
-        log_debug("[IOPDMAC %d] Dn_CHCR read %08x", channel, channels[channel].control);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC %d] Dn_CHCR read %08x\n", channel, channels[channel].control);
         return channels[channel].control;
     case 0xC:
-        log_debug("[IOPDMAC %d] Dn_TADR read %08x", channel, channels[channel].tag_address);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Trace, "[IOPDMAC %d] Dn_TADR read %08x\n", channel, channels[channel].tag_address);
         return channels[channel].tag_address;
     default:
         log_fatal("[IOPDMAC] %08x", index);
@@ -89,11 +109,11 @@ u32 IOPDMAC::ReadChannel(u32 addr) {
 void IOPDMAC::WriteRegister(u32 addr, u32 data) {
     switch (addr) {
     case 0x1F8010F0:
-        log_debug("[IOPDMAC] dpcr write %08x", data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC] dpcr write %08x\n", data);
         dpcr = data;
         break;
     case 0x1F8010F4:
-        LogFile::Get().Log("[IOPDMAC] dicr write %08x\n", data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC] dicr write %08x\n", data);
         dicr.data = data;
 
         // writing 1 to the flag bits clears them
@@ -106,7 +126,7 @@ void IOPDMAC::WriteRegister(u32 addr, u32 data) {
         dpcr2 = data;
         break;
     case 0x1F801574:
-        LogFile::Get().Log("[IOPDMAC] dicr2 write %08x\n", data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC] dicr2 write %08x\n", data);
         dicr2.data = data;
 
         // writing 1 to the flag bits clears them
@@ -147,29 +167,30 @@ void IOPDMAC::WriteChannel(u32 addr, u32 data) {
 
     switch (index) {
     case 0x0:
-        LogFile::Get().Log("[IOPDMAC %d] address write %08x\n", channel, data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] address write %08x\n", channel, data);
         channels[channel].address = data & 0xFFFFFF;
         break;
     case 0x4:
-        LogFile::Get().Log("[IOPDMAC %d] block size and count write %08x\n", channel, data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] block size and count write %08x\n", channel, data);
         channels[channel].block_size = data & 0xFFFF;
         channels[channel].block_count = (data >> 16) & 0xFFFF;
         break;
     case 0x6:
-        LogFile::Get().Log("[IOPDMAC %d] block count write %08x\n", channel, data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] block count write %08x\n", channel, data);
         channels[channel].block_count = data & 0xFFFF;
         break;
     case 0x8:
-        LogFile::Get().Log("[IOPDMAC %d] control write %08x\n", channel, data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] control write %08x\n", channel, data);
         channels[channel].control = data;
 
         if (data & (1 << 24)) {
-            LogFile::Get().Log("[IOPDMAC %d] transfer started\n", channel);
+            log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] transfer started\n", channel);
+            trace_async_begin("dma", channel_names[channel], TRACE_ID_BASE + channel);
         }
 
         break;
     case 0xC:
-        LogFile::Get().Log("[IOPDMAC %d] tag address %08x\n", channel, data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] tag address %08x\n", channel, data);
         channels[channel].tag_address = data;
         break;
     default:
@@ -180,6 +201,12 @@ void IOPDMAC::WriteChannel(u32 addr, u32 data) {
 void IOPDMAC::DoSIF0Transfer() {
     Channel& channel = channels[9];
 
+    // the ee might not have caught up with the fifo yet, in which case we wait for it.
+    // this leaves room for either a word of data or the 2 words after a tag
+    if (system.sif.GetSIF0FIFOSpace() < 2) {
+        return;
+    }
+
     if (channel.block_count) {
         // read data from iop ram and push to the sif0 fifo
         system.sif.WriteSIF0FIFO(system.iop_core->ReadWord(channel.address));
@@ -192,7 +219,7 @@ void IOPDMAC::DoSIF0Transfer() {
         u32 data = system.iop_core->ReadWord(channel.tag_address);
         u32 block_count = system.iop_core->ReadWord(channel.tag_address + 4);
 
-        LogFile::Get().Log("[IOPDMAC] SIF0 read DMATag %016lx\n", ((u64)block_count << 32) | data);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC] SIF0 read DMATag %016lx\n", ((u64)block_count << 32) | data);
 
         system.sif.WriteSIF0FIFO(system.iop_core->ReadWord(channel.tag_address + 8));
         system.sif.WriteSIF0FIFO(system.iop_core->ReadWord(channel.tag_address + 12));
@@ -225,6 +252,9 @@ void IOPDMAC::DoSIF1Transfer() {
             system.iop_core->WriteWord(channel.address, data);
             channel.address += 4;
             channel.block_count--;
+
+            // the iop could be polling ram for this data, so it can't be left idle
+            system.iop_core->idle = false;
         }
     } else if (channel.end_transfer) {
         EndTransfer(10);
@@ -235,7 +265,7 @@ void IOPDMAC::DoSIF1Transfer() {
             dma_tag |= system.sif.ReadSIF1FIFO();
             dma_tag |= (u64)system.sif.ReadSIF1FIFO() << 32;
 
-            LogFile::Get().Log("[IOPDMAC] SIF1 read DMATag %016lx\n", dma_tag);
+            log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC] SIF1 read DMATag %016lx\n", dma_tag);
 
             channel.address = dma_tag & 0xFFFFFF;
             channel.block_count = dma_tag >> 32;
@@ -267,7 +297,8 @@ void IOPDMAC::DoSPU2Transfer() {
 }
 
 void IOPDMAC::EndTransfer(int index) {
-    LogFile::Get().Log("[IOPDMAC %d] end transfer\n", index);
+    log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] end transfer\n", index);
+    trace_async_end("dma", channel_names[index], TRACE_ID_BASE + index);
 
     // hack for now for spu2 status register to be updated
     if (index == 7) {
@@ -281,7 +312,7 @@ void IOPDMAC::EndTransfer(int index) {
     dicr2.flags |= (1 << (index - 7));
 
     if (dicr2.flags & dicr2.masks) {
-        LogFile::Get().Log("[IOPDMAC %d] interrupt was requested\n", index);
+        log_channel(LogChannel::IOPDMAC, LogLevel::Debug, "[IOPDMAC %d] interrupt was requested\n", index);
         system.iop_core->interrupt_controller.RequestInterrupt(IOPInterruptSource::DMA);
     }
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+// every instruction that the iop interpreter implements, as
+// X(handler, table, index)
+#define IOP_INSTRUCTION_LIST(X) \
+    /* primary instructions */ \
+    X(bcondz, Primary, 1) \
+    X(j, Primary, 2) \
+    X(jal, Primary, 3) \
+    X(beq, Primary, 4) \
+    X(bne, Primary, 5) \
+    X(blez, Primary, 6) \
+    X(bgtz, Primary, 7) \
+    X(addi, Primary, 8) \
+    X(addiu, Primary, 9) \
+    X(slti, Primary, 10) \
+    X(sltiu, Primary, 11) \
+    X(andi, Primary, 12) \
+    X(ori, Primary, 13) \
+    X(lui, Primary, 15) \
+    X(lb, Primary, 32) \
+    X(lh, Primary, 33) \
+    X(lwl, Primary, 34) \
+    X(lw, Primary, 35) \
+    X(lbu, Primary, 36) \
+    X(lhu, Primary, 37) \
+    X(lwr, Primary, 38) \
+    X(sb, Primary, 40) \
+    X(sh, Primary, 41) \
+    X(swl, Primary, 42) \
+    X(sw, Primary, 43) \
+    X(swr, Primary, 46) \
+    /* secondary instructions */ \
+    X(sll, Secondary, 0) \
+    X(srl, Secondary, 2) \
+    X(sra, Secondary, 3) \
+    X(sllv, Secondary, 4) \
+    X(srlv, Secondary, 6) \
+    X(srav, Secondary, 7) \
+    X(jr, Secondary, 8) \
+    X(jalr, Secondary, 9) \
+    X(syscall_exception, Secondary, 12) \
+    X(mfhi, Secondary, 16) \
+    X(mthi, Secondary, 17) \
+    X(mflo, Secondary, 18) \
+    X(mtlo, Secondary, 19) \
+    X(mult, Secondary, 24) \
+    X(multu, Secondary, 25) \
+    X(div, Secondary, 26) \
+    X(divu, Secondary, 27) \
+    X(add, Secondary, 32) \
+    X(addu, Secondary, 33) \
+    X(subu, Secondary, 35) \
+    X(andd, Secondary, 36) \
+    X(orr, Secondary, 37) \
+    X(xorr, Secondary, 38) \
+    X(nor, Secondary, 39) \
+    X(slt, Secondary, 42) \
+    X(sltu, Secondary, 43) \
+    /* cop0 instructions */ \
+    X(mfc0, COP0, 0) \
+    X(mtc0, COP0, 4) \
+    X(rfe, COP0, 16)
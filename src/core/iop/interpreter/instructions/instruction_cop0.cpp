@@ -8,6 +8,7 @@ void IOPInterpreter::mfc0() {
 
 void IOPInterpreter::mtc0() {
     cop0.SetReg(inst.rd, GetReg(inst.rt));
+    UpdateInterrupts();
 }
 
 void IOPInterpreter::rfe() {
@@ -15,4 +16,5 @@ void IOPInterpreter::rfe() {
     u8 stack = cop0.gpr[12] & 0x3F;
     cop0.gpr[12] &= ~0xF;
     cop0.gpr[12] |= (stack >> 2);
+    UpdateInterrupts();
 }
\ No newline at end of file
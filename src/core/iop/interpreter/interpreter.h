@@ -19,13 +19,38 @@ public:
     void Reset() override;
     void Run(int cycles) override;
 
-private:
+    // the primary, secondary and cop0 tables are flattened into one,
+    // so that any instruction can be dispatched with a single lookup
+    static constexpr int GetTableOffset(InstructionTable table) {
+        switch (table) {
+        case InstructionTable::Primary: return 0;
+        case InstructionTable::Secondary: return 64;
+        case InstructionTable::COP0: return 128;
+        default: return 0;
+        }
+    }
+
+    static constexpr int NUM_INSTRUCTIONS = 160;
+
+    static int GetInstructionIndex(CPUInstruction inst) {
+        switch (inst.opcode) {
+        case 0:
+            return GetTableOffset(InstructionTable::Secondary) + inst.func;
+        case 16:
+            return GetTableOffset(InstructionTable::COP0) + inst.rs;
+        default:
+            return inst.opcode;
+        }
+    }
+
+protected:
     typedef void (IOPInterpreter::*InstructionHandler)();
     void RegisterOpcode(InstructionHandler handler, int index, InstructionTable table);
 
+    // moves on from a branch once its delay slot has been executed
+    void UpdateBranchDelay();
+
     void UndefinedInstruction();
-    void SecondaryInstruction();
-    void COP0Instruction();
 
     void mfc0();
     void sll();
@@ -87,6 +112,5 @@ private:
 
     CPUInstruction inst;
 
-    std::array<InstructionHandler, 64> primary_table;
-    std::array<InstructionHandler, 64> secondary_table;
+    std::array<InstructionHandler, NUM_INSTRUCTIONS> table;
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string.h>
+#include "core/iop/interpreter/threaded_interpreter.h"
+#include "core/iop/interpreter/instruction_list.h"
+#include "core/system.h"
+
+IOPThreadedInterpreter::IOPThreadedInterpreter(System* system) : IOPInterpreter(system) {}
+
+inline u32 IOPThreadedInterpreter::Fetch() {
+    if ((regs.pc >> 12) != fetch_page) {
+        UpdateFetchPage();
+    }
+
+    if (fetch_pointer) {
+        u32 data;
+        memcpy(&data, fetch_pointer + (regs.pc & 0xFFF), sizeof(u32));
+        return data;
+    }
+
+    return ReadWord(regs.pc);
+}
+
+void IOPThreadedInterpreter::UpdateFetchPage() {
+    fetch_page = regs.pc >> 12;
+    fetch_pointer = system->memory.iop_map.GetReadPage(regs.pc & 0x1FFFFFFF);
+}
+
+#if defined(__GNUC__)
+
+void IOPThreadedInterpreter::Run(int cycles) {
+    static std::array<void*, NUM_INSTRUCTIONS> dispatch_table;
+    static std::atomic<bool> dispatch_table_generated = false;
+    static std::mutex dispatch_table_mutex;
+
+    // several systems can be running on different threads, so only one of them gets to fill the table
+    if (!dispatch_table_generated.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(dispatch_table_mutex);
+
+        if (!dispatch_table_generated.load(std::memory_order_relaxed)) {
+            dispatch_table.fill(&&undefined_instruction);
+
+#define REGISTER_LABEL(name, table, index) \
+            dispatch_table[GetTableOffset(InstructionTable::table) + index] = &&op_##name;
+            IOP_INSTRUCTION_LIST(REGISTER_LABEL)
+#undef REGISTER_LABEL
+
+            dispatch_table_generated.store(true, std::memory_order_release);
+        }
+    }
+
+    idle = false;
+
+    if (cycles <= 0) {
+        return;
+    }
+
+    slice_cycles = cycles;
+    cycles_left = cycles;
+
+// fetches the next instruction and jumps straight to its handler
+#define FETCH_AND_DISPATCH() \
+    inst = CPUInstruction{Fetch()}; \
+    if (regs.pc == 0x00012C48 || regs.pc == 0x0001420C || regs.pc == 0x0001430C) { \
+        IOPPuts(); \
+    } \
+    goto *dispatch_table[GetInstructionIndex(inst)];
+
+// finishes off the current instruction before moving on to the next one
+#define DISPATCH() \
+    regs.pc += 4; \
+    if (branch_delay) { \
+        UpdateBranchDelay(); \
+    } \
+    if (interrupt_pending) { \
+        CheckInterrupts(); \
+    } \
+    if (--cycles_left == 0 || idle) { \
+        goto done; \
+    } \
+    FETCH_AND_DISPATCH();
+
+    fetch_page = 0xFFFFFFFF;
+    FETCH_AND_DISPATCH();
+
+#define HANDLER_LABEL(name, table, index) \
+op_##name: \
+    name(); \
+    DISPATCH();
+    IOP_INSTRUCTION_LIST(HANDLER_LABEL)
+#undef HANDLER_LABEL
+
+undefined_instruction:
+    UndefinedInstruction();
+    DISPATCH();
+
+#undef DISPATCH
+#undef FETCH_AND_DISPATCH
+
+done:
+    if (idle) {
+        SkipIdleCycles(cycles_left);
+    }
+
+    // the scheduler gets ticked for the whole slice after this
+    cycles_left = 0;
+    slice_cycles = 0;
+}
+
+#else
+
+void IOPThreadedInterpreter::Run(int cycles) {
+    IOPInterpreter::Run(cycles);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "core/iop/interpreter/interpreter.h"
+
+// the same as the interpreter, except each handler is called directly and
+// then jumps straight to the next one through a computed goto, with
+// instructions fetched from a host pointer to the current code page.
+// on compilers without computed gotos this falls back to the normal interpreter
+class IOPThreadedInterpreter : public IOPInterpreter {
+public:
+    IOPThreadedInterpreter(System* system);
+
+    void Run(int cycles) override;
+
+private:
+    u32 Fetch();
+    void UpdateFetchPage();
+
+    u32 fetch_page = 0xFFFFFFFF;
+    u8* fetch_pointer = nullptr;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "common/log.h"
+#include "common/tracer.h"
 #include "core/iop/interrupt_controller.h"
 #include "core/system.h"
 
@@ -49,6 +50,7 @@ void IOPInterruptController::WriteRegister(int offset, u32 data) {
 }
 
 void IOPInterruptController::RequestInterrupt(IOPInterruptSource source) {
+    trace_instant("interrupt", "IOP Interrupt", static_cast<u64>(source));
     interrupt_status |= 1 << static_cast<u32>(source);
     UpdateInterrupts();
 }
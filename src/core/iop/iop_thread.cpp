@@ -0,0 +1,116 @@
+#include "common/log_file.h"
+#include "common/tracer.h"
+#include "core/iop/iop_thread.h"
+#include "core/system.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPIN_PAUSE() _mm_pause()
+#else
+#define SPIN_PAUSE()
+#endif
+
+// how many times to check for a slice before backing off. a slice is usually
+// only a few microseconds of work, so the other side is rarely kept waiting long
+#define SPIN_COUNT 4096
+
+// spinning only helps when the other thread can be running at the same time
+IOPThread::IOPThread(System& system) : system(system), spin_count(std::thread::hardware_concurrency() > 1 ? SPIN_COUNT : 1) {}
+
+IOPThread::~IOPThread() {
+    Stop();
+}
+
+void IOPThread::Start() {
+    if (IsRunning()) {
+        return;
+    }
+
+    quit = false;
+    requested_slices = 0;
+    completed_slices = 0;
+
+    LogFile* log_file = &LogFile::Get();
+
+    thread = std::thread{[this, log_file]() {
+        ThreadLoop(log_file);
+    }};
+}
+
+void IOPThread::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    condition.notify_one();
+    thread.join();
+}
+
+void IOPThread::Run(int cycles) {
+    slice_cycles = cycles;
+    requested_slices.fetch_add(1, std::memory_order_seq_cst);
+
+    // taking the lock means the thread is either already waiting on the condition or
+    // hasn't checked for a slice yet, so the notification can't get lost
+    if (sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_one();
+    }
+}
+
+void IOPThread::Wait() {
+    u64 slice = requested_slices.load(std::memory_order_relaxed);
+    int spins = 0;
+
+    while (completed_slices.load(std::memory_order_acquire) != slice) {
+        if (++spins < spin_count) {
+            SPIN_PAUSE();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void IOPThread::ThreadLoop(LogFile* log_file) {
+    LogFile::Bind(log_file);
+    Tracer::SetThreadName("IOP");
+
+    u64 slice = 0;
+
+    while (WaitForSlice(slice + 1)) {
+        slice++;
+        trace_scope("iop", "IOP Slice", slice);
+
+        system.iop_core->Run(slice_cycles);
+        system.iop_dmac.Run(slice_cycles);
+
+        completed_slices.store(slice, std::memory_order_release);
+    }
+
+    LogFile::Bind(nullptr);
+}
+
+bool IOPThread::WaitForSlice(u64 slice) {
+    for (int i = 0; i < spin_count; i++) {
+        if (requested_slices.load(std::memory_order_acquire) >= slice) {
+            return true;
+        }
+
+        SPIN_PAUSE();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    sleeping.store(true, std::memory_order_seq_cst);
+
+    condition.wait(lock, [this, slice]() {
+        return quit || requested_slices.load(std::memory_order_seq_cst) >= slice;
+    });
+
+    sleeping.store(false, std::memory_order_relaxed);
+    return !quit;
+}
\ No newline at end of file
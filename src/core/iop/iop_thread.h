@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "common/types.h"
+
+class System;
+class LogFile;
+
+// runs the iop and its dmac on a second host thread. the ee thread hands it a slice at
+// the start of each of its own slices and waits for it at the end, so the two only
+// ever drift apart by a slice. everything else waits on the ee side of that barrier,
+// which means scheduler events and interrupts from the ee side see the iop stopped.
+// in the middle of a slice both threads can use the sif, which is lock-free, and iop ram,
+// which the ee maps at 0x1C000000. for iop ram only the guest's own memory is shared, as it
+// is on hardware. the iop's code tracking isn't, so ee writes there get checked against
+// it at the barrier (see Memory::SetDeferIOPCodeWrites), and so do iop timer interrupts,
+// since the scheduler belongs to the ee thread (see IOPTimers::SetDeferScheduling)
+class IOPThread {
+public:
+    IOPThread(System& system);
+    ~IOPThread();
+
+    // the thread picks up the log of the thread that starts it
+    void Start();
+    void Stop();
+
+    bool IsRunning() {
+        return thread.joinable();
+    }
+
+    // hands the iop a slice of iop cycles to run, without waiting for it
+    void Run(int cycles);
+
+    // blocks until the iop has finished the last slice it was given
+    void Wait();
+
+private:
+    void ThreadLoop(LogFile* log_file);
+
+    // waits for the next slice, spinning at first since it's usually
+    // not far off, and then sleeping so that an idle system doesn't hog a core
+    bool WaitForSlice(u64 slice);
+
+    System& system;
+    std::thread thread;
+    int spin_count;
+
+    // written by the ee thread before it publishes the slice
+    int slice_cycles = 0;
+
+    // the two counters are bumped by different threads, so they're kept on separate cache lines
+    alignas(64) std::atomic<u64> requested_slices = 0;
+    alignas(64) std::atomic<u64> completed_slices = 0;
+
+    std::atomic<bool> quit = false;
+    std::atomic<bool> sleeping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
\ No newline at end of file
@@ -1,59 +1,37 @@
+#include <algorithm>
+#include <limits>
 #include "common/log.h"
 #include "common/log_file.h"
 #include "core/iop/timers.h"
 #include "core/system.h"
+#include "core/timing.h"
 
-IOPTimers::IOPTimers(System& system) : system(system) {}
+// the iop runs at 1 / 8 speed of the ee
+#define IOP_CYCLES 8
+
+// the pixel clock is 13.5mhz, which is about 22 ee cycles
+#define PIXEL_CYCLES 22
+
+IOPTimers::IOPTimers(System& system) : system(system) {
+    interrupt_kind = system.scheduler.RegisterEvent<&IOPTimers::InterruptEvent>(this, "IOP Timer Interrupt");
+}
 
 void IOPTimers::Reset() {
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < 6; i++) {
         channels[i].counter = 0;
         channels[i].mode = 0;
         channels[i].target = 0;
-    }
-}
-
-// TODO: handle repeat bit
-void IOPTimers::Run(int cycles) {
-    // only timer 5 is required for now it seems
-    Channel& channel = channels[5];
-
-    u32 old_counter = channel.counter;
-    channel.counter += cycles;
+        channels[i].timestamp = 0;
+        channels[i].cycles_per_tick = IOP_CYCLES;
+        channels[i].overflow = i < 3 ? 0x10000 : 0x100000000;
 
-    if ((channel.counter >= channel.target) && (old_counter < channel.target)) {
-        channel.mode |= (1 << 11);
-
-        if ((channel.mode & (1 << 4)) && (channel.mode & (1 << 10))) {
-            LogFile::Get().Log("[IOP Timers] channel 5 send timer interrupt\n");
-            system.iop_core->interrupt_controller.RequestInterrupt(IOPInterruptSource::Timer5);
-
-            if ((channel.mode & (1 << 6)) == 0) {
-                // bit 10 of mode is set to 0 after an interrupt occurs
-                channel.mode &= ~(1 << 10);
-            }
-        }
-
-        if (channel.mode & (1 << 3)) {
-            channel.counter = 0;
-        }
+        // the scheduler has already been reset, so there's nothing to cancel
+        channels[i].interrupt_event = Scheduler::INVALID_EVENT;
+        channels[i].target_time = std::numeric_limits<u64>::max();
+        channels[i].overflow_time = std::numeric_limits<u64>::max();
     }
 
-    if (channel.counter > 0xFFFF) {
-        channel.mode |= (1 << 12);
-
-        if ((channel.mode & (1 << 5)) && (channel.mode & (1 << 10))) {
-            LogFile::Get().Log("[IOP Timers] channel 5 send timer interrupt\n");
-            system.iop_core->interrupt_controller.RequestInterrupt(IOPInterruptSource::Timer5);
-
-            if ((channel.mode & (1 << 6)) == 0) {
-                // bit 10 of mode is set to 0 after an interrupt occurs
-                channel.mode &= ~(1 << 10);
-            }
-        }
-
-        channel.counter = 0;
-    }
+    pending_interrupts = 0;
 }
 
 u32 IOPTimers::ReadRegister(u32 addr) {
@@ -62,13 +40,20 @@ u32 IOPTimers::ReadRegister(u32 addr) {
 
     switch (index) {
     case 0x0:
+        Sync(channel, system.iop_core->GetCurrentTime());
         return channels[channel].counter;
-    case 0x4:
+    case 0x4: {
+        // the flags are only set when the counter gets brought up to date
+        Sync(channel, system.iop_core->GetCurrentTime());
+
+        u32 mode = channels[channel].mode;
+
         // reads clear the two raised interrupt flags
         channels[channel].mode &= ~(1 << 11);
         channels[channel].mode &= ~(1 << 12);
 
-        return channels[channel].mode;
+        return mode;
+    }
     case 0x8:
         return channels[channel].target;
     default:
@@ -80,19 +65,22 @@ void IOPTimers::WriteRegister(u32 addr, u32 data) {
     int channel = GetTimerIndex(addr);
     int index = addr & 0xF;
 
+    Sync(channel, system.iop_core->GetCurrentTime());
+
     switch (index) {
     case 0x0:
-        channels[channel].counter = data;
+        channels[channel].counter = data & (channels[channel].overflow - 1);
         break;
     case 0x4:
         channels[channel].mode = data;
 
         // mode writes set counter to 0 and bit 10 to 1
-        channels[channel].counter = data;
+        channels[channel].counter = 0;
         channels[channel].mode |= (1 << 10);
+        UpdateClock(channel);
         break;
     case 0x8:
-        channels[channel].target = data;
+        channels[channel].target = data & (channels[channel].overflow - 1);
 
         // biit 7 of mode is not set,
         // then writes to target set bit 10 of
@@ -105,6 +93,8 @@ void IOPTimers::WriteRegister(u32 addr, u32 data) {
     default:
         log_fatal("handle %02x", index);
     }
+
+    ScheduleInterrupt(channel);
 }
 
 int IOPTimers::GetTimerIndex(u32 addr) {
@@ -115,4 +105,200 @@ int IOPTimers::GetTimerIndex(u32 addr) {
     } else {
         return channel;
     }
+}
+
+void IOPTimers::Sync(int index, u64 now) {
+    Channel& channel = channels[index];
+
+    // never go past an interrupt that hasn't been raised yet. its event
+    // brings the counter up to the time it's due and raises it from there
+    now = std::min({now, channel.target_time, channel.overflow_time});
+
+    if (now <= channel.timestamp) {
+        return;
+    }
+
+    // ticks happen on multiples of the tick length, rather than relative to when the counter started
+    Advance(channel, (now / channel.cycles_per_tick) - (channel.timestamp / channel.cycles_per_tick));
+    channel.timestamp = now;
+}
+
+void IOPTimers::Advance(Channel& channel, u64 ticks) {
+    // with bit 3 set the counter goes back to 0 when it reaches target, otherwise when it overflows
+    bool reset_on_target = (channel.mode & (1 << 3)) && channel.target;
+
+    while (ticks) {
+        bool wraps_at_target = reset_on_target && channel.counter < channel.target;
+        u64 limit = wraps_at_target ? channel.target : channel.overflow;
+
+        // the counter can pass target without wrapping, which still raises its flag
+        if (!wraps_at_target && channel.target > channel.counter && channel.target <= channel.counter + ticks) {
+            channel.mode |= (1 << 11);
+        }
+
+        if (channel.counter + ticks < limit) {
+            channel.counter += ticks;
+            return;
+        }
+
+        ticks -= limit - channel.counter;
+        channel.counter = 0;
+        channel.mode |= wraps_at_target ? (1 << 11) : (1 << 12);
+
+        // after wrapping the counter goes round the same cycle, so any whole
+        // cycles left over can be skipped, as long as their flags get raised
+        u64 period = reset_on_target ? channel.target : channel.overflow;
+
+        if (ticks >= period) {
+            channel.mode |= reset_on_target ? (1 << 11) : (1 << 12);
+
+            if (channel.target) {
+                channel.mode |= (1 << 11);
+            }
+        }
+
+        ticks %= period;
+    }
+}
+
+void IOPTimers::UpdateClock(int index) {
+    Channel& channel = channels[index];
+    u32 mode = channel.mode;
+
+    channel.cycles_per_tick = IOP_CYCLES;
+
+    switch (index) {
+    case 0:
+        if (mode & (1 << 8)) {
+            channel.cycles_per_tick = PIXEL_CYCLES;
+        }
+
+        break;
+    case 1:
+    case 3:
+        if (mode & (1 << 8)) {
+            channel.cycles_per_tick = HBLANK_CYCLES;
+        }
+
+        break;
+    case 2:
+        if (mode & (1 << 9)) {
+            channel.cycles_per_tick = IOP_CYCLES * 8;
+        }
+
+        break;
+    case 4:
+    case 5: {
+        // the prescaler for the last 2 channels is in bits 13 and 14
+        static constexpr int prescales[4] = {1, 8, 16, 256};
+        channel.cycles_per_tick = IOP_CYCLES * prescales[(mode >> 13) & 0x3];
+        break;
+    }
+    }
+}
+
+u64 IOPTimers::GetTickTime(Channel& channel, u64 ticks) {
+    return ((channel.timestamp / channel.cycles_per_tick) + ticks) * channel.cycles_per_tick;
+}
+
+void IOPTimers::ScheduleInterrupt(int index) {
+    UpdateInterruptTimes(index);
+
+    if (defer_scheduling) {
+        pending_interrupts |= 1 << index;
+        return;
+    }
+
+    AddInterruptEvent(index);
+}
+
+void IOPTimers::SetDeferScheduling(bool defer) {
+    SchedulePendingInterrupts();
+    defer_scheduling = defer;
+}
+
+void IOPTimers::SchedulePendingInterrupts() {
+    for (int i = 0; i < 6; i++) {
+        if (pending_interrupts & (1 << i)) {
+            AddInterruptEvent(i);
+        }
+    }
+
+    pending_interrupts = 0;
+}
+
+void IOPTimers::UpdateInterruptTimes(int index) {
+    Channel& channel = channels[index];
+
+    channel.target_time = std::numeric_limits<u64>::max();
+    channel.overflow_time = std::numeric_limits<u64>::max();
+
+    // bit 10 of mode gets cleared after a one shot interrupt, so nothing can be raised until it's set again
+    if (!(channel.mode & (1 << 10))) {
+        return;
+    }
+
+    bool reset_on_target = (channel.mode & (1 << 3)) && channel.target;
+
+    if ((channel.mode & (1 << 4)) && channel.target) {
+        u64 ticks = channel.target > channel.counter ? channel.target - channel.counter : channel.overflow - channel.counter + channel.target;
+        channel.target_time = GetTickTime(channel, ticks);
+    }
+
+    // once the counter is below target it never gets past it
+    if ((channel.mode & (1 << 5)) && !(reset_on_target && channel.counter < channel.target)) {
+        channel.overflow_time = GetTickTime(channel, channel.overflow - channel.counter);
+    }
+}
+
+void IOPTimers::AddInterruptEvent(int index) {
+    Channel& channel = channels[index];
+    Scheduler& scheduler = system.scheduler;
+
+    scheduler.Cancel(channel.interrupt_event);
+    channel.interrupt_event = Scheduler::INVALID_EVENT;
+
+    u64 time = std::min(channel.target_time, channel.overflow_time);
+
+    if (time == std::numeric_limits<u64>::max()) {
+        return;
+    }
+
+    u64 now = scheduler.GetCurrentTime();
+    channel.interrupt_event = scheduler.Add(time > now ? time - now : 0, interrupt_kind, index);
+}
+
+// TODO: handle toggle mode for bit 10
+void IOPTimers::InterruptEvent(u64 index) {
+    Channel& channel = channels[index];
+
+    channel.interrupt_event = Scheduler::INVALID_EVENT;
+    Sync(index, system.scheduler.GetCurrentTime());
+
+    if (channel.timestamp >= channel.target_time || channel.timestamp >= channel.overflow_time) {
+        log_channel(LogChannel::IOPTimers, LogLevel::Debug, "[IOP Timers] channel %d send timer interrupt\n", static_cast<int>(index));
+        RequestInterrupt(index);
+
+        if ((channel.mode & (1 << 6)) == 0) {
+            // bit 10 of mode is set to 0 after an interrupt occurs
+            channel.mode &= ~(1 << 10);
+        }
+    }
+
+    // events only run on the ee thread while the iop is stopped, so this never has to be deferred
+    UpdateInterruptTimes(index);
+    AddInterruptEvent(index);
+}
+
+void IOPTimers::RequestInterrupt(int index) {
+    static constexpr IOPInterruptSource sources[6] = {
+        IOPInterruptSource::Timer0,
+        IOPInterruptSource::Timer1,
+        IOPInterruptSource::Timer2,
+        IOPInterruptSource::Timer3,
+        IOPInterruptSource::Timer4,
+        IOPInterruptSource::Timer5,
+    };
+
+    system.iop_core->interrupt_controller.RequestInterrupt(sources[index]);
 }
\ No newline at end of file
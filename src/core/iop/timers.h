@@ -1,24 +1,64 @@
 #pragma once
 
 #include "common/types.h"
+#include "core/scheduler.h"
 
 class System;
 
+// like the ee timers, the counters are only brought up to date when they're accessed, from
+// the time the iop core has run up to, and target and overflow interrupts are scheduled as events
 class IOPTimers {
 public:
     IOPTimers(System& system);
     void Reset();
-    void Run(int cycles);
     u32 ReadRegister(u32 addr);
     void WriteRegister(u32 addr, u32 data);
     int GetTimerIndex(u32 addr);
 
+    // when the iop runs on its own thread it can't touch the scheduler, since the ee
+    // thread uses it at the same time. interrupt events are then only worked out, and
+    // get added to the scheduler once both threads have stopped at the end of the slice
+    void SetDeferScheduling(bool defer);
+    void SchedulePendingInterrupts();
+
     struct Channel {
-        u32 counter;
+        u64 counter;
         u32 mode;
         u32 target;
+
+        // the ee timestamp that counter was last brought up to date at
+        u64 timestamp;
+
+        // how many ee cycles it takes for the counter to increment by 1
+        u64 cycles_per_tick;
+
+        // channels 0 to 2 are 16 bits wide and channels 3 to 5 are 32 bits wide,
+        // so this is the value the counter overflows at
+        u64 overflow;
+
+        EventHandle interrupt_event;
+
+        // when the pending interrupts are due, or the largest possible time if they aren't
+        u64 target_time;
+        u64 overflow_time;
     } channels[6];
     
 private:
+    void Sync(int index, u64 now);
+    void Advance(Channel& channel, u64 ticks);
+    void UpdateClock(int index);
+    void ScheduleInterrupt(int index);
+    void UpdateInterruptTimes(int index);
+    void AddInterruptEvent(int index);
+    u64 GetTickTime(Channel& channel, u64 ticks);
+    void InterruptEvent(u64 index);
+    void RequestInterrupt(int index);
+
+    EventKind interrupt_kind;
+    bool defer_scheduling = false;
+
+    // a bit for each channel that has an event waiting to be added
+    int pending_interrupts = 0;
+
     System& system;
 };
\ No newline at end of file
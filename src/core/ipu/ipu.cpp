@@ -1,3 +1,4 @@
+#include "common/log_file.h"
 #include <core/ipu/ipu.h>
 
 void IPU::Reset() {
@@ -18,7 +19,7 @@ void IPU::WriteControl(u32 data) {
         log_fatal("handle");
     }
 
-    log_warn("[IPU] write control %08x", data);
+    log_channel(LogChannel::IPU, LogLevel::Debug, "[IPU] write control %08x\n", data);
     control = data;
 }
 
@@ -27,7 +28,7 @@ u32 IPU::ReadControl() {
 }
 
 void IPU::WriteCommand(u32 data) {
-    log_warn("[IPU] write command %08x", data);
+    log_channel(LogChannel::IPU, LogLevel::Debug, "[IPU] write command %08x\n", data);
 
     command = data;
 }
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "common/log.h"
+#include "common/memory_map.h"
+#include "core/memory/fastmem.h"
+#include "core/memory/guest_memory.h"
+#include "core/ee/tlb.h"
+
+#if defined(FASTMEM_SUPPORTED)
+
+#include <array>
+#include <atomic>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+#define WINDOW_SIZE 0x100000000ULL
+
+// each stub is a single access followed by a ret. the _end label is where
+// the fault handler resumes once it has done the access itself
+asm(R"asm(
+    .text
+
+    .macro fastmem_stub name, instruction
+    .globl \name
+    .hidden \name
+    .type \name, @function
+    .globl \name\()_end
+    .hidden \name\()_end
+\name:
+    \instruction
+\name\()_end:
+    ret
+    .size \name, . - \name
+    .endm
+
+    fastmem_stub fastmem_read8, "movzbl (%rdi), %eax"
+    fastmem_stub fastmem_read16, "movzwl (%rdi), %eax"
+    fastmem_stub fastmem_read32, "movl (%rdi), %eax"
+    fastmem_stub fastmem_read64, "movq (%rdi), %rax"
+    fastmem_stub fastmem_write8, "movb %sil, (%rdi)"
+    fastmem_stub fastmem_write16, "movw %si, (%rdi)"
+    fastmem_stub fastmem_write32, "movl %esi, (%rdi)"
+    fastmem_stub fastmem_write64, "movq %rsi, (%rdi)"
+)asm");
+
+extern "C" char fastmem_read8_end[], fastmem_read16_end[], fastmem_read32_end[], fastmem_read64_end[];
+extern "C" char fastmem_write8_end[], fastmem_write16_end[], fastmem_write32_end[], fastmem_write64_end[];
+
+struct FaultStub {
+    void* address;
+    void* resume;
+    int size;
+    bool write;
+};
+
+static const FaultStub fault_stubs[] = {
+    {reinterpret_cast<void*>(fastmem_read8), fastmem_read8_end, 1, false},
+    {reinterpret_cast<void*>(fastmem_read16), fastmem_read16_end, 2, false},
+    {reinterpret_cast<void*>(fastmem_read32), fastmem_read32_end, 4, false},
+    {reinterpret_cast<void*>(fastmem_read64), fastmem_read64_end, 8, false},
+    {reinterpret_cast<void*>(fastmem_write8), fastmem_write8_end, 1, true},
+    {reinterpret_cast<void*>(fastmem_write16), fastmem_write16_end, 2, true},
+    {reinterpret_cast<void*>(fastmem_write32), fastmem_write32_end, 4, true},
+    {reinterpret_cast<void*>(fastmem_write64), fastmem_write64_end, 8, true},
+};
+
+// every window that is currently mapped, so that the fault handler
+// can tell which instance a fault belongs to
+static std::array<std::atomic<Fastmem*>, 16> instances;
+static struct sigaction previous_action;
+
+static void FaultHandler(int sig, siginfo_t* info, void* context) {
+    greg_t* regs = static_cast<ucontext_t*>(context)->uc_mcontext.gregs;
+    u8* address = static_cast<u8*>(info->si_addr);
+
+    for (const FaultStub& stub : fault_stubs) {
+        if (reinterpret_cast<void*>(regs[REG_RIP]) != stub.address) {
+            continue;
+        }
+
+        for (std::atomic<Fastmem*>& instance : instances) {
+            Fastmem* fastmem = instance.load(std::memory_order_relaxed);
+
+            if (fastmem && address >= fastmem->base && address < fastmem->base + WINDOW_SIZE) {
+                u64 data = fastmem->HandleFault(address - fastmem->base, stub.size, stub.write, regs[REG_RSI]);
+
+                if (!stub.write) {
+                    regs[REG_RAX] = data;
+                }
+
+                regs[REG_RIP] = reinterpret_cast<greg_t>(stub.resume);
+                return;
+            }
+        }
+    }
+
+    // the fault wasn't ours, so pass it on to whoever was there before us
+    if (previous_action.sa_flags & SA_SIGINFO) {
+        previous_action.sa_sigaction(sig, info, context);
+    } else if (previous_action.sa_handler != SIG_DFL && previous_action.sa_handler != SIG_IGN) {
+        previous_action.sa_handler(sig);
+    } else {
+        // returning will fault again, this time with the default action
+        signal(sig, SIG_DFL);
+    }
+}
+
+static void InstallFaultHandler() {
+    static bool installed = false;
+
+    if (installed) {
+        return;
+    }
+
+    struct sigaction action = {};
+    action.sa_sigaction = FaultHandler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &previous_action);
+    installed = true;
+}
+
+#endif
+
+Fastmem::~Fastmem() {
+    Shutdown();
+}
+
+bool Fastmem::Initialise(GuestMemory& memory, SlowReadHandler slow_read, SlowWriteHandler slow_write) {
+#if defined(FASTMEM_SUPPORTED)
+    Shutdown();
+
+    if (!memory.IsShared()) {
+        return false;
+    }
+
+    this->memory = &memory;
+    this->slow_read = slow_read;
+    this->slow_write = slow_write;
+
+    void* window = mmap(nullptr, WINDOW_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (window == MAP_FAILED) {
+        log_warn("[Fastmem] failed to reserve the address space");
+        Shutdown();
+        return false;
+    }
+
+    base = static_cast<u8*>(window);
+
+    bool registered = false;
+
+    for (std::atomic<Fastmem*>& instance : instances) {
+        Fastmem* expected = nullptr;
+
+        if (instance.compare_exchange_strong(expected, this)) {
+            registered = true;
+            break;
+        }
+    }
+
+    if (!registered) {
+        log_warn("[Fastmem] too many instances");
+        Shutdown();
+        return false;
+    }
+
+    InstallFaultHandler();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Fastmem::Shutdown() {
+#if defined(FASTMEM_SUPPORTED)
+    for (std::atomic<Fastmem*>& instance : instances) {
+        Fastmem* expected = this;
+        instance.compare_exchange_strong(expected, nullptr);
+    }
+
+    if (base) {
+        munmap(base, WINDOW_SIZE);
+    }
+
+    base = nullptr;
+    memory = nullptr;
+#endif
+}
+
+void Fastmem::Update(MemoryMap& map, EETLB& tlb, u32 first, u32 last) {
+#if defined(FASTMEM_SUPPORTED)
+    if (!base || first >= last) {
+        return;
+    }
+
+    // start from pages that aren't accessible
+    u64 start = static_cast<u64>(first) << 12;
+    u64 end = static_cast<u64>(last) << 12;
+    mmap(base + start, end - start, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+
+    // contiguous pages are mapped together, which keeps
+    // this down to a handful of mappings for the default layout
+    u32 run_vaddr = 0;
+    int run_file = -1;
+    u32 run_offset = 0;
+    u32 run_size = 0;
+    bool run_writeable = false;
+
+    for (u64 vaddr = start; vaddr < end; vaddr += 0x1000) {
+        u32 paddr = tlb.Translate(vaddr);
+        u8* page = map.GetReadPage(paddr);
+        int file;
+        u32 offset;
+
+        if (!page || !memory->GetBacking(page, file, offset)) {
+            if (run_size) {
+                MapRun(run_vaddr, run_file, run_offset, run_size, run_writeable);
+                run_size = 0;
+            }
+
+            continue;
+        }
+
+        bool writeable = map.GetWritePage(paddr) == page;
+
+        if (run_size && (run_vaddr + run_size) == vaddr && run_file == file && (run_offset + run_size) == offset && run_writeable == writeable) {
+            run_size += 0x1000;
+            continue;
+        }
+
+        if (run_size) {
+            MapRun(run_vaddr, run_file, run_offset, run_size, run_writeable);
+        }
+
+        run_vaddr = vaddr;
+        run_file = file;
+        run_offset = offset;
+        run_size = 0x1000;
+        run_writeable = writeable;
+    }
+
+    if (run_size) {
+        MapRun(run_vaddr, run_file, run_offset, run_size, run_writeable);
+    }
+#endif
+}
+
+u64 Fastmem::HandleFault(u32 vaddr, int size, bool write, u64 data) {
+    if (write) {
+        // the upper bits of the register are whatever was left in it
+        if (size < 8) {
+            data &= (1ULL << (size * 8)) - 1;
+        }
+
+        slow_write(vaddr, data, size);
+        return 0;
+    }
+
+    return slow_read(vaddr, size);
+}
+
+void Fastmem::MapRun(u32 vaddr, int file, u32 offset, u32 size, bool writeable) {
+#if defined(FASTMEM_SUPPORTED)
+    int protection = writeable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+
+    if (mmap(base + vaddr, size, protection, MAP_SHARED | MAP_FIXED, file, offset) == MAP_FAILED) {
+        log_fatal("[Fastmem] failed to map %08x to %08x", vaddr, offset);
+    }
+#endif
+}
\ No newline at end of file
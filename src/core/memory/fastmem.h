@@ -0,0 +1,118 @@
+#pragma once
+
+#include <functional>
+#include "common/types.h"
+
+#if defined(__linux__) && defined(__x86_64__)
+#define FASTMEM_SUPPORTED
+#endif
+
+class MemoryMap;
+class EETLB;
+class GuestMemory;
+
+// fastmem reserves a 4GB window of host address space and maps guest memory
+// into it following the tlb, so any ee virtual address can be accessed as
+// base + vaddr. pages are mapped from the files that back guest memory, which is
+// what lets the same physical page show up at several virtual addresses.
+// pages which aren't backed by memory (io, or writes to the bios) are left
+// inaccessible. accessing them faults, and the fault handler performs the
+// access through the slow handlers before skipping the faulting instruction.
+// only the load and store stubs in fastmem.cpp are allowed to fault, since the
+// handler needs to know exactly which registers they use
+class Fastmem {
+public:
+    using SlowReadHandler = std::function<u64(u32, int)>;
+    using SlowWriteHandler = std::function<void(u32, u64, int)>;
+
+    ~Fastmem();
+
+    // reserves the window to map memory into. returns false if fastmem isn't
+    // supported, or guest memory isn't backed by shared memory
+    bool Initialise(GuestMemory& memory, SlowReadHandler slow_read, SlowWriteHandler slow_write);
+    void Shutdown();
+
+    // rebuilds the pages from first up to last from the tlb. each virtual page gets mapped to
+    // whichever part of guest memory the memory map has at its physical address
+    void Update(MemoryMap& map, EETLB& tlb, u32 first = 0, u32 last = 0x100000);
+
+    bool IsEnabled() {
+        return base != nullptr;
+    }
+
+    template <typename T>
+    T Read(u32 vaddr);
+
+    template <typename T>
+    void Write(u32 vaddr, T data);
+
+    u8* base = nullptr;
+
+    // called by the fault handler to perform an access that faulted. returns the data for reads
+    u64 HandleFault(u32 vaddr, int size, bool write, u64 data);
+
+private:
+    void MapRun(u32 vaddr, int file, u32 offset, u32 size, bool writeable);
+
+    GuestMemory* memory = nullptr;
+    SlowReadHandler slow_read;
+    SlowWriteHandler slow_write;
+};
+
+#if defined(FASTMEM_SUPPORTED)
+
+extern "C" u8 fastmem_read8(u8* address);
+extern "C" u16 fastmem_read16(u8* address);
+extern "C" u32 fastmem_read32(u8* address);
+extern "C" u64 fastmem_read64(u8* address);
+extern "C" void fastmem_write8(u8* address, u8 data);
+extern "C" void fastmem_write16(u8* address, u16 data);
+extern "C" void fastmem_write32(u8* address, u32 data);
+extern "C" void fastmem_write64(u8* address, u64 data);
+
+template <typename T>
+T Fastmem::Read(u32 vaddr) {
+    if constexpr (sizeof(T) == 1) {
+        return fastmem_read8(base + vaddr);
+    } else if constexpr (sizeof(T) == 2) {
+        return fastmem_read16(base + vaddr);
+    } else if constexpr (sizeof(T) == 4) {
+        return fastmem_read32(base + vaddr);
+    } else if constexpr (sizeof(T) == 8) {
+        return fastmem_read64(base + vaddr);
+    } else {
+        T data;
+        data.ud[0] = fastmem_read64(base + vaddr);
+        data.ud[1] = fastmem_read64(base + vaddr + 8);
+        return data;
+    }
+}
+
+template <typename T>
+void Fastmem::Write(u32 vaddr, T data) {
+    if constexpr (sizeof(T) == 1) {
+        fastmem_write8(base + vaddr, data);
+    } else if constexpr (sizeof(T) == 2) {
+        fastmem_write16(base + vaddr, data);
+    } else if constexpr (sizeof(T) == 4) {
+        fastmem_write32(base + vaddr, data);
+    } else if constexpr (sizeof(T) == 8) {
+        fastmem_write64(base + vaddr, data);
+    } else {
+        fastmem_write64(base + vaddr, data.ud[0]);
+        fastmem_write64(base + vaddr + 8, data.ud[1]);
+    }
+}
+
+#else
+
+// fastmem is never enabled on other platforms, so these are never called
+template <typename T>
+T Fastmem::Read(u32 vaddr) {
+    return T{};
+}
+
+template <typename T>
+void Fastmem::Write(u32 vaddr, T data) {}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include <fstream>
+#include <string.h>
+#include "common/log.h"
+#include "core/memory/guest_memory.h"
+#include "core/memory/memory_constants.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// rdram, iop ram, bios and scratchpad are laid out one after the other
+enum ArenaLayout {
+    RDRAM_OFFSET = 0x0000000,
+    IOP_RAM_OFFSET = 0x2000000,
+    BIOS_OFFSET = 0x2200000,
+    SCRATCHPAD_OFFSET = 0x2600000,
+    ARENA_SIZE = 0x2604000,
+};
+
+GuestMemory::~GuestMemory() {
+    Free();
+}
+
+void GuestMemory::Allocate() {
+    if (base) {
+        return;
+    }
+
+#if defined(__linux__)
+    fd = memfd_create("otterstation", MFD_CLOEXEC);
+
+    if (fd >= 0 && ftruncate(fd, ARENA_SIZE) == 0) {
+        void* mapping = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            base = static_cast<u8*>(mapping);
+        }
+    }
+
+    if (!base) {
+        log_warn("[GuestMemory] failed to create shared memory, fastmem won't be available");
+
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+
+        void* mapping = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (mapping == MAP_FAILED) {
+            log_fatal("[GuestMemory] failed to allocate guest memory");
+        }
+
+        base = static_cast<u8*>(mapping);
+    }
+
+    // only a hint, since huge pages may not be available for shared memory
+    madvise(base + RDRAM_OFFSET, RDRAM_SIZE, MADV_HUGEPAGE);
+#else
+    base = new u8[ARENA_SIZE]();
+#endif
+
+    rdram = base + RDRAM_OFFSET;
+    iop_ram = base + IOP_RAM_OFFSET;
+    bios = base + BIOS_OFFSET;
+    scratchpad = base + SCRATCHPAD_OFFSET;
+}
+
+void GuestMemory::Clear() {
+    struct Region {
+        u8* pointer;
+        u32 size;
+    };
+
+    const Region regions[] = {
+        {rdram, RDRAM_SIZE},
+        {iop_ram, IOP_RAM_SIZE},
+        {scratchpad, SCRATCHPAD_SIZE},
+    };
+
+    for (const Region& region : regions) {
+#if defined(__linux__)
+        // freed pages read back as zero, and only take up memory again once they're touched.
+        // dropping the pages of shared memory needs MADV_REMOVE, otherwise the file keeps them
+        if (madvise(region.pointer, region.size, fd >= 0 ? MADV_REMOVE : MADV_DONTNEED) == 0) {
+            continue;
+        }
+#endif
+
+        memset(region.pointer, 0, region.size);
+    }
+}
+
+void GuestMemory::LoadBIOS(const char* path) {
+    if (bios_path == path) {
+        return;
+    }
+
+#if defined(__linux__)
+    if (bios_fd >= 0) {
+        // put the arena back underneath where the old bios was mapped
+        if (fd >= 0) {
+            mmap(bios, BIOS_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, BIOS_OFFSET);
+        } else {
+            mmap(bios, BIOS_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        }
+
+        close(bios_fd);
+        bios_fd = -1;
+    } else {
+        mprotect(bios, BIOS_SIZE, PROT_READ | PROT_WRITE);
+    }
+
+    int file = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (file < 0) {
+        log_fatal("bios does not exist!");
+    }
+
+    struct stat info;
+
+    // a bios that's too small can't be mapped, since accessing past the end of the file would fault
+    if (fstat(file, &info) == 0 && info.st_size >= BIOS_SIZE &&
+        mmap(bios, BIOS_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED, file, 0) != MAP_FAILED) {
+        bios_fd = file;
+    } else {
+        close(file);
+        ReadBIOS(path);
+        mprotect(bios, BIOS_SIZE, PROT_READ);
+    }
+#else
+    ReadBIOS(path);
+#endif
+
+    bios_path = path;
+}
+
+bool GuestMemory::GetBacking(u8* pointer, int& file, u32& offset) {
+    if (pointer < base || pointer >= base + ARENA_SIZE) {
+        return false;
+    }
+
+    u32 arena_offset = pointer - base;
+
+    if (bios_fd >= 0 && (arena_offset - BIOS_OFFSET) < BIOS_SIZE) {
+        file = bios_fd;
+        offset = arena_offset - BIOS_OFFSET;
+        return true;
+    }
+
+    if (fd < 0) {
+        return false;
+    }
+
+    file = fd;
+    offset = arena_offset;
+    return true;
+}
+
+void GuestMemory::Free() {
+#if defined(__linux__)
+    if (base) {
+        munmap(base, ARENA_SIZE);
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    if (bios_fd >= 0) {
+        close(bios_fd);
+    }
+#else
+    delete[] base;
+#endif
+
+    base = nullptr;
+    fd = -1;
+    bios_fd = -1;
+    bios_path.clear();
+}
+
+void GuestMemory::ReadBIOS(const char* path) {
+    std::ifstream file(path, std::fstream::in | std::fstream::binary);
+
+    if (!file) {
+        log_fatal("bios does not exist!");
+    }
+
+    memset(bios, 0, BIOS_SIZE);
+    file.unsetf(std::ios::skipws);
+    file.read(reinterpret_cast<char*>(bios), BIOS_SIZE);
+    file.close();
+}
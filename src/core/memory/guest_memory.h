@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include "common/types.h"
+
+// all of the guest's memory lives in a single arena, which is allocated once and
+// then reused across resets. on linux the arena is backed by a shared memory file,
+// which lets fastmem map the same pages into its window, and resets hand the pages
+// back to the kernel rather than clearing them by hand.
+// the bios is mapped read-only straight from its file, so every instance running
+// the same bios shares a single copy of it
+class GuestMemory {
+public:
+    ~GuestMemory();
+
+    // does nothing if the arena has already been allocated
+    void Allocate();
+
+    // zeroes everything apart from the bios
+    void Clear();
+
+    // does nothing if the bios has already been loaded from path
+    void LoadBIOS(const char* path);
+
+    // whether pages of the arena can be mapped elsewhere with GetBacking
+    bool IsShared() {
+        return fd >= 0;
+    }
+
+    // gives the file and offset in it which back the page that pointer is in.
+    // returns false if the page isn't part of a file
+    bool GetBacking(u8* pointer, int& file, u32& offset);
+
+    u8* rdram = nullptr;
+    u8* iop_ram = nullptr;
+    u8* bios = nullptr;
+    u8* scratchpad = nullptr;
+
+private:
+    void Free();
+    void ReadBIOS(const char* path);
+
+    u8* base = nullptr;
+    int fd = -1;
+
+    // only valid when the bios is mapped from its file
+    int bios_fd = -1;
+    std::string bios_path;
+};
@@ -5,60 +5,16 @@
 
 Memory::Memory(System* system) : system(system) {}
 
-Memory::~Memory() {
-    if (rdram) {
-        delete[] rdram;
-    }
-
-    if (iop_ram) {
-        delete[] iop_ram;
-    }
-
-    if (bios) {
-        delete[] bios;
-    }
-
-    if (scratchpad) {
-        delete[] scratchpad;
-    }
-}
-
 void Memory::Reset() {
-    ee_table.fill(nullptr);
-    iop_table.fill(nullptr);
+    ee_code_pages.reset();
+    iop_code_pages.reset();
+    pending_iop_code_pages.reset();
+    iop_code_writes_pending = false;
 
     InitialiseMemory();
     LoadBIOS();
-    RegisterRegion(0x00000000, 0x02000000, 0x1FFFFFF, rdram, RegionType::EE);
-    RegisterRegion(0x1C000000, 0x1C200000, 0x1FFFFF, iop_ram, RegionType::EE);
-    RegisterRegion(0x1FC00000, 0x20000000, 0x3FFFFF, bios, RegionType::EE);
-    RegisterRegion(0x70000000, 0x70004000, 0x3FFF, scratchpad, RegionType::EE);
-    RegisterRegion(0x1FC00000, 0x20000000, 0x3FFFFF, bios, RegionType::IOP);
-    RegisterRegion(0x0000000, 0x200000, 0x1FFFFF, iop_ram, RegionType::IOP);
-
-    ee_map.RegisterReadMemory(0x00000000, 0x02000000, rdram);
-    ee_map.RegisterWriteMemory(0x00000000, 0x02000000, rdram);
-
-    ee_map.RegisterReadHandler(0x10000000, 0x10010000, [this](u32 addr) {
-        return EEReadIO(addr);
-    });
-
-    ee_map.RegisterReadHandler(0x12000000, 0x12002000, [this](u32 addr) {
-        return EEReadIO(addr);
-    });
-
-    ee_map.RegisterWriteHandler(0x10000000, 0x10010000, [this](u32 addr, u32 data) {
-        EEWriteIO(addr, data);
-    });
-
-    ee_map.RegisterWriteHandler(0x12000000, 0x12002000, [this](u32 addr, u32 data) {
-        EEWriteIO(addr, data);
-    });
+    RegisterMemoryMaps();
 
-    ee_map.RegisterReadMemory(0x1FC00000, 0x20000000, bios);
-    ee_map.RegisterReadMemory(0x70000000, 0x70004000, scratchpad);
-    ee_map.RegisterWriteMemory(0x70000000, 0x70004000, scratchpad);
-    
     mch_drd = 0;
     rdram_sdevid = 0;
     mch_ricm = 0;
@@ -84,466 +40,579 @@ bool Memory::ValidIOPCodeRegion(VAddr vaddr) {
 }
 
 void Memory::InitialiseMemory() {
-    rdram = new u8[0x2000000];
-    iop_ram = new u8[0x200000];
-    bios = new u8[0x400000];
-    scratchpad = new u8[0x4000];
-}
-
-void Memory::LoadBIOS() {
-    std::ifstream file("../bios/bios.bin", std::fstream::in | std::fstream::binary);
+    // the arena is only allocated the first time, after that it just gets cleared
+    guest_memory.Allocate();
+    guest_memory.Clear();
+
+    rdram = guest_memory.rdram;
+    iop_ram = guest_memory.iop_ram;
+    bios = guest_memory.bios;
+    scratchpad = guest_memory.scratchpad;
+
+    if (use_fastmem && !fastmem.IsEnabled()) {
+        auto slow_read = [this](u32 vaddr, int size) -> u64 {
+            u32 paddr = TranslateVirtualAddress(vaddr);
+
+            switch (size) {
+            case 1:
+                return ee_map.Read<u8>(paddr);
+            case 2:
+                return ee_map.Read<u16>(paddr);
+            case 4:
+                return ee_map.Read<u32>(paddr);
+            default:
+                return ee_map.Read<u64>(paddr);
+            }
+        };
+
+        auto slow_write = [this](u32 vaddr, u64 data, int size) {
+            u32 paddr = TranslateVirtualAddress(vaddr);
+
+            switch (size) {
+            case 1:
+                ee_map.Write<u8>(paddr, data);
+                break;
+            case 2:
+                ee_map.Write<u16>(paddr, data);
+                break;
+            case 4:
+                ee_map.Write<u32>(paddr, data);
+                break;
+            default:
+                ee_map.Write<u64>(paddr, data);
+                break;
+            }
+        };
 
-    if (!file) {
-        log_fatal("bios does not exist!");
+        if (!fastmem.Initialise(guest_memory, slow_read, slow_write)) {
+            log_warn("[Memory] fastmem isn't supported, falling back to the memory map");
+            use_fastmem = false;
+        }
+    } else if (!use_fastmem && fastmem.IsEnabled()) {
+        fastmem.Shutdown();
     }
+}
 
-    file.unsetf(std::ios::skipws);
-    file.read(reinterpret_cast<char*>(bios), 0x400000);
-    file.close();
-
+void Memory::LoadBIOS() {
+    guest_memory.LoadBIOS(bios_path.c_str());
     log_debug("[Memory] Bios was successfully loaded!");
 }
 
 u32 Memory::TranslateVirtualAddress(VAddr vaddr) {
-    if (in_range(0x70000000, 0x70004000, vaddr)) {
-        // scratchpad is only accessible by virtual addressing
-        return vaddr;
-    } else if (in_range(0x30100000, 0x32000000, vaddr)) {
-        return vaddr & 0x1FFFFFF;
-    } else {
-        return vaddr & 0x1FFFFFFF;
-    }
+    return system->ee_core.tlb.Translate(vaddr);
 }
 
-void Memory::RegisterRegion(VAddr vaddr_start, VAddr vaddr_end, int mask, u8* region, RegionType region_type) {
-    for (u32 vaddr = vaddr_start; vaddr < vaddr_end; vaddr += 0x1000) {
-        int index = PageIndex(vaddr);
+bool Memory::EEIsIdleAddress(VAddr vaddr) {
+    u32 paddr = TranslateVirtualAddress(vaddr);
 
-        if (region_type == RegionType::EE) {
-            ee_table[index] = &region[vaddr & mask];
-        } else {
-            iop_table[index] = &region[vaddr & mask];
-        }
-    }
+    // INTC_STAT
+    return ee_map.GetReadPage(paddr) || (paddr & ~0x3) == 0x1000F000;
 }
 
-int Memory::PageIndex(VAddr vaddr) {
-    return vaddr >> 12;
+bool Memory::IOPIsIdleAddress(VAddr vaddr) {
+    u32 addr = vaddr & 0x1FFFFFFF;
+
+    // I_STAT
+    return iop_map.GetReadPage(addr) || (addr & ~0x3) == 0x1F801070;
 }
 
-int Memory::PageOffset(VAddr vaddr) {
-    return vaddr & 0xFFF;
+void Memory::SetBIOSPath(std::string path) {
+    bios_path = path;
 }
 
-u8 Memory::EEReadByte(u32 addr) {
-    addr = TranslateVirtualAddress(addr);
+void Memory::SetFastmem(bool enabled) {
+    use_fastmem = enabled;
+}
 
-    return ee_map.ReadByte(addr);
+bool Memory::GetFastmem() {
+    return use_fastmem;
 }
 
-u16 Memory::EEReadHalf(u32 addr) {
-    addr = TranslateVirtualAddress(addr);
+void Memory::UpdateFastmem() {
+    u32 first;
+    u32 last;
 
-    return ee_map.ReadHalf(addr);
+    system->ee_core.tlb.TakeDirtyPages(first, last);
+    fastmem.Update(ee_map, system->ee_core.tlb, first, last);
 }
 
-u32 Memory::EEReadWord(u32 addr) {
-    addr = TranslateVirtualAddress(addr);
+void Memory::RegisterMemoryMaps() {
+    ee_map.Reset();
+    ee_map.RegisterReadMemory(0x00000000, 0x02000000, rdram);
+    ee_map.RegisterWriteMemory(0x00000000, 0x02000000, rdram);
+    ee_map.RegisterReadMemory(0x1C000000, 0x1C200000, iop_ram);
+    ee_map.RegisterWriteMemory(0x1C000000, 0x1C200000, iop_ram);
+    ee_map.RegisterReadMemory(0x1FC00000, 0x20000000, bios);
+    ee_map.RegisterReadMemory(0x70000000, 0x70004000, scratchpad);
+    ee_map.RegisterWriteMemory(0x70000000, 0x70004000, scratchpad);
 
-    return ee_map.ReadWord(addr);
-}
+    // accesses to io that don't hit a register end up here
+    ee_map.RegisterReadHandler(0x10000000, 0x10010000, [](u32 addr, int size) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] undefined ee read %08x\n", addr);
+        return 0;
+    });
+
+    ee_map.RegisterReadHandler(0x12000000, 0x12002000, [](u32 addr, int size) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] undefined ee read %08x\n", addr);
+        return 0;
+    });
 
-u64 Memory::EEReadDouble(u32 addr) {
-    addr = TranslateVirtualAddress(addr);
-    u64 data = 0;
+    ee_map.RegisterWriteHandler(0x10000000, 0x10010000, [](u32 addr, u32 data, int size) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] undefined ee write %08x = %08x\n", addr, data);
+    });
 
-    data |= ee_map.ReadWord(addr);
-    data |= static_cast<u64>(ee_map.ReadWord(addr + 4)) << 32;
+    ee_map.RegisterWriteHandler(0x12000000, 0x12002000, [](u32 addr, u32 data, int size) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] undefined ee write %08x = %08x\n", addr, data);
+    });
 
-    return data;
-}
+    RegisterEEIO();
 
-void Memory::EEWriteByte(u32 addr, u8 data) {
-    addr = TranslateVirtualAddress(addr);
+    // anything on the iop that isn't ram or the bios goes through io.
+    // the bios is only mapped for reads so writes to the cache control
+    // registers at the end of it don't end up modifying it
+    iop_map.Reset();
+    iop_map.RegisterReadMemory(0x00000000, 0x00200000, iop_ram);
+    iop_map.RegisterWriteMemory(0x00000000, 0x00200000, iop_ram);
+    iop_map.RegisterReadMemory(0x1FC00000, 0x20000000, bios);
 
-    ee_map.WriteByte(addr, data);
-}
+    iop_map.RegisterReadHandler(0x00000000, 0x20000000, [](u32 addr, int size) {
+        if (size == 4 && (addr >> 24) == 0x1E) {
+            // what is this
+            return 0;
+        }
 
-void Memory::EEWriteHalf(u32 addr, u16 data) {
-    addr = TranslateVirtualAddress(addr);
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] handle iop %d-bit read %08x\n", size * 8, addr);
+        return 0;
+    });
 
-    ee_map.WriteHalf(addr, data);
-}
+    iop_map.RegisterWriteHandler(0x00000000, 0x20000000, [](u32 addr, u32 data, int size) {
+        log_channel(LogChannel::Memory, LogLevel::Debug, "[Memory] handle iop %d-bit write %08x = %08x\n", size * 8, addr, data);
+    });
 
-void Memory::EEWriteWord(u32 addr, u32 data) {
-    addr = TranslateVirtualAddress(addr);
+    RegisterIOPIO();
 
-    ee_map.WriteWord(addr, data);
+    // the whole window gets rebuilt here, so there's no need to keep what the tlb has changed
+    u32 first;
+    u32 last;
+
+    system->ee_core.tlb.TakeDirtyPages(first, last);
+    fastmem.Update(ee_map, system->ee_core.tlb);
 }
 
-u32 Memory::EEReadIO(u32 addr) {
-    if (addr >= EE_TIMERS_REGION_START && addr < EE_TIMERS_REGION_END) {
+void Memory::RegisterEEIO() {
+    // timers
+    ee_map.RegisterIORead(EE_TIMERS_REGION_START, EE_TIMERS_REGION_END, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->timers.ReadRegister(addr);
-    } else if (in_range(0x10008000, 0x1000E000, addr)) {
-        return system->dmac.ReadChannel(addr);
-    }
+    });
+
+    ee_map.RegisterIOWrite(EE_TIMERS_REGION_START, EE_TIMERS_REGION_END, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->timers.WriteRegister(addr, data);
+    });
 
-    switch (addr) {
-    case 0x10002010:
+    // ipu
+    ee_map.RegisterIORead(0x10002010, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->ipu.ReadControl();
-    case 0x10003020:
+    });
+
+    ee_map.RegisterIOWrite(0x10002000, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->ipu.WriteCommand(data);
+    });
+
+    ee_map.RegisterIOWrite(0x10002010, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->ipu.WriteControl(data);
+    });
+
+    // gif
+    ee_map.RegisterIORead(0x10003020, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->gif.ReadStat();
-    case 0x1000E000:
+    });
+
+    ee_map.RegisterIOWrite(0x10003000, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->gif.WriteCTRL(data);
+    });
+
+    // vif0 and vif1
+    ee_map.RegisterIOWrite(0x10003810, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->vif0.WriteFBRST(data);
+    });
+
+    ee_map.RegisterIOWrite(0x10003820, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->vif0.WriteERR(data);
+    });
+
+    ee_map.RegisterIOWrite(0x10003830, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->vif0.WriteMark(data);
+    });
+
+    ee_map.RegisterIOWrite(0x10003C00, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->vif1.WriteStat(data);
+    });
+
+    ee_map.RegisterIOWrite(0x10003C10, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->vif1.WriteFBRST(data);
+    });
+
+    // dmac
+    ee_map.RegisterIORead(0x10008000, 0x1000E000, MemoryMap::IO_ALL, [this](u32 addr) {
+        return system->dmac.ReadChannel(addr);
+    });
+
+    ee_map.RegisterIORead(0x1000E000, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->dmac.ReadControl();
-    case 0x1000E010:
+    });
+
+    ee_map.RegisterIORead(0x1000E010, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->dmac.ReadInterruptStatus();
-    case 0x1000E020:
-        return system->dmac.ReadPriorityControl();
-    case 0x1000E030:
+    });
+
+    ee_map.RegisterIORead(0x1000E020, 0x1000E040, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->dmac.ReadPriorityControl();
-    case 0x1000F000:
+    });
+
+    ee_map.RegisterIORead(0x1000F520, MemoryMap::IO_ALL, [this](u32 addr) {
+        return system->dmac.disabled_status;
+    });
+
+    ee_map.RegisterIOWrite(EE_DMA_REGION1_START, EE_DMA_REGION1_END, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->dmac.WriteRegister(addr, data);
+    });
+
+    ee_map.RegisterIOWrite(EE_DMA_REGION2_START, EE_DMA_REGION2_END, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->dmac.WriteRegister(addr, data);
+    });
+
+    // intc
+    ee_map.RegisterIORead(0x1000F000, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->ee_intc.ReadStat();
-    case 0x1000F010:
+    });
+
+    ee_map.RegisterIORead(0x1000F010, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->ee_intc.ReadMask();
-    case 0x1000F130:
+    });
+
+    ee_map.RegisterIOWrite(0x1000F000, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->ee_intc.WriteStat(data);
+    });
+
+    ee_map.RegisterIOWrite(0x1000F010, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->ee_intc.WriteMask(data);
+    });
+
+    ee_map.RegisterIORead(0x1000F130, MemoryMap::IO_ALL, [](u32 addr) {
         return 0;
-    case 0x1000F200:
+    });
+
+    // kputchar
+    ee_map.RegisterIOWrite(0x1000F180, MemoryMap::IO_ALL, [](u32 addr, u32 data) {
+        log_channel(LogChannel::Console, LogLevel::Info, "%c", data);
+    });
+
+    // sif
+    ee_map.RegisterIORead(0x1000F200, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->sif.ReadMSCOM();
-    case 0x1000F210:
+    });
+
+    ee_map.RegisterIORead(0x1000F210, MemoryMap::IO_ALL, [this](u32 addr) {
         return system->sif.ReadSMCOM();
-    case 0x1000F220:
-        return system->sif.ReadMSFLAG();
-    case 0x1000F230:
-        return system->sif.ReadSMFLAG();
-    case 0x1000F440:
-        if (!((mch_ricm >> 6) & 0xF)) {
-            switch ((mch_ricm >> 16) & 0xFFF) {
-            case 0x21:
-                if (rdram_sdevid < 2) {
-                    rdram_sdevid++;
-                    return 0x1F;
-                }
-                return 0;
-            case 0x23:
-                return 0x0D0D;
-            case 0x24:
-                return 0x0090;
-            case 0x40:
-                return mch_ricm & 0x1F;
-            }
-        }
+    });
 
-        break;
-    case 0x1000F520:
-        return system->dmac.disabled_status;
-    default:
-        LogFile::Get().Log("[Memory] undefined ee read %08x\n", addr);
-    }
-    
-    return 0;
-}
+    ee_map.RegisterIORead(0x1000F220, MemoryMap::IO_ALL, [this](u32 addr) {
+        return system->sif.ReadMSFLAG();
+    });
 
-void Memory::EEWriteIO(u32 addr, u32 data) {
-    if (addr >= EE_TIMERS_REGION_START && addr < EE_TIMERS_REGION_END) {
-        system->timers.WriteRegister(addr, data);
-        return;
-    } if (addr >= GS_PRIVILEGED_REGION_START && addr < GS_PRIVILEGED_REGION_END) {
-        system->gs.WriteRegisterPrivileged(addr, data);
-        return;
-    } else if ((addr >= EE_DMA_REGION1_START && addr < EE_DMA_REGION1_END) ||
-        (addr >= EE_DMA_REGION2_START && addr < EE_DMA_REGION2_END)) {
-        system->dmac.WriteRegister(addr, data);
-        return;
-    } 
+    ee_map.RegisterIORead(0x1000F230, MemoryMap::IO_ALL, [this](u32 addr) {
+        return system->sif.ReadSMFLAG();
+    });
 
-    switch (addr) {
-    case 0x10002000:
-        system->ipu.WriteCommand(data);
-        break;
-    case 0x10002010:
-        system->ipu.WriteControl(data);
-        break;
-    case 0x10003000:
-        system->gif.WriteCTRL(data);
-        break;
-    case 0x10003810:
-        system->vif0.WriteFBRST(data);
-        break;
-    case 0x10003820:
-        system->vif0.WriteERR(data);
-        break;
-    case 0x10003830:
-        system->vif0.WriteMark(data);
-        break;
-    case 0x10003C00:
-        system->vif1.WriteStat(data);
-        break;
-    case 0x10003C10:
-        system->vif1.WriteFBRST(data);
-        break;
-    case 0x1000F000:
-        system->ee_intc.WriteStat(data);
-        break;
-    case 0x1000F010:
-        system->ee_intc.WriteMask(data);
-        break;
-    case 0x1000F180:
-        // kputchar
-        LogFile::Get().Log("%c", data);
-        break;
-    case 0x1000F200:
+    ee_map.RegisterIOWrite(0x1000F200, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         system->sif.WriteMSCOM(data);
-        break;
-    case 0x1000F220:
+    });
+
+    ee_map.RegisterIOWrite(0x1000F220, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         system->sif.SetMSFLAG(data);
-        break;
-    case 0x1000F230:
+    });
+
+    ee_map.RegisterIOWrite(0x1000F230, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         system->sif.SetSMFLAG(data);
-        break;
-    case 0x1000F240:
+    });
+
+    ee_map.RegisterIOWrite(0x1000F240, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         system->sif.WriteEEControl(data);
-        break;
-    case 0x1000F260:
+    });
+
+    ee_map.RegisterIOWrite(0x1000F260, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         system->sif.WriteBD6(data);
-        break;
-    case 0x1000F430:
-        if ((((data >> 16) & 0xFFF) == 0x21) && (((data >> 6) & 0xF) == 1) && (((mch_drd >> 7) & 1) == 0)) {
-            rdram_sdevid = 0;
-        }
-                
-        mch_ricm = data & ~0x80000000;
-        break;
-    case 0x1000F440:
+    });
+
+    // mch
+    ee_map.RegisterIORead(0x1000F440, MemoryMap::IO_ALL, [this](u32 addr) {
+        return ReadMCHDRD();
+    });
+
+    ee_map.RegisterIOWrite(0x1000F430, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        WriteMCHRICM(data);
+    });
+
+    ee_map.RegisterIOWrite(0x1000F440, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
         mch_drd = data;
-        break;
-    default:
-        LogFile::Get().Log("[Memory] undefined ee write %08x = %08x\n", addr, data);
-    }
-}
+    });
 
-void Memory::EEWriteDouble(u32 addr, u64 data) {
-    addr = TranslateVirtualAddress(addr);
+    // gs
+    ee_map.RegisterIORead(0x12001000, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->gs.ReadRegisterPrivileged(addr);
+    });
 
-    ee_map.WriteWord(addr, data & 0xFFFFFFFF);
-    ee_map.WriteWord(addr + 4, data >> 32);
+    ee_map.RegisterIOWrite(GS_PRIVILEGED_REGION_START, GS_PRIVILEGED_REGION_END, MemoryMap::IO_ALL, [this](u32 addr, u32 data) {
+        system->gs.WriteRegisterPrivileged(addr, data);
+    });
 }
 
-void Memory::EEWriteQuad(u32 addr, u128 data) {
-    addr = TranslateVirtualAddress(addr);
+// unlike the ee, iop registers are only handled for the widths they're accessed with
+void Memory::RegisterIOPIO() {
+    // dmac
+    auto dmac_read = [this](u32 addr) {
+        return system->iop_dmac.ReadRegister(addr);
+    };
 
-    for (int i = 0; i < 4; i++) {
-        ee_map.WriteWord(addr + 4 * i, data.uw[i]);
-    }
-}
+    auto dmac_write = [this](u32 addr, u32 data) {
+        system->iop_dmac.WriteRegister(addr, data);
+    };
 
-template u8 Memory::IOPRead(VAddr vaddr);
-template u16 Memory::IOPRead(VAddr vaddr);
-template u32 Memory::IOPRead(VAddr vaddr);
-template <typename T>
-T Memory::IOPRead(VAddr vaddr) {
-    T return_value = 0;
-    u32 addr = vaddr & 0x1FFFFFFF;
-    u8* page = iop_table[PageIndex(addr)];
+    iop_map.RegisterIORead(IOP_DMA_REGION1_START, IOP_DMA_REGION1_END, MemoryMap::IO_WORD, dmac_read);
+    iop_map.RegisterIORead(IOP_DMA_REGION2_START, IOP_DMA_REGION2_END, MemoryMap::IO_WORD, dmac_read);
+    iop_map.RegisterIORead(IOP_DMA_REGION3_START, IOP_DMA_REGION3_END, MemoryMap::IO_WORD, dmac_read);
+    iop_map.RegisterIOWrite(IOP_DMA_REGION1_START, IOP_DMA_REGION1_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, dmac_write);
+    iop_map.RegisterIOWrite(IOP_DMA_REGION2_START, IOP_DMA_REGION2_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, dmac_write);
+    iop_map.RegisterIOWrite(IOP_DMA_REGION3_START, IOP_DMA_REGION3_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, dmac_write);
 
-    if (page) {
-        memcpy(&return_value, page + PageOffset(addr), sizeof(T));
-    } else {
-        if constexpr (sizeof(T) == 1) {
-            return IOPReadByte(addr);
-        } else if constexpr (sizeof(T) == 2) {
-            return IOPReadHalf(addr);
-        } else {
-            return IOPReadWord(addr);
-        }
-    }
+    // timers
+    auto timers_read = [this](u32 addr) {
+        return system->iop_timers.ReadRegister(addr);
+    };
 
-    return return_value;
-}
+    auto timers_write = [this](u32 addr, u32 data) {
+        system->iop_timers.WriteRegister(addr, data);
+    };
 
-u8 Memory::IOPReadByte(u32 addr) {
-    switch (addr) {
-    case 0x1F402005:
-        // cdvd n command status
+    iop_map.RegisterIORead(IOP_TIMERS_REGION1_START, IOP_TIMERS_REGION1_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, timers_read);
+    iop_map.RegisterIORead(IOP_TIMERS_REGION2_START, IOP_TIMERS_REGION2_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, timers_read);
+    iop_map.RegisterIOWrite(IOP_TIMERS_REGION1_START, IOP_TIMERS_REGION1_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, timers_write);
+    iop_map.RegisterIOWrite(IOP_TIMERS_REGION2_START, IOP_TIMERS_REGION2_END, MemoryMap::IO_HALF | MemoryMap::IO_WORD, timers_write);
+
+    // spu2 gets registered first, since the second spu region overlaps it
+    iop_map.RegisterIORead(SPU2_REGION_START, SPU2_REGION_END, MemoryMap::IO_HALF, [this](u32 addr) {
+        return system->spu2.ReadRegister(addr);
+    });
+
+    iop_map.RegisterIOWrite(SPU2_REGION_START, SPU2_REGION_END, MemoryMap::IO_HALF, [this](u32 addr, u32 data) {
+        system->spu2.WriteRegister(addr, data);
+    });
+
+    // spu
+    auto spu_write = [this](u32 addr, u32 data) {
+        system->spu.WriteRegister(addr, data);
+    };
+
+    iop_map.RegisterIORead(SPU_REGION1_START, SPU_REGION1_END, MemoryMap::IO_HALF, [](u32 addr) {
+        return 0;
+    });
+
+    iop_map.RegisterIORead(SPU_REGION2_START, SPU_REGION2_END, MemoryMap::IO_HALF, [](u32 addr) {
         return 0;
-    default:
-        LogFile::Get().Log("[Memory] handle iop byte read %08x\n", addr);
+    });
+
+    iop_map.RegisterIOWrite(SPU_REGION1_START, SPU_REGION1_END, MemoryMap::IO_HALF, spu_write);
+    iop_map.RegisterIOWrite(SPU_REGION2_START, SPU_REGION2_END, MemoryMap::IO_HALF, spu_write);
+
+    // sif
+    iop_map.RegisterIORead(0x1D000010, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->sif.ReadSMCOM();
+    });
+
+    iop_map.RegisterIORead(0x1D000020, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->sif.ReadMSFLAG();
+    });
+
+    iop_map.RegisterIORead(0x1D000030, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->sif.ReadSMFLAG();
+    });
+
+    iop_map.RegisterIORead(0x1D000040, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->sif.ReadControl();
+    });
+
+    iop_map.RegisterIORead(0x1D000060, MemoryMap::IO_WORD, [this](u32 addr) {
+        return system->sif.ReadBD6();
+    });
+
+    iop_map.RegisterIOWrite(0x1D000010, MemoryMap::IO_WORD, [this](u32 addr, u32 data) {
+        system->sif.WriteSMCOM(data);
+    });
+
+    iop_map.RegisterIOWrite(0x1D000020, MemoryMap::IO_WORD, [this](u32 addr, u32 data) {
+        system->sif.ResetMSFLAG(data);
+    });
+
+    iop_map.RegisterIOWrite(0x1D000030, MemoryMap::IO_WORD, [this](u32 addr, u32 data) {
+        system->sif.SetSMFLAG(data);
+    });
+
+    iop_map.RegisterIOWrite(0x1D000040, MemoryMap::IO_WORD, [this](u32 addr, u32 data) {
+        system->sif.WriteIOPControl(data);
+    });
+
+    // intc
+    for (int i = 0; i < 3; i++) {
+        iop_map.RegisterIORead(0x1F801070 + (i * 4), MemoryMap::IO_WORD, [this, i](u32 addr) {
+            return system->iop_core->interrupt_controller.ReadRegister(i * 4);
+        });
+
+        iop_map.RegisterIOWrite(0x1F801070 + (i * 4), MemoryMap::IO_WORD, [this, i](u32 addr, u32 data) {
+            system->iop_core->interrupt_controller.WriteRegister(i * 4, data);
+        });
     }
 
-    return 0;
-}
+    // TODO: figure out what these are. for now reads give the same as reading i_stat
+    for (u32 reg : {0x1F80100C, 0x1F801010, 0x1F801400, 0x1F801450}) {
+        iop_map.RegisterIORead(reg, MemoryMap::IO_WORD, [this](u32 addr) {
+            return system->iop_core->interrupt_controller.ReadRegister(0);
+        });
+    }
 
-u16 Memory::IOPReadHalf(u32 addr) {
-    if ((addr >= IOP_TIMERS_REGION1_START && addr < IOP_TIMERS_REGION1_END) ||
-        (addr >= IOP_TIMERS_REGION2_START && addr < IOP_TIMERS_REGION2_END)) {
-        return system->iop_timers.ReadRegister(addr);
-    } else if ((addr >= SPU_REGION1_START && addr < SPU_REGION1_END) ||
-        (addr >= SPU_REGION2_START && addr < SPU_REGION2_END)) {
+    // undocumented
+    auto ignore_write = [](u32 addr, u32 data) {};
+
+    for (u32 reg : {0x1F801004, 0x1F80100C, 0x1F801010, 0x1F801014, 0x1F801018, 0x1F80101C, 0x1F801020, 0x1F802070, 0x1F801060, 0x1F801450, 0x1F801560, 0x1F801564, 0x1F801568, 0x1F8015F0}) {
+        iop_map.RegisterIOWrite(reg, MemoryMap::IO_WORD, ignore_write);
+    }
+
+    iop_map.RegisterIOWrite(0x1F801400, 0x1F801424, MemoryMap::IO_WORD, ignore_write);
+    iop_map.RegisterIOWrite(0x1F802070, MemoryMap::IO_BYTE, ignore_write);
+
+    // cdvd n command status
+    iop_map.RegisterIORead(0x1F402005, MemoryMap::IO_BYTE, [](u32 addr) {
         return 0;
-    } else if (addr >= SPU2_REGION_START && addr < SPU2_REGION_END) {
-        return system->spu2.ReadRegister(addr);
-    } else {
-        LogFile::Get().Log("[Memory] handle iop half read %08x\n", addr);
+    });
+}
+
+u32 Memory::ReadMCHDRD() {
+    if (!((mch_ricm >> 6) & 0xF)) {
+        switch ((mch_ricm >> 16) & 0xFFF) {
+        case 0x21:
+            if (rdram_sdevid < 2) {
+                rdram_sdevid++;
+                return 0x1F;
+            }
+
+            return 0;
+        case 0x23:
+            return 0x0D0D;
+        case 0x24:
+            return 0x0090;
+        case 0x40:
+            return mch_ricm & 0x1F;
+        }
     }
 
     return 0;
 }
 
-u32 Memory::IOPReadWord(u32 addr) {
-    if ((addr >= IOP_DMA_REGION1_START && addr < IOP_DMA_REGION1_END) ||
-        (addr >= IOP_DMA_REGION2_START && addr < IOP_DMA_REGION2_END) ||
-        (addr >= IOP_DMA_REGION3_START && addr < IOP_DMA_REGION3_END)) {
-        return system->iop_dmac.ReadRegister(addr);
-    } else if ((addr >= IOP_TIMERS_REGION1_START && addr < IOP_TIMERS_REGION1_END) ||
-        (addr >= IOP_TIMERS_REGION2_START && addr < IOP_TIMERS_REGION2_END)) {
-        return system->iop_timers.ReadRegister(addr);
-    } else if ((addr >> 24) == 0x1E) {
-        // what is this
-        return 0;
+void Memory::WriteMCHRICM(u32 data) {
+    if ((((data >> 16) & 0xFFF) == 0x21) && (((data >> 6) & 0xF) == 1) && (((mch_drd >> 7) & 1) == 0)) {
+        rdram_sdevid = 0;
     }
 
-    switch (addr) {
-    case 0x1D000010:
-        return system->sif.ReadSMCOM();
-    case 0x1D000020:
-        return system->sif.ReadMSFLAG();
-    case 0x1D000030:
-        return system->sif.ReadSMFLAG();
-    case 0x1D000040:
-        return system->sif.ReadControl();
-    case 0x1D000060:
-        return system->sif.bd6;
-    case 0x1F80100C:
-    case 0x1F801010:
-    case 0x1F801400:
-    case 0x1F801450:
-    case 0x1F801070:
-        return system->iop_core->interrupt_controller.ReadRegister(0);
-    case 0x1F801074:
-        return system->iop_core->interrupt_controller.ReadRegister(4);
-    case 0x1F801078:
-        return system->iop_core->interrupt_controller.ReadRegister(8);
-    default:
-        LogFile::Get().Log("[Memory] handle iop word read %08x\n", addr);
+    mch_ricm = data & ~0x80000000;
+}
+
+template u8 Memory::EERead(VAddr vaddr);
+template u16 Memory::EERead(VAddr vaddr);
+template u32 Memory::EERead(VAddr vaddr);
+template u64 Memory::EERead(VAddr vaddr);
+template u128 Memory::EERead(VAddr vaddr);
+template <typename T>
+T Memory::EERead(VAddr vaddr) {
+    if (fastmem.IsEnabled()) {
+        return fastmem.Read<T>(vaddr);
     }
 
-    return 0;
+    return ee_map.Read<T>(TranslateVirtualAddress(vaddr));
 }
 
-template void Memory::IOPWrite(VAddr vaddr, u8 data);
-template void Memory::IOPWrite(VAddr vaddr, u16 data);
-template void Memory::IOPWrite(VAddr vaddr, u32 data);
+template void Memory::EEWrite(VAddr vaddr, u8 data);
+template void Memory::EEWrite(VAddr vaddr, u16 data);
+template void Memory::EEWrite(VAddr vaddr, u32 data);
+template void Memory::EEWrite(VAddr vaddr, u64 data);
+template void Memory::EEWrite(VAddr vaddr, u128 data);
 template <typename T>
-void Memory::IOPWrite(VAddr vaddr, T data) {
-    u32 addr = vaddr & 0x1FFFFFFF;
-    u8* page = iop_table[PageIndex(addr)];
+void Memory::EEWrite(VAddr vaddr, T data) {
+    u32 paddr = TranslateVirtualAddress(vaddr);
+    CheckEECodeWrite(paddr);
 
-    if (page) {
-        memcpy(page + PageOffset(addr), &data, sizeof(T));
+    if (fastmem.IsEnabled()) {
+        fastmem.Write<T>(vaddr, data);
     } else {
-        if constexpr (sizeof(T) == 1) {
-            IOPWriteByte(addr, data);
-        } else if constexpr (sizeof(T) == 2) {
-            IOPWriteHalf(addr, data);
-        } else {
-            IOPWriteWord(addr, data);
-        }
+        ee_map.Write<T>(paddr, data);
     }
 }
 
-void Memory::IOPWriteByte(u32 addr, u8 data) {
-    switch (addr) {
-    case 0x1F802070:
-        return;
-    default:
-        LogFile::Get().Log("[Memory] handle iop byte write %08x = %02x\n", addr, data);
-        break;
+void Memory::MarkEECode(u32 paddr) {
+    if (paddr < RDRAM_SIZE) {
+        ee_code_pages[paddr >> 12] = true;
     }
 }
 
-void Memory::IOPWriteHalf(u32 addr, u16 data) {
-    if ((addr >= IOP_DMA_REGION1_START && addr < IOP_DMA_REGION1_END) ||
-        (addr >= IOP_DMA_REGION2_START && addr < IOP_DMA_REGION2_END) ||
-        (addr >= IOP_DMA_REGION3_START && addr < IOP_DMA_REGION3_END)) {
-        system->iop_dmac.WriteRegister(addr, data);
-        return;
-    } else if ((addr >= IOP_TIMERS_REGION1_START && addr < IOP_TIMERS_REGION1_END) ||
-        (addr >= IOP_TIMERS_REGION2_START && addr < IOP_TIMERS_REGION2_END)) {
-        system->iop_timers.WriteRegister(addr, data);
-        return;
-    } else if ((addr >= SPU_REGION1_START && addr < SPU_REGION1_END) ||
-        (addr >= SPU_REGION2_START && addr < SPU_REGION2_END)) {
-        system->spu.WriteRegister(addr, data);
-        return;
-    } else if (addr >= SPU2_REGION_START && addr < SPU2_REGION_END) {
-        system->spu2.WriteRegister(addr, data);
-        return;
-    } else {
-        LogFile::Get().Log("[Memory] handle iop half write %08x = %04x\n", addr, data);
+void Memory::MarkIOPCode(u32 paddr) {
+    if (paddr < IOP_RAM_SIZE) {
+        iop_code_pages[paddr >> 12] = true;
     }
 }
 
-void Memory::IOPWriteWord(u32 addr, u32 data) {
-    if ((addr >= IOP_DMA_REGION1_START && addr < IOP_DMA_REGION1_END) ||
-        (addr >= IOP_DMA_REGION2_START && addr < IOP_DMA_REGION2_END) ||
-        (addr >= IOP_DMA_REGION3_START && addr < IOP_DMA_REGION3_END)) {
-        system->iop_dmac.WriteRegister(addr, data);
-        return;
-    } else if ((addr >= IOP_TIMERS_REGION1_START && addr < IOP_TIMERS_REGION1_END) ||
-        (addr >= IOP_TIMERS_REGION2_START && addr < IOP_TIMERS_REGION2_END)) {
-        system->iop_timers.WriteRegister(addr, data);
+void Memory::InvalidateEECode(u32 paddr) {
+    ee_code_pages[paddr >> 12] = false;
+    system->ee_core.InvalidateCode(paddr);
+}
+
+void Memory::InvalidateIOPCode(u32 paddr) {
+    iop_code_pages[paddr >> 12] = false;
+    system->iop_core->InvalidateCode(paddr);
+}
+
+void Memory::SetDeferIOPCodeWrites(bool defer) {
+    CheckPendingIOPCodeWrites();
+    defer_iop_code_writes = defer;
+}
+
+void Memory::CheckPendingIOPCodeWrites() {
+    if (!iop_code_writes_pending) {
         return;
     }
 
-    switch (addr) {
-    case 0x1D000010:
-        system->sif.WriteSMCOM(data);
-        break;
-    case 0x1D000020:
-        system->sif.ResetMSFLAG(data);
-        break;
-    case 0x1D000030:
-        system->sif.SetSMFLAG(data);
-        break;
-    case 0x1D000040:
-        system->sif.WriteIOPControl(data);
-        break;
-    case 0x1F801004:
-    case 0x1F80100C:
-    case 0x1F801010:
-    case 0x1F801014:
-    case 0x1F801018:
-    case 0x1F80101C:
-    case 0x1F801020:
-    case 0x1F801400:
-    case 0x1F801404:
-    case 0x1F801408:
-    case 0x1F80140C:
-    case 0x1F801410:
-    case 0x1F801414:
-    case 0x1F801418:
-    case 0x1F80141C:
-    case 0x1F801420:
-    case 0x1F802070:
-    case 0x1F801060:
-    case 0x1F801450:
-    case 0x1F801560:
-    case 0x1F801564:
-    case 0x1F801568:
-        // undocumented
-        break;
-    // TODO: clean this
-    case 0x1F801070:
-        system->iop_core->interrupt_controller.WriteRegister(0, data);
-        break;
-    case 0x1F801074:
-        system->iop_core->interrupt_controller.WriteRegister(4, data);
-        break;
-    case 0x1F801078:
-        system->iop_core->interrupt_controller.WriteRegister(8, data);
-        break;
-    case 0x1F8015F0:
-        break;
-    default:
-        LogFile::Get().Log("[Memory] handle iop word write %08x = %08x\n", addr, data);
+    for (u32 page = 0; page < pending_iop_code_pages.size(); page++) {
+        if (pending_iop_code_pages[page]) {
+            CheckIOPCodeWrite(page << 12);
+        }
     }
+
+    pending_iop_code_pages.reset();
+    iop_code_writes_pending = false;
+}
+
+template u8 Memory::IOPRead(VAddr vaddr);
+template u16 Memory::IOPRead(VAddr vaddr);
+template u32 Memory::IOPRead(VAddr vaddr);
+template <typename T>
+T Memory::IOPRead(VAddr vaddr) {
+    return iop_map.Read<T>(vaddr & 0x1FFFFFFF);
+}
+
+template void Memory::IOPWrite(VAddr vaddr, u8 data);
+template void Memory::IOPWrite(VAddr vaddr, u16 data);
+template void Memory::IOPWrite(VAddr vaddr, u32 data);
+template <typename T>
+void Memory::IOPWrite(VAddr vaddr, T data) {
+    u32 addr = vaddr & 0x1FFFFFFF;
+
+    CheckIOPCodeWrite(addr);
+    iop_map.Write<T>(addr, data);
 }
\ No newline at end of file
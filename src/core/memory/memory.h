@@ -5,21 +5,20 @@
 #include "common/memory_helpers.h"
 #include "common/memory_map.h"
 #include "common/int128.h"
+#include "core/memory/memory_constants.h"
+#include "core/memory/fastmem.h"
+#include "core/memory/guest_memory.h"
+#include <bitset>
 #include <memory>
 #include <fstream>
+#include <string>
 #include <string.h>
 
 class System;
 
-enum class RegionType {
-    EE,
-    IOP,
-};
-
 class Memory {
 public:
     Memory(System* system);
-    ~Memory();
 
     void Reset();
     bool InRange(u32 base, u32 size, u32 addr);
@@ -28,37 +27,86 @@ public:
     void InitialiseMemory();
     void LoadBIOS();
     u32 TranslateVirtualAddress(VAddr vaddr);
-    void RegisterRegion(VAddr vaddr_start, VAddr vaddr_end, int mask, u8* region, RegionType region_type);
-    int PageIndex(VAddr vaddr);
-    int PageOffset(VAddr vaddr);
 
-    u8 EEReadByte(u32 addr);
-    u16 EEReadHalf(u32 addr);
-    u32 EEReadWord(u32 addr);
-    u64 EEReadDouble(u32 addr);
+    // whether a load from vaddr can only change while the cpu is idle through something that
+    // wakes it up, which is what lets a loop polling it be treated as idle. this is memory,
+    // which the dmacs wake the cpu on when they write to it, and the interrupt status
+    // registers. any other io, like dma channels, timers and the sif, can change while the
+    // cpus are idle
+    bool EEIsIdleAddress(VAddr vaddr);
+    bool IOPIsIdleAddress(VAddr vaddr);
+
+    void RegisterMemoryMaps();
+
+    // registers a handler for each io register, grouped by device
+    void RegisterEEIO();
+    void RegisterIOPIO();
+
+    // the mch registers are used by the bios to detect rdram
+    u32 ReadMCHDRD();
+    void WriteMCHRICM(u32 data);
 
-    void EEWriteByte(u32 addr, u8 data);
-    void EEWriteHalf(u32 addr, u16 data);
-    void EEWriteWord(u32 addr, u32 data);
-    void EEWriteDouble(u32 addr, u64 data);
-    void EEWriteQuad(u32 addr, u128 data);
+    // the bios is loaded from path when the system is next reset
+    void SetBIOSPath(std::string path);
 
-    u32 EEReadIO(u32 addr);
-    void EEWriteIO(u32 addr, u32 data);
+    // fastmem is only switched on or off when the system is next reset
+    void SetFastmem(bool enabled);
+    bool GetFastmem();
 
+    // updates the pages of the fastmem window that the tlb has changed
+    void UpdateFastmem();
+
+    // these handle everything from u8 up to u128. accesses to memory are a single
+    // translation and copy, and only io gets split into smaller accesses
     template <typename T>
-    T IOPRead(VAddr vaddr);
+    T EERead(VAddr vaddr);
+
+    template <typename T>
+    void EEWrite(VAddr vaddr, T data);
 
-    u8 IOPReadByte(u32 addr);
-    u16 IOPReadHalf(u32 addr);
-    u32 IOPReadWord(u32 addr);
+    template <typename T>
+    T IOPRead(VAddr vaddr);
 
     template <typename T>
     void IOPWrite(VAddr vaddr, T data);
 
-    void IOPWriteByte(u32 addr, u8 data);
-    void IOPWriteHalf(u32 addr, u16 data);
-    void IOPWriteWord(u32 addr, u32 data);
+    // called by the cpu backends when they cache code from a page,
+    // so that writes to that page know to invalidate it
+    void MarkEECode(u32 paddr);
+    void MarkIOPCode(u32 paddr);
+
+    // these take physical addresses as seen by the ee
+    void CheckEECodeWrite(u32 paddr) {
+        if (paddr < RDRAM_SIZE) {
+            if (ee_code_pages[paddr >> 12]) {
+                InvalidateEECode(paddr);
+            }
+        } else if ((paddr - 0x1C000000) < IOP_RAM_SIZE) {
+            // iop ram is mapped at 0x1C000000 for the ee
+            if (defer_iop_code_writes) {
+                pending_iop_code_pages[(paddr - 0x1C000000) >> 12] = true;
+                iop_code_writes_pending = true;
+            } else {
+                CheckIOPCodeWrite(paddr - 0x1C000000);
+            }
+        }
+    }
+
+    void CheckIOPCodeWrite(u32 paddr) {
+        if (paddr < IOP_RAM_SIZE && iop_code_pages[paddr >> 12]) {
+            InvalidateIOPCode(paddr);
+        }
+    }
+
+    void InvalidateEECode(u32 paddr);
+    void InvalidateIOPCode(u32 paddr);
+
+    // when the iop runs on its own thread, the ee can write to iop ram while the iop is marking
+    // and invalidating its code. ee writes then only note which pages they hit, and the iop's
+    // code is invalidated once both threads have stopped at the end of the slice. this can
+    // only be changed while the iop is stopped
+    void SetDeferIOPCodeWrites(bool defer);
+    void CheckPendingIOPCodeWrites();
 
     // 0x00000000 - 0x02000000 32MB RDRAM
     // (first 1MB reserved for the kernel)
@@ -75,8 +123,15 @@ public:
     // only accessible via virtual addressing and is faster
     u8* scratchpad;
 
-    std::array<u8*, 0x100000> ee_table;
-    std::array<u8*, 0x100000> iop_table;
+    // a bit for each 4KB page of ram which has had code cached from it
+    std::bitset<(RDRAM_SIZE >> 12)> ee_code_pages;
+    std::bitset<(IOP_RAM_SIZE >> 12)> iop_code_pages;
+
+    // pages of iop ram that the ee wrote to while the iop was running, which are only
+    // touched by the ee thread
+    std::bitset<(IOP_RAM_SIZE >> 12)> pending_iop_code_pages;
+    bool iop_code_writes_pending = false;
+    bool defer_iop_code_writes = false;
 
     // no clue what this register does
     u32 mch_drd;
@@ -89,5 +144,17 @@ public:
 
     System* system;
 
+    // the ee map takes physical addresses and the iop map takes
+    // addresses with the segment bits masked off
     MemoryMap ee_map;
+    MemoryMap iop_map;
+
+    std::string bios_path = "../bios/bios.bin";
+
+    // owns rdram, iop ram, the bios and scratchpad, which the pointers above point into
+    GuestMemory guest_memory;
+
+    // when enabled ee accesses go through the fastmem window instead of the ee map
+    Fastmem fastmem;
+    bool use_fastmem = false;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@ enum MemoryConstants {
     IOP_RAM_SIZE = 0x200000,
     BIOS_BASE = 0x1FC00000,
     BIOS_SIZE = 0x400000,
+    SCRATCHPAD_SIZE = 0x4000,
     EE_TIMERS_REGION_START = 0x10000000,
     EE_TIMERS_REGION_END = 0x10001840,
     EE_DMA_REGION1_START = 0x10008000,
@@ -1,9 +1,13 @@
+#include <limits>
 #include <core/scheduler.h>
 
 void Scheduler::Reset() {
-    events.clear();
+    slots.clear();
+    free_slots.clear();
+    heap.clear();
 
     current_time = 0;
+    next_order = 0;
 }
 
 void Scheduler::Tick(int cycles) {
@@ -20,67 +24,151 @@ u64 Scheduler::GetCurrentTime() {
 }
 
 u64 Scheduler::GetEventTime() {
-    return events[0].start_time;
-}
-
-int Scheduler::CalculateEventIndex(Event& new_event) {
-    int lower_bound = 0;
-    int upper_bound = events.size() - 1;
-   
-    while (lower_bound <= upper_bound) {
-        int mid = (lower_bound + upper_bound) / 2;
-        
-        if (new_event.start_time > events[mid].start_time) {
-            lower_bound = mid + 1;
-        } else {
-            upper_bound = mid - 1;
-        }
+    if (heap.empty()) {
+        return std::numeric_limits<u64>::max();
     }
 
-    return lower_bound;
+    return slots[heap[0]].start_time;
 }
 
 void Scheduler::RunEvents() {
     // do any scheduler events that are meant to happen at the current moment
-    while (events[0].start_time <= GetCurrentTime() && events.size() > 0) {
-        // do the callback associated with that scheduler event
-        events[0].callback();
-        
-        // remove the event from the priority queue
-        events.erase(events.begin());
+    while (!heap.empty() && slots[heap[0]].start_time <= GetCurrentTime()) {
+        u32 slot = heap[0];
+
+        // the event is removed before its callback runs, since the
+        // callback can add events which might reuse its slot
+        EventKindInfo& info = kinds[slots[slot].kind];
+        u64 payload = slots[slot].payload;
+
+        RemoveAt(0);
+        FreeSlot(slot);
+
+        trace_scope("scheduler", info.name, payload);
+        info.function(info.object, payload);
+    }
+}
+
+EventHandle Scheduler::Add(u64 delay, EventKind kind, u64 payload) {
+    u32 slot;
+
+    if (free_slots.empty()) {
+        slot = slots.size();
+        slots.emplace_back();
+        slots[slot].generation = 1;
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+
+    Event& event = slots[slot];
+    event.start_time = GetCurrentTime() + delay;
+    event.order = next_order++;
+    event.kind = kind;
+    event.payload = payload;
+    event.heap_index = heap.size();
+
+    heap.push_back(slot);
+    SiftUp(event.heap_index);
+
+    return (static_cast<u64>(event.generation) << 32) | slot;
+}
+
+void Scheduler::Cancel(EventHandle handle) {
+    u32 slot = handle & 0xFFFFFFFF;
+    u32 generation = handle >> 32;
+
+    if (slot >= slots.size() || slots[slot].generation != generation) {
+        return;
+    }
+
+    RemoveAt(slots[slot].heap_index);
+    FreeSlot(slot);
+}
+
+void Scheduler::SchedulerDebug() {
+    for (u32 slot : heap) {
+        printf("start time: %ld, kind: %d, payload: %ld\n", slots[slot].start_time, slots[slot].kind, slots[slot].payload);
     }
 }
 
-void Scheduler::Add(u64 delay, std::function<void()> callback) {
-    Event new_event;
-    new_event.callback = callback;
-    new_event.id = NoneEvent;
-    new_event.start_time = GetCurrentTime() + delay;
-    int index = CalculateEventIndex(new_event);
+bool Scheduler::Before(u32 a, u32 b) {
+    Event& first = slots[heap[a]];
+    Event& second = slots[heap[b]];
 
-    events.insert(events.begin() + index, new_event);
+    if (first.start_time != second.start_time) {
+        return first.start_time < second.start_time;
+    }
+
+    return first.order < second.order;
 }
 
-void Scheduler::AddWithId(u64 delay, int id, std::function<void()> callback) {
-    Event new_event;
-    new_event.callback = callback;
-    new_event.id = id;
-    new_event.start_time = GetCurrentTime() + delay;
-    int index = CalculateEventIndex(new_event);
+void Scheduler::SiftUp(u32 index) {
+    while (index > 0) {
+        u32 parent = (index - 1) / 2;
+
+        if (!Before(index, parent)) {
+            break;
+        }
 
-    events.insert(events.begin() + index, new_event);
+        std::swap(heap[index], heap[parent]);
+        slots[heap[index]].heap_index = index;
+        slots[heap[parent]].heap_index = parent;
+        index = parent;
+    }
 }
 
-void Scheduler::Cancel(int id) {
-    for (u64 i = 0; i < events.size(); i++) {
-        if (events[i].id == id) {
-            events.erase(events.begin() + i);
+void Scheduler::SiftDown(u32 index) {
+    while (true) {
+        u32 smallest = index;
+        u32 left = (index * 2) + 1;
+        u32 right = left + 1;
+
+        if (left < heap.size() && Before(left, smallest)) {
+            smallest = left;
         }
+
+        if (right < heap.size() && Before(right, smallest)) {
+            smallest = right;
+        }
+
+        if (smallest == index) {
+            break;
+        }
+
+        std::swap(heap[index], heap[smallest]);
+        slots[heap[index]].heap_index = index;
+        slots[heap[smallest]].heap_index = smallest;
+        index = smallest;
     }
 }
 
-void Scheduler::SchedulerDebug() {
-    for (Event event : events) {
-        printf("start time: %ld, id: %d\n", event.start_time, event.id);
+void Scheduler::RemoveAt(u32 index) {
+    u32 last = heap.size() - 1;
+
+    if (index != last) {
+        heap[index] = heap[last];
+        slots[heap[index]].heap_index = index;
+    }
+
+    heap.pop_back();
+
+    // the event moved into its place could belong either above or below it
+    if (index < heap.size()) {
+        SiftUp(index);
+        SiftDown(slots[heap[index]].heap_index);
     }
+}
+
+void Scheduler::FreeSlot(u32 slot) {
+    Event& event = slots[slot];
+
+    event.generation++;
+
+    // generation 0 would let a slot's handle equal INVALID_EVENT
+    if (event.generation == 0) {
+        event.generation = 1;
+    }
+
+    free_slots.push_back(slot);
 }
\ No newline at end of file
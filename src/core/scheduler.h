@@ -1,37 +1,101 @@
 #pragma once
 
-#include <functional>
+#include <type_traits>
 #include <vector>
 #include <stdio.h>
 #include "common/types.h"
 #include "common/log.h"
+#include "common/tracer.h"
 
-enum EventId {
-    NoneEvent,
-    TimerEvent,
-};
+// identifies a scheduled event so that it can be cancelled later. handles stay
+// valid until their event runs or is cancelled, after which they're ignored
+using EventHandle = u64;
 
-struct Event {
-    u64 start_time;
-    int id;
-    std::function<void()> callback;
-};
+// the kinds of event are a fixed set, so each one is registered once up front
+// with the method to call, and scheduling it only has to queue a time and a payload
+using EventKind = int;
 
+// events are kept in a binary min-heap ordered by when they're due, so the next
+// event can be peeked at straight away and adding or cancelling is O(log n).
+// events due at the same time run in the order they were added.
+// nothing is allocated once the scheduler has seen the most events it'll have pending at once
 class Scheduler {
 public:
+    static constexpr EventHandle INVALID_EVENT = 0;
+
+    // registers an event kind which calls callback on object, where callback is a
+    // method which either takes no arguments or takes the u64 payload of the event.
+    // name is what the event shows up as when tracing, so it has to be a string literal
+    template <auto callback, typename T>
+    EventKind RegisterEvent(T* object, const char* name) {
+        EventKindInfo info;
+        info.object = object;
+        info.name = name;
+        info.function = [](void* object, u64 payload) {
+            if constexpr (std::is_invocable_v<decltype(callback), T*, u64>) {
+                (static_cast<T*>(object)->*callback)(payload);
+            } else {
+                (static_cast<T*>(object)->*callback)();
+            }
+        };
+
+        kinds.push_back(info);
+        return kinds.size() - 1;
+    }
+
+    // clears any pending events, but keeps the registered kinds
     void Reset();
     void Tick(int cycles);
     u64 GetCurrentTime();
+
+    // gives the time of the next event, or the largest possible time if there are none
     u64 GetEventTime();
+
     void ResetCurrentTime();
     void RunEvents();
-    void Add(u64 delay, std::function<void()> callback);
-    void AddWithId(u64 delay, int id, std::function<void()> callback);
-    void Cancel(int id);
-    int CalculateEventIndex(Event& new_event);
+    EventHandle Add(u64 delay, EventKind kind, u64 payload = 0);
+
+    // does nothing if the event has already run or been cancelled
+    void Cancel(EventHandle handle);
+
     void SchedulerDebug();
 
 private:
+    struct EventKindInfo {
+        void* object;
+        void (*function)(void* object, u64 payload);
+        const char* name;
+    };
+
+    struct Event {
+        u64 start_time;
+
+        // breaks ties between events due at the same time
+        u64 order;
+
+        u64 payload;
+        EventKind kind;
+
+        // where the event is in the heap, which is what makes cancelling O(log n)
+        u32 heap_index;
+
+        // bumped every time the slot is freed, so old handles to it stop matching
+        u32 generation;
+    };
+
+    bool Before(u32 a, u32 b);
+    void SiftUp(u32 index);
+    void SiftDown(u32 index);
+    void RemoveAt(u32 index);
+    void FreeSlot(u32 slot);
+
     u64 current_time;
-    std::vector<Event> events;
+    u64 next_order;
+
+    std::vector<EventKindInfo> kinds;
+
+    // events live in slots which get reused, and the heap holds slot indices
+    std::vector<Event> slots;
+    std::vector<u32> free_slots;
+    std::vector<u32> heap;
 };
\ No newline at end of file
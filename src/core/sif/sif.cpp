@@ -8,11 +8,8 @@ void SIF::Reset() {
     smflag = 0;
     smcom = 0;
 
-    std::queue<u32> sif0_empty;
-    std::queue<u32> sif1_empty;
-    
-    sif0_fifo.swap(sif0_empty);
-    sif1_fifo.swap(sif1_empty);
+    sif0_fifo.Reset();
+    sif1_fifo.Reset();
 }
 
 void SIF::WriteEEControl(u32 data) {
@@ -26,17 +23,24 @@ void SIF::WriteEEControl(u32 data) {
 void SIF::WriteIOPControl(u32 data) {
     // not sure how this works tbh. figure out later
     u8 value = data & 0xF0;
+    u32 old_control = control;
+    u32 new_control;
 
-    if (data & 0xA0)
-    {
-        control &= ~0xF000;
-        control |= 0x2000;
-    }
+    // the ee can change control at the same time, so the update is retried until nothing got in between
+    do {
+        new_control = old_control;
+
+        if (data & 0xA0)
+        {
+            new_control &= ~0xF000;
+            new_control |= 0x2000;
+        }
 
-    if (control & value)
-        control &= ~value;
-    else
-        control |= value;
+        if (new_control & value)
+            new_control &= ~value;
+        else
+            new_control |= value;
+    } while (!control.compare_exchange_weak(old_control, new_control));
 }
 
 void SIF::WriteBD6(u32 data) {
@@ -94,34 +98,43 @@ u32 SIF::ReadControl() {
     return control;
 }
 
+u32 SIF::ReadBD6() {
+    return bd6;
+}
+
+// the dmacs check there's space before writing, so overflowing means one of them has gone wrong
 void SIF::WriteSIF0FIFO(u32 data) {
-    sif0_fifo.push(data);
+    if (!sif0_fifo.Push(data)) {
+        log_fatal("[SIF] SIF0 fifo overflow");
+    }
 }
 
 void SIF::WriteSIF1FIFO(u128 data) {
-    for (int i = 0; i < 4; i++) {
-        sif1_fifo.push(data.uw[i]);
+    if (sif1_fifo.PushBulk(data.uw, 4) != 4) {
+        log_fatal("[SIF] SIF1 fifo overflow");
     }
 }
 
 u32 SIF::ReadSIF0FIFO() {
-    u32 data = sif0_fifo.front();
-    sif0_fifo.pop();
-
-    return data;
+    return sif0_fifo.Pop();
 }
 
 u32 SIF::ReadSIF1FIFO() {
-    u32 data = sif1_fifo.front();
-    sif1_fifo.pop();
-
-    return data;
+    return sif1_fifo.Pop();
 }
 
 int SIF::GetSIF0FIFOSize() {
-    return sif0_fifo.size();
+    return sif0_fifo.Size();
 }
 
 int SIF::GetSIF1FIFOSize() {
-    return sif1_fifo.size();
+    return sif1_fifo.Size();
+}
+
+int SIF::GetSIF0FIFOSpace() {
+    return sif0_fifo.Space();
+}
+
+int SIF::GetSIF1FIFOSpace() {
+    return sif1_fifo.Space();
 }
\ No newline at end of file
@@ -1,11 +1,16 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <atomic>
 #include "common/types.h"
 #include "common/log.h"
 #include "common/int128.h"
 #include "common/ring_buffer.h"
 
+// the sif is how the ee and iop talk to each other, so when the iop runs on its own
+// thread this is the only state that both threads touch at the same time.
+// the registers are atomics and each fifo is a ring with a single producer and consumer,
+// so neither side ever has to wait on the other to access them
 class SIF {
 public:
     void Reset();
@@ -25,28 +30,39 @@ public:
     u32 ReadSMFLAG();
     u32 ReadSMCOM();
     u32 ReadControl();
+    u32 ReadBD6();
 
     // no clue what this is for
-    u32 control;
-    u32 bd6;
+    std::atomic<u32> control;
+    std::atomic<u32> bd6;
 
     // only writeable by the ee
-    u32 mscom;
+    std::atomic<u32> mscom;
 
     // only writeable by the iop
-    u32 smcom;
+    std::atomic<u32> smcom;
 
-    u32 msflag;
-    u32 smflag;
+    std::atomic<u32> msflag;
+    std::atomic<u32> smflag;
 
     // TODO: do more research into sif dmas and sif fifo
-    std::queue<u32> sif0_fifo;
-    std::queue<u32> sif1_fifo;
-
+    // sif0 goes from the iop to the ee, and sif1 from the ee to the iop
     u32 ReadSIF0FIFO();
     u32 ReadSIF1FIFO();
     void WriteSIF0FIFO(u32 data);
     void WriteSIF1FIFO(u128 data);
     int GetSIF0FIFOSize();
     int GetSIF1FIFOSize();
+
+    // how many words can be written before the fifo is full
+    int GetSIF0FIFOSpace();
+    int GetSIF1FIFOSpace();
+
+private:
+    // much bigger than the real fifos, so that the dmacs on either
+    // side can get well ahead of each other before one has to stall
+    static constexpr int FIFO_SIZE = 1 << 16;
+
+    RingBuffer<u32, FIFO_SIZE> sif0_fifo;
+    RingBuffer<u32, FIFO_SIZE> sif1_fifo;
 };
\ No newline at end of file
@@ -1,22 +1,72 @@
+#include <algorithm>
 #include <core/system.h>
+#include <core/timing.h>
+#include "common/tracer.h"
 
-System::System() : ee_core(*this), memory(this), iop_dmac(*this), iop_timers(*this), ee_intc(*this), gif(*this), gs(this), timers(*this), dmac(this), elf_loader(*this) {
-    VBlankStartEvent = std::bind(&System::VBlankStart, this);
-    VBlankFinishEvent = std::bind(&System::VBlankFinish, this);
-    InitialiseIOPCore(CoreType::Interpreter);
-}
+namespace {
+
+enum FrameComponent {
+    EEComponent,
+    DMACComponent,
+    IOPComponent,
+    IOPWaitComponent,
+    IOPDMACComponent,
+    SchedulerComponent,
+    IdleSkipComponent,
+    ComponentCount,
+};
+
+const char* component_names[ComponentCount] = {
+    "EE (us)", "DMAC (us)", "IOP (us)", "IOP Wait (us)", "IOP DMAC (us)", "Scheduler (us)", "Idle Skip (us)",
+};
+
+// while tracing, adds up the host time spent in each component over a frame, and records
+// them as counters once it's over. otherwise marking a component is just a branch
+class FrameProfile {
+public:
+    FrameProfile() : enabled(Tracer::IsEnabled()) {
+        if (enabled) {
+            start = Tracer::Now();
+            last = start;
+        }
+    }
+
+    // charges the time since the last mark to component
+    void Mark(FrameComponent component) {
+        if (enabled) {
+            u64 now = Tracer::Now();
+            times[component] += now - last;
+            last = now;
+        }
+    }
+
+    void Finish() {
+        if (!enabled) {
+            return;
+        }
+
+        Tracer::Span("frame", "Frame", start);
+
+        for (int i = 0; i < ComponentCount; i++) {
+            Tracer::Counter(component_names[i], times[i] / 1000.0);
+        }
+    }
+
+private:
+    bool enabled;
+    u64 start = 0;
+    u64 last = 0;
+    u64 times[ComponentCount] = {};
+};
 
-// credit goes to pcsx2
-// NTSC Interlaced Timings
-#define CYCLES_PER_FRAME 4920115 // 4920115.2 EE cycles to be exact FPS of 59.94005994005994hz
-#define VBLANK_START_CYCLES 4489019 // 4489019.391883126 Guess, exactly 23 HBLANK's before the end
-#define HBLANK_CYCLES 18742
-#define GS_VBLANK_DELAY 65622 // CSR FIELD swap/vblank happens ~65622 cycles after the INTC VBLANK_START event
+} // namespace
 
-// clockrates
-#define EE_CLOCK_SPEED 294912000
-#define BUS_CLOCK_SPEED EE_CLOCK_SPEED / 2
-#define IOP_CLOCK_SPEED EE_CLOCK_SPEED / 8
+System::System() : ee_core(*this), memory(this), iop_dmac(*this), iop_timers(*this), ee_intc(*this), gif(*this), gs(this), timers(*this), dmac(this), elf_loader(*this), iop_thread(*this), gs_thread(*this) {
+    vblank_start_event = scheduler.RegisterEvent<&System::VBlankStart>(this, "VBlank Start");
+    vblank_finish_event = scheduler.RegisterEvent<&System::VBlankFinish>(this, "VBlank Finish");
+    InitialiseEECore(CoreType::Interpreter);
+    InitialiseIOPCore(CoreType::Interpreter);
+}
 
 void System::Reset() {
     scheduler.Reset();
@@ -27,6 +77,9 @@ void System::Reset() {
     iop_timers.Reset();
     ee_intc.Reset();
     gif.Reset();
+
+    // the gs thread might still be working through writes from before
+    gs_thread.Sync();
     gs.Reset();
     timers.Reset();
     dmac.Reset();
@@ -40,41 +93,107 @@ void System::Reset() {
     spu2.Reset();
 }
 
+void System::InitialiseEECore(CoreType core_type) {
+    ee_core.SetCoreType(core_type);
+}
+
 void System::InitialiseIOPCore(CoreType core_type) {
     if (core_type == CoreType::Interpreter) {
         iop_core = std::make_unique<IOPInterpreter>(this);
+    } else if (core_type == CoreType::ThreadedInterpreter) {
+        iop_core = std::make_unique<IOPThreadedInterpreter>(this);
     } else {
         log_fatal("[System] Unknown core type");
     }
 }
 
 void System::RunFrame() {
+    UpdateThreads();
+
+    FrameProfile profile;
+
     u64 end_timestamp = scheduler.GetCurrentTime() + CYCLES_PER_FRAME;
-    int cycles = 32;
-    scheduler.Add(VBLANK_START_CYCLES, VBlankStartEvent);
-    scheduler.Add(CYCLES_PER_FRAME, VBlankFinishEvent);
+    scheduler.Add(VBLANK_START_CYCLES, vblank_start_event);
+    scheduler.Add(CYCLES_PER_FRAME, vblank_finish_event);
 
     while (scheduler.GetCurrentTime() < end_timestamp) {
+        int cycles = GetSliceCycles(end_timestamp);
+
+        // iop runs at 1 / 8 speed of the ee. on its own thread it
+        // runs its slice alongside the ee's, and we wait for it at the end
+        if (iop_threaded) {
+            iop_thread.Run(cycles / 8);
+        }
+
         ee_core.Run(cycles);
+        profile.Mark(EEComponent);
         
-        // ee timers and dmac run at half the speed of the ee
-        timers.Run(cycles / 2);
+        // the ee dmac runs at half the speed of the ee
         dmac.Run(cycles / 2);
+        profile.Mark(DMACComponent);
 
-        // iop runs at 1 / 8 speed of the ee
-        iop_core->Run(cycles / 8);
-        iop_dmac.Run(cycles / 8);
-        iop_timers.Run(cycles / 8);
+        if (iop_threaded) {
+            iop_thread.Wait();
+            iop_timers.SchedulePendingInterrupts();
+            memory.CheckPendingIOPCodeWrites();
+            profile.Mark(IOPWaitComponent);
+        } else {
+            iop_core->Run(cycles / 8);
+            profile.Mark(IOPComponent);
+            iop_dmac.Run(cycles / 8);
+            profile.Mark(IOPDMACComponent);
+        }
         
         scheduler.Tick(cycles);
         scheduler.RunEvents();
+        profile.Mark(SchedulerComponent);
+
+        if (ee_core.idle && iop_core->idle) {
+            SkipIdleCycles();
+            profile.Mark(IdleSkipComponent);
+        }
+    }
+
+    profile.Finish();
+}
+
+// nothing that the scheduler knows about can happen before its next event, so the
+// ee can run straight up to it. the slice is still capped at the sync quantum, since
+// the iop and the other components only catch up with the ee once it's finished
+int System::GetSliceCycles(u64 end_timestamp) {
+    u64 horizon = std::min(scheduler.GetEventTime(), end_timestamp);
+    u64 cycles = std::min<u64>(horizon - scheduler.GetCurrentTime(), sync_quantum);
+
+    // keep slices a multiple of 8 so the iop's share doesn't get rounded away
+    return std::max<u64>(cycles & ~0x7, 8);
+}
+
+// when both cpus are stuck in idle loops only an interrupt or a dma write to their ram
+// can get them out, so we can jump ahead to the next scheduler event without running them.
+// the dmacs still need to be stepped as usual, and stop the skip as soon as they wake a cpu
+void System::SkipIdleCycles() {
+    int skipped = 0;
+
+    while (ee_core.idle && iop_core->idle && (scheduler.GetCurrentTime() + 8) <= scheduler.GetEventTime()) {
+        int cycles = GetSliceCycles(scheduler.GetEventTime());
+
+        dmac.Run(cycles / 2);
+        iop_dmac.Run(cycles / 8);
+        scheduler.Tick(cycles);
+        skipped += cycles;
     }
+
+    ee_core.SkipIdleCycles(skipped);
+    iop_core->SkipIdleCycles(skipped / 8);
 }
 
 // implement later
 void System::SingleStep() {}
 
 void System::VBlankStart() {
+    // a sleeping gs thread gets woken for whatever is still queued, so it never falls more than a frame behind
+    gs_thread.Flush();
+
     ee_intc.RequestInterrupt(EEInterruptSource::VBlankStart);
     iop_core->interrupt_controller.RequestInterrupt(IOPInterruptSource::VBlankStart);
 }
@@ -86,4 +205,43 @@ void System::VBlankFinish() {
 
 void System::SetGamePath(std::string path) {
     elf_loader.SetPath(path);
+}
+
+void System::SetBIOSPath(std::string path) {
+    memory.SetBIOSPath(path);
+}
+
+void System::SetSyncQuantum(int cycles) {
+    // has to be at least the smallest slice
+    sync_quantum = std::max(cycles, 8);
+}
+
+void System::SetIOPThread(bool enabled) {
+    iop_threaded = enabled;
+}
+
+void System::SetGSThread(bool enabled) {
+    gs_threaded = enabled;
+}
+
+// threads are started from the thread running the system, so that they share a log
+void System::UpdateThreads() {
+    if (iop_threaded != iop_thread.IsRunning()) {
+        if (iop_threaded) {
+            iop_thread.Start();
+        } else {
+            iop_thread.Stop();
+        }
+
+        iop_timers.SetDeferScheduling(iop_threaded);
+        memory.SetDeferIOPCodeWrites(iop_threaded);
+    }
+
+    if (gs_threaded != gs_thread.IsRunning()) {
+        if (gs_threaded) {
+            gs_thread.Start();
+        } else {
+            gs_thread.Stop();
+        }
+    }
 }
\ No newline at end of file
@@ -15,27 +15,43 @@
 #include <core/sif/sif.h>
 #include <core/iop/cpu_core.h>
 #include <core/iop/interpreter/interpreter.h>
+#include <core/iop/interpreter/threaded_interpreter.h>
 #include "core/iop/dmac.h"
 #include "core/iop/timers.h"
+#include "core/iop/iop_thread.h"
+#include "core/gs/gs_thread.h"
 #include "core/elf_loader.h"
 #include "core/spu/spu.h"
 #include <memory>
 
-enum class CoreType {
-    Interpreter,
-};
-
 class System {
 public:
     System();
 
     void Reset();
+    void InitialiseEECore(CoreType core_type);
     void InitialiseIOPCore(CoreType core_type);
     void RunFrame();
+    void SkipIdleCycles();
     void SingleStep();
     void VBlankStart();
     void VBlankFinish();
     void SetGamePath(std::string path);
+    void SetBIOSPath(std::string path);
+
+    // the most ee cycles that can run before the iop and the other components catch up.
+    // larger values mean less time spent switching between them, but less accurate timing
+    void SetSyncQuantum(int cycles);
+
+    // runs the iop on a second host thread, in parallel with the ee. the two only wait
+    // for each other at the end of each slice, so the sync quantum is also the furthest
+    // apart they can get. takes effect from the next frame, and like the other settings
+    // it shouldn't be changed while a frame is running
+    void SetIOPThread(bool enabled);
+
+    // processes gs register writes on a separate host thread, so the ee only
+    // has to decode giftags. takes effect from the next frame
+    void SetGSThread(bool enabled);
 
     Scheduler scheduler;
 
@@ -61,6 +77,19 @@ public:
     SPU spu;
     SPU spu2;
 
-    std::function<void()> VBlankStartEvent;
-    std::function<void()> VBlankFinishEvent;
+    EventKind vblank_start_event;
+    EventKind vblank_finish_event;
+
+    // declared last so that the threads are stopped before anything they use gets destroyed
+    IOPThread iop_thread;
+    GSThread gs_thread;
+
+private:
+    int GetSliceCycles(u64 end_timestamp);
+
+    void UpdateThreads();
+
+    int sync_quantum = 2048;
+    bool iop_threaded = false;
+    bool gs_threaded = false;
 };
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+// credit goes to pcsx2
+// NTSC Interlaced Timings, in ee cycles
+#define CYCLES_PER_FRAME 4920115 // 4920115.2 EE cycles to be exact FPS of 59.94005994005994hz
+#define VBLANK_START_CYCLES 4489019 // 4489019.391883126 Guess, exactly 23 HBLANK's before the end
+#define HBLANK_CYCLES 18742
+#define GS_VBLANK_DELAY 65622 // CSR FIELD swap/vblank happens ~65622 cycles after the INTC VBLANK_START event
+
+// clockrates
+#define EE_CLOCK_SPEED 294912000
+#define BUS_CLOCK_SPEED EE_CLOCK_SPEED / 2
+#define IOP_CLOCK_SPEED EE_CLOCK_SPEED / 8
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "common/log_file.h"
 #include <core/vif/vif.h>
 
 void VIF::Reset() {
@@ -16,12 +17,12 @@ void VIF::WriteStat(u32 data) {
         log_fatal("handle");
     }
 
-    log_warn("[VIF] write stat %08x", data);
+    log_channel(LogChannel::VIF, LogLevel::Debug, "[VIF] write stat %08x\n", data);
     stat = data;
 }
 
 void VIF::WriteFBRST(u8 data) {
-    log_warn("[VIF] write fbrst %02x", data);
+    log_channel(LogChannel::VIF, LogLevel::Debug, "[VIF] write fbrst %02x\n", data);
     if (data & 0x1) {
         SystemReset();
     }
@@ -30,12 +31,12 @@ void VIF::WriteFBRST(u8 data) {
 }
 
 void VIF::WriteMark(u16 data) {
-    log_warn("[VIF] write mark %04x", data);
+    log_channel(LogChannel::VIF, LogLevel::Debug, "[VIF] write mark %04x\n", data);
     stat &= ~(1 << 6);
     mark = data;
 }
 
 void VIF::WriteERR(u8 data) {
-    log_warn("[VIF] write err %02x", data);
+    log_channel(LogChannel::VIF, LogLevel::Debug, "[VIF] write err %02x\n", data);
     err = data;
 }
\ No newline at end of file
@@ -70,6 +70,20 @@ void EEDebugger::DisassemblyWindow(Core& core) {
         }
     }
 
+    ImGui::PopFont();
+    ImGui::End();
+}
+
+void EEDebugger::IdleLoopsWindow(Core& core) {
+    ImGui::Begin("EE Idle Loops");
+    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[1]);
+
+    for (auto& [pc, stats] : core.system.ee_core.idle_loop_detector.GetStats()) {
+        ImGui::Text("%08x", pc);
+        ImGui::SameLine(90);
+        ImGui::Text("hits: %lu skipped cycles: %lu", stats.hits, stats.skipped_cycles);
+    }
+
     ImGui::PopFont();
     ImGui::End();
 }
\ No newline at end of file
@@ -76,6 +76,20 @@ void IOPDebugger::DisassemblyWindow(Core& core) {
         }
     }
 
+    ImGui::PopFont();
+    ImGui::End();
+}
+
+void IOPDebugger::IdleLoopsWindow(Core& core) {
+    ImGui::Begin("IOP Idle Loops");
+    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[1]);
+
+    for (auto& [pc, stats] : core.system.iop_core->idle_loop_detector.GetStats()) {
+        ImGui::Text("%08x", pc);
+        ImGui::SameLine(90);
+        ImGui::Text("hits: %lu skipped cycles: %lu", stats.hits, stats.skipped_cycles);
+    }
+
     ImGui::PopFont();
     ImGui::End();
 }
\ No newline at end of file
@@ -7,9 +7,11 @@ class IOPDebugger {
 public:
     void RegistersWindow(IOPCore& iop_core);
     void DisassemblyWindow(Core& core);
+    void IdleLoopsWindow(Core& core);
 
     bool show_registers_window = false;
     bool show_disassembly_window = false;
+    bool show_idle_loops_window = false;
     int disassembly_size = 15;
 private:
 };
\ No newline at end of file
@@ -72,6 +72,10 @@ void HostInterface::Run() {
             ee_debugger.DisassemblyWindow(core);
         }
 
+        if (ee_debugger.show_idle_loops_window) {
+            ee_debugger.IdleLoopsWindow(core);
+        }
+
         if (iop_debugger.show_registers_window) {
             iop_debugger.RegistersWindow(*core.system.iop_core);
         }
@@ -80,6 +84,10 @@ void HostInterface::Run() {
             iop_debugger.DisassemblyWindow(core);
         }
 
+        if (iop_debugger.show_idle_loops_window) {
+            iop_debugger.IdleLoopsWindow(core);
+        }
+
         // rendering
         ImGui::Render();
         glViewport(0, 0, 1280, 720);
@@ -107,6 +115,11 @@ void HostInterface::HandleInput() {
         if (event.type == SDL_QUIT) {
             running = false;
         }
+
+        // hold tab to fast forward
+        if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && event.key.keysym.sym == SDLK_TAB && !ImGui::GetIO().WantCaptureKeyboard) {
+            core.SetFastForward(event.type == SDL_KEYDOWN);
+        }
     }
 }
 
@@ -128,6 +141,66 @@ void HostInterface::RenderMenubar() {
                 TogglePause();
             }
 
+            if (ImGui::BeginMenu("FPU Accuracy")) {
+                EECOP1& cop1 = core.system.ee_core.cop1;
+
+                if (ImGui::MenuItem("None", nullptr, cop1.GetAccuracy() == FPUAccuracy::None)) {
+                    cop1.SetAccuracy(FPUAccuracy::None);
+                }
+
+                if (ImGui::MenuItem("Clamp", nullptr, cop1.GetAccuracy() == FPUAccuracy::Clamp)) {
+                    cop1.SetAccuracy(FPUAccuracy::Clamp);
+                }
+
+                if (ImGui::MenuItem("Full", nullptr, cop1.GetAccuracy() == FPUAccuracy::Full)) {
+                    cop1.SetAccuracy(FPUAccuracy::Full);
+                }
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Frame Limiter")) {
+                if (ImGui::MenuItem("Enabled", nullptr, core.GetFramelimiter())) {
+                    core.SetFramelimiter(!core.GetFramelimiter());
+                }
+
+                if (ImGui::MenuItem("Fast Forward", nullptr, core.GetFastForward())) {
+                    core.SetFastForward(!core.GetFastForward());
+                }
+
+                ImGui::Separator();
+
+                if (ImGui::MenuItem("59.94 Hz", nullptr, core.GetTargetRate() == 59.94f)) {
+                    core.SetTargetRate(59.94f);
+                }
+
+                if (ImGui::MenuItem("60 Hz", nullptr, core.GetTargetRate() == 60.0f)) {
+                    core.SetTargetRate(60.0f);
+                }
+
+                if (ImGui::MenuItem("50 Hz", nullptr, core.GetTargetRate() == 50.0f)) {
+                    core.SetTargetRate(50.0f);
+                }
+
+                ImGui::Separator();
+
+                for (float multiplier : {1.0f, 2.0f, 4.0f}) {
+                    char label[16];
+                    snprintf(label, 16, "Turbo x%d", static_cast<int>(multiplier));
+
+                    if (ImGui::MenuItem(label, nullptr, core.GetTurbo() == multiplier)) {
+                        core.SetTurbo(multiplier);
+                    }
+                }
+
+                ImGui::EndMenu();
+            }
+
+            // takes effect on the next reset
+            if (ImGui::MenuItem("Fastmem", nullptr, core.system.memory.GetFastmem())) {
+                core.system.memory.SetFastmem(!core.system.memory.GetFastmem());
+            }
+
             ImGui::EndMenu();
         }
 
@@ -135,12 +208,14 @@ void HostInterface::RenderMenubar() {
             if (ImGui::BeginMenu("EE")) {
                 ImGui::MenuItem("Registers", nullptr, &ee_debugger.show_registers_window);
                 ImGui::MenuItem("Disassembly", nullptr, &ee_debugger.show_disassembly_window);
+                ImGui::MenuItem("Idle Loops", nullptr, &ee_debugger.show_idle_loops_window);
                 ImGui::EndMenu();
             }
 
             if (ImGui::BeginMenu("IOP")) {
                 ImGui::MenuItem("Registers", nullptr, &iop_debugger.show_registers_window);
                 ImGui::MenuItem("Disassembly", nullptr, &iop_debugger.show_disassembly_window);
+                ImGui::MenuItem("Idle Loops", nullptr, &iop_debugger.show_idle_loops_window);
                 ImGui::EndMenu();
             }
 
@@ -188,9 +263,10 @@ void HostInterface::SetupStyle() {
 }
 
 void HostInterface::UpdateTitle(float fps) {
-    char window_title[100];
-    float percent_usage = (fps / 60.0f) * 100;
-    snprintf(window_title, 100, "otterstation | %0.2f FPS | %0.2f%s", fps, percent_usage, "%");
+    char window_title[128];
+    float percent_usage = (fps / core.GetTargetRate()) * 100;
+    FrameStats stats = core.GetFrameStats();
+    snprintf(window_title, 128, "otterstation | %0.2f FPS | %0.2f%s | %0.2f ms (p99 %0.2f ms)", fps, percent_usage, "%", stats.emulation.p50, stats.emulation.p99);
     SDL_SetWindowTitle(window, window_title);
 }
 
@@ -1,7 +1,23 @@
 #include <memory>
+#include <string.h>
+#include <common/log.h>
+#include <common/tracer.h>
 #include "host_interface.h"
 
-int main() {
+int main(int argc, char** argv) {
+    // --trace <path> records a trace for the whole session and writes it out on exit
+    const char* trace_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && (i + 1) < argc) {
+            trace_path = argv[++i];
+        }
+    }
+
+    if (trace_path) {
+        Tracer::Start();
+    }
+
     std::unique_ptr<HostInterface> host_interface = std::make_unique<HostInterface>();
 
     if (host_interface->Initialise()) {
@@ -10,5 +26,16 @@ int main() {
 
     host_interface->Shutdown();
 
+    // the emulator thread has to be stopped before the trace gets written
+    host_interface.reset();
+
+    if (trace_path) {
+        Tracer::Stop();
+
+        if (!Tracer::Dump(trace_path)) {
+            log_warn("[Tracer] couldn't write trace to %s", trace_path);
+        }
+    }
+
     return 0;
 }
\ No newline at end of file